@@ -0,0 +1,356 @@
+#include "AlphaBeta.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Lethal.hpp"
+#include "Playout.hpp"
+
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const float infinity = 1e9f;
+    const float winScore = 1000.0f;
+    const int maxMoves = Hand::capacity * GameState::slotCount + 1; // Every card in every slot, and ending the turn
+
+    bool isPass(const Move& move) {
+        return move.handIndex < 0;
+    }
+}
+
+AlphaBetaSearch::AlphaBetaSearch(const AlphaBetaConfig& config) : config(config), table(config.tableMegabytes) {
+    this->config.deals = std::max(1, this->config.deals);
+    this->config.maxDepth = std::clamp(this->config.maxDepth, 1, maxPly);
+}
+
+bool AlphaBetaSearch::outOfTime() {
+    return Clock::now().time_since_epoch().count() >= this->deadline;
+}
+
+std::uint64_t AlphaBetaSearch::key(const GameState& state, Phase phase) const {
+    std::uint64_t bits = static_cast<std::uint64_t>(phase.opponentToMove) | static_cast<std::uint64_t>(phase.opponentNext) << 1
+        | static_cast<std::uint64_t>(phase.lastSlot + 1) << 2 | static_cast<std::uint64_t>(this->isPlayer) << 5;
+    return state.zobrist(this->first) ^ Zobrist::key(27, bits);
+}
+
+float AlphaBetaSearch::evaluate(const GameState& state) const {
+    int own = state.health(this->isPlayer);
+    int opponent = state.health(!this->isPlayer);
+    if (own <= 0 || opponent <= 0) {
+        return own > 0 ? winScore : opponent > 0 ? -winScore : 0.0f;
+    }
+
+    // Health first, then the cards that survived on the board (they fight again next round)
+    int material = 0;
+    for (int i = 0; i < GameState::slotCount; i++) {
+        const Card& ownCard = state.cards(this->isPlayer)[i];
+        const Card& opponentCard = state.cards(!this->isPlayer)[i];
+        material += ownCard.isBlank() ? 0 : ownCard.currHealth + ownCard.attack;
+        material -= opponentCard.isBlank() ? 0 : opponentCard.currHealth + opponentCard.attack;
+    }
+    return static_cast<float>(own - opponent) + 0.25f * static_cast<float>(material);
+}
+
+float AlphaBetaSearch::resolve(GameState& state) {
+    bool isRunning;
+    if (!applyAssault(state, this->undo, isRunning)) {
+        return evaluate(state); // Not within maxPly plies, but a record that was never pushed must not be popped
+    }
+    float value = evaluate(state);
+    undoAssault(state, this->undo);
+    return value;
+}
+
+int AlphaBetaSearch::orderMoves(const GameState& state, Phase phase, int ply, Move tableMove, Move* moves) {
+    bool side = phase.opponentToMove ? !this->isPlayer : this->isPlayer;
+    bool attacking = side == this->first;
+    const Hand& hand = state.hand(side);
+    const Card* own = state.cards(side);
+    const Card* opposite = state.cards(!side);
+    LegalMoves legal = generateMoves(state, this->first, side);
+
+    int boardAttack = 0;
+    for (int i = 0; i < GameState::slotCount; i++) {
+        boardAttack += own[i].isBlank() ? 0 : own[i].attack;
+    }
+
+    int scores[maxMoves];
+    int count = 0;
+    for (int i = 0; i < legal.handSize; i++) {
+        if (legal.slots[i] == 0) {
+            continue;
+        }
+        const CardType& type = getCardType(hand[i]);
+        for (int slot = phase.lastSlot + 1; slot < GameState::slotCount; slot++) {
+            if (!(legal.slots[i] & (1 << slot))) {
+                continue;
+            }
+            Move move = { static_cast<std::int8_t>(side), static_cast<std::int8_t>(i), static_cast<std::int8_t>(slot) };
+            int score;
+            if (attacking) {
+                // Lethal first, then the most damage, preferably into open lanes
+                score = 4 * type.attack + (opposite[slot].isBlank() ? 2 : 0);
+                if (boardAttack + type.attack >= state.health(!side)) {
+                    score += 1000;
+                }
+            }
+            else {
+                // Block the biggest threats with the sturdiest cards
+                score = 4 * opposite[slot].attack + 2 * type.defense + type.maxHealth;
+            }
+            if (ply < maxPly && move == this->killers[ply][0]) {
+                score += 100000;
+            }
+            else if (ply < maxPly && move == this->killers[ply][1]) {
+                score += 90000;
+            }
+            if (move == tableMove) {
+                score += 1000000;
+            }
+            moves[count] = move;
+            scores[count] = score;
+            count++;
+        }
+    }
+    moves[count] = { static_cast<std::int8_t>(side), -1, -1 }; // Ending the turn is tried last
+    scores[count] = -1;
+    count++;
+
+    // Insertion sort, highest score first. Lists are short
+    for (int i = 1; i < count; i++) {
+        Move move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+    return count;
+}
+
+float AlphaBetaSearch::alphaBeta(GameState& state, Phase phase, int depth, int ply, float alpha, float beta) {
+    this->lastStats.nodes++;
+    if (this->iterationDepth > 1 && (this->lastStats.nodes & 1023) == 0 && outOfTime()) {
+        this->aborted = true;
+    }
+    if (this->aborted) {
+        return 0.0f;
+    }
+
+    // Ending the turn doesn't use up depth: it only moves the round on
+    if (phase.lastSlot == GameState::slotCount - 1) {
+        return endTurn(state, phase, depth, ply, alpha, beta);
+    }
+    if (depth == 0) {
+        this->hitDepthLimit = true;
+        return resolve(state);
+    }
+
+    std::uint64_t key = this->key(state, phase);
+    TTEntry entry;
+    Move tableMove = { -1, -1, -1 };
+    if (this->table.probe(key, entry)) {
+        if (entry.handIndex >= 0) {
+            tableMove = { static_cast<std::int8_t>(phase.opponentToMove ? !this->isPlayer : this->isPlayer), entry.handIndex, entry.slot };
+        }
+        if (entry.depth >= depth) {
+            if (entry.depth != completeDepth) {
+                this->hitDepthLimit = true;
+            }
+            if (entry.bound == TTEntry::EXACT) {
+                this->lastStats.tableHits++;
+                return entry.value;
+            }
+            if (entry.bound == TTEntry::LOWER) {
+                alpha = std::max(alpha, entry.value);
+            }
+            else if (entry.bound == TTEntry::UPPER) {
+                beta = std::min(beta, entry.value);
+            }
+            if (alpha >= beta) {
+                this->lastStats.tableHits++;
+                return entry.value;
+            }
+        }
+    }
+
+    Move moves[maxMoves];
+    int count = orderMoves(state, phase, ply, tableMove, moves);
+
+    // Whether the depth limit cut into this node's own subtree, so its result is only good for this depth
+    bool cutAbove = this->hitDepthLimit;
+    this->hitDepthLimit = false;
+
+    bool maximizing = !phase.opponentToMove;
+    float alphaBefore = alpha;
+    float betaBefore = beta;
+    float best = maximizing ? -infinity : infinity;
+    Move bestMove = { -1, -1, -1 };
+    for (int i = 0; i < count; i++) {
+        const Move& move = moves[i];
+        float value;
+        if (isPass(move)) {
+            value = endTurn(state, phase, depth, ply + 1, alpha, beta);
+        }
+        else {
+            applyMove(state, this->first, move, this->undo);
+            Phase next = phase;
+            next.lastSlot = move.slot;
+            value = alphaBeta(state, next, depth - 1, ply + 1, alpha, beta);
+            undoMove(state, this->undo);
+        }
+        if (this->aborted) {
+            return 0.0f;
+        }
+
+        if (maximizing ? value > best : value < best) {
+            best = value;
+            bestMove = move;
+        }
+        if (maximizing) {
+            alpha = std::max(alpha, best);
+        }
+        else {
+            beta = std::min(beta, best);
+        }
+        if (alpha >= beta) {
+            this->lastStats.cutoffs++;
+            if (i == 0) {
+                this->lastStats.firstMoveCutoffs++;
+            }
+            if (!isPass(move) && ply < maxPly && !(move == this->killers[ply][0])) {
+                this->killers[ply][1] = this->killers[ply][0];
+                this->killers[ply][0] = move;
+            }
+            break;
+        }
+    }
+
+    TTEntry result;
+    result.value = best;
+    result.depth = static_cast<std::int8_t>(this->hitDepthLimit ? depth : completeDepth);
+    result.bound = best <= alphaBefore ? TTEntry::UPPER : best >= betaBefore ? TTEntry::LOWER : TTEntry::EXACT;
+    result.handIndex = isPass(bestMove) ? -1 : bestMove.handIndex;
+    result.slot = isPass(bestMove) ? -1 : bestMove.slot;
+    this->table.store(key, result);
+    this->hitDepthLimit = this->hitDepthLimit || cutAbove;
+    return best;
+}
+
+float AlphaBetaSearch::endTurn(GameState& state, Phase phase, int depth, int ply, float alpha, float beta) {
+    if (!phase.opponentToMove && phase.opponentNext) {
+        Phase answer = { true, false, -1 };
+        return alphaBeta(state, answer, depth, ply, alpha, beta);
+    }
+    return resolve(state);
+}
+
+bool AlphaBetaSearch::searchRoot(std::vector<GameState>& deals, const Move* moves, int moveCount, Phase phase, int depth, float* scores) {
+    this->iterationDepth = depth;
+    std::fill(scores, scores + moveCount, 0.0f);
+    for (GameState& deal : deals) {
+        for (int i = 0; i < moveCount; i++) {
+            // Every root move gets an exact score (full window), so scores can be averaged over the deals
+            float value;
+            if (isPass(moves[i])) {
+                value = endTurn(deal, phase, depth, 1, -infinity, infinity);
+            }
+            else {
+                applyMove(deal, this->first, moves[i], this->undo);
+                Phase next = phase;
+                next.lastSlot = moves[i].slot;
+                value = alphaBeta(deal, next, depth - 1, 1, -infinity, infinity);
+                undoMove(deal, this->undo);
+            }
+            if (this->aborted) {
+                return false;
+            }
+            scores[i] += value / static_cast<float>(deals.size());
+        }
+    }
+    return true;
+}
+
+TurnPlan AlphaBetaSearch::plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) {
+    Clock::time_point startTime = Clock::now();
+    const std::int64_t end = (startTime + std::chrono::milliseconds(this->config.budgetMs)).time_since_epoch().count();
+    this->first = first;
+    this->isPlayer = isPlayer;
+    this->lastStats = PlannerStats();
+    this->lastStats.decisions = 1;
+    for (Move* killer : this->killers) {
+        killer[0] = killer[1] = { -1, -1, -1 };
+    }
+
+    // A proven win needs no search
+    if (isPlayer == first) {
+        LethalCheck lethal = checkLethal(state, first);
+        if (lethal.won) {
+            this->lastStats.lethal = 1;
+            this->lastStats.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+            this->totals.merge(this->lastStats);
+            return lethal.plan;
+        }
+    }
+
+    // The chance nodes: one deal of the hidden cards per branch, fixed for the whole turn
+    Rng rng(seed);
+    std::vector<GameState> deals(this->config.deals, state);
+    for (GameState& deal : deals) {
+        determinize(deal, isPlayer, rng);
+    }
+
+    TurnPlan plan;
+    Phase phase = { false, isPlayer == first, -1 };
+    while (plan.count < GameState::slotCount) {
+        // The root moves are the same in every deal: the side's own cards are known
+        Move moves[maxMoves];
+        int count = orderMoves(deals[0], phase, 0, { -1, -1, -1 }, moves);
+        if (count == 1) {
+            break; // Only ending the turn is left
+        }
+
+        // Iterative deepening. Each placement gets half of the time that is left
+        std::int64_t now = Clock::now().time_since_epoch().count();
+        this->deadline = now + std::max<std::int64_t>(0, end - now) / 2;
+        this->aborted = false;
+        float scores[maxMoves];
+        float completed[maxMoves];
+        for (int depth = 1; depth <= this->config.maxDepth; depth++) {
+            this->hitDepthLimit = false;
+            if (!searchRoot(deals, moves, count, phase, depth, scores)) {
+                break;
+            }
+            std::copy(scores, scores + count, completed);
+            this->lastStats.depth = std::max<long long>(this->lastStats.depth, depth);
+            if (!this->hitDepthLimit) {
+                break; // The whole round was searched, deeper iterations would give the same scores
+            }
+        }
+
+        int best = 0;
+        for (int i = 1; i < count; i++) {
+            if (completed[i] > completed[best]) {
+                best = i;
+            }
+        }
+        if (isPass(moves[best])) {
+            break;
+        }
+        plan.moves[plan.count++] = moves[best];
+        for (GameState& deal : deals) {
+            applyMove(deal, first, moves[best], this->undo);
+        }
+        this->undo.clear();
+        phase.lastSlot = moves[best].slot;
+    }
+
+    this->lastStats.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    this->totals.merge(this->lastStats);
+    return plan;
+}
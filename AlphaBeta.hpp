@@ -0,0 +1,77 @@
+/*
+AlphaBeta.hpp defines the determinized expectimax searcher. It looks at one full round exactly: the placements of both sides, then the
+deterministic Assault phase, and averages over a few sampled deals of the cards the deciding side can't see.
+It is the exhaustive counterpart of MonteCarloSearch, and reports its work in PlannerStats so both can be compared per decision.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Game.hpp"
+#include "Moves.hpp"
+#include "Planner.hpp"
+#include "TranspositionTable.hpp"
+
+typedef struct AlphaBetaConfig {
+    int budgetMs = 50; // Wall-clock time for the whole turn. The first iteration (depth 1) is always completed
+    int deals = 8; // Deals of the hidden cards averaged per decision (the chance nodes of the expectimax)
+    int maxDepth = 12; // Placements looked ahead, both sides together. A round never has more than 2 * GameState::slotCount
+    int tableMegabytes = 16;
+} AlphaBetaConfig;
+
+/**
+ * @brief AlphaBetaSearch plans a turn one placement at a time. For each placement it scores every legal move (and ending the turn) in each
+ * sampled deal with a minimax search of the rest of the round, averages the scores over the deals and plays the best move.
+ * The minimax is an alpha-beta search with iterative deepening, a transposition table, killer moves and static move ordering
+ * (lethal, then high-damage placements first). Placements are searched in increasing slot order, like MonteCarloSearch.
+ * A search cut off by the depth limit resolves the assault as if both sides stopped placing.
+ */
+class AlphaBetaSearch : public TurnPlanner {
+public:
+    explicit AlphaBetaSearch(const AlphaBetaConfig& config);
+
+    TurnPlan plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) override;
+
+    // Work of the last plan() call
+    const PlannerStats& getLastStats() const { return this->lastStats; }
+
+private:
+    // Where in the round a node is
+    typedef struct Phase {
+        bool opponentToMove; // Otherwise the deciding side places
+        bool opponentNext; // The opponent still answers after the deciding side ends its turn
+        std::int8_t lastSlot; // Placements go into later slots only. -1 at the start of a turn
+    } Phase;
+
+    static constexpr int maxPly = 2 * GameState::slotCount + 2;
+    static const int completeDepth = 127; // Table depth of a result no depth limit cut into, good for any depth
+
+    // Average score of every root move over the deals, searched to depth. Returns false if the budget ran out first
+    bool searchRoot(std::vector<GameState>& deals, const Move* moves, int moveCount, Phase phase, int depth, float* scores);
+    float alphaBeta(GameState& state, Phase phase, int depth, int ply, float alpha, float beta);
+    // The side to move ends its turn: the opponent answers, or the round is resolved
+    float endTurn(GameState& state, Phase phase, int depth, int ply, float alpha, float beta);
+    // The rest of the round when nobody places any more: resolve the assault and score it
+    float resolve(GameState& state);
+    float evaluate(const GameState& state) const;
+    int orderMoves(const GameState& state, Phase phase, int ply, Move tableMove, Move* moves);
+    std::uint64_t key(const GameState& state, Phase phase) const;
+    bool outOfTime();
+
+    AlphaBetaConfig config;
+    TranspositionTable table; // Kept between decisions: entries only depend on the position, and deals are part of it
+    UndoStack undo;
+    Move killers[maxPly][2];
+
+    // The decision being planned
+    bool first = true;
+    bool isPlayer = false;
+    std::int64_t deadline = 0; // steady_clock ticks
+    int iterationDepth = 0;
+    bool aborted = false;
+    bool hitDepthLimit = false; // Some line was cut by the depth limit, so a deeper iteration can still change the result
+
+    PlannerStats lastStats;
+};
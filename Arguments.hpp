@@ -0,0 +1,43 @@
+/*
+Arguments.hpp defines the checked number parsing of the headless modes' command lines (--simulate, --tournament, --compare, ...).
+A value that isn't a number, or is out of range, is reported as a usage error instead of ending the program with an exception.
+*/
+
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+/**
+ * @brief parseNumber reads text as a number in [minimum, maximum] into value, which is left alone on failure.
+ * Integers must be whole non-negative numbers, like the definition files take them. Decimals may have a sign, a point and an exponent, but must be finite.
+ * @return Whether text was such a number.
+ */
+template <typename T>
+bool parseNumber(const std::string& text, std::type_identity_t<T> minimum, std::type_identity_t<T> maximum, T& value) {
+    static_assert(std::is_arithmetic_v<T>, "parseNumber reads integers and decimals");
+    if (text.empty()) {
+        return false;
+    }
+    if constexpr (std::is_integral_v<T>) {
+        if (text.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+    }
+
+    T parsed = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (error != std::errc() || end != text.data() + text.size() || parsed < minimum || parsed > maximum) {
+        return false;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        if (!std::isfinite(parsed)) {
+            return false;
+        }
+    }
+    value = parsed;
+    return true;
+}
@@ -0,0 +1,141 @@
+#include "Assault.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+void packLane(AssaultLanes& lanes, int lane, const Card* playerCard, const Card* enemyCard) {
+    lanes.playerAttack[lane] = playerCard ? playerCard->attack : 0;
+    lanes.playerDefense[lane] = playerCard ? playerCard->defense : 0;
+    lanes.playerHealth[lane] = playerCard ? playerCard->currHealth : 0;
+    lanes.enemyAttack[lane] = enemyCard ? enemyCard->attack : 0;
+    lanes.enemyDefense[lane] = enemyCard ? enemyCard->defense : 0;
+    lanes.enemyHealth[lane] = enemyCard ? enemyCard->currHealth : 0;
+    lanes.playerPresent[lane] = playerCard ? -1 : 0;
+    lanes.enemyPresent[lane] = enemyCard ? -1 : 0;
+
+    // Assault abilities only trigger between two opposing cards
+    lanes.playerPierce[lane] = 0;
+    lanes.enemyPierce[lane] = 0;
+    lanes.playerHate[lane] = 0;
+    lanes.enemyHate[lane] = 0;
+    lanes.kamikaze[lane] = 0;
+    if (playerCard && enemyCard) {
+        SpecialAbility playerSpecial = playerCard->getType().special;
+        SpecialAbility enemySpecial = enemyCard->getType().special;
+        lanes.playerPierce[lane] = playerSpecial == ARMOR_PIERCE ? -1 : 0;
+        lanes.enemyPierce[lane] = enemySpecial == ARMOR_PIERCE ? -1 : 0;
+        lanes.playerHate[lane] = playerSpecial == HATE ? hateBonus(enemyCard->getID()) : 0;
+        lanes.enemyHate[lane] = enemySpecial == HATE ? hateBonus(playerCard->getID()) : 0;
+        lanes.kamikaze[lane] = (playerSpecial == KAMIKAZE || enemySpecial == KAMIKAZE) ? -1 : 0;
+    }
+}
+
+void packAssault(const GameState& state, AssaultLanes& lanes) {
+    for (int i = 0; i < AssaultLanes::width; i++) {
+        const Card* playerCard = i < GameState::slotCount && !state.playerCards[i].isBlank() ? &state.playerCards[i] : nullptr;
+        const Card* enemyCard = i < GameState::slotCount && !state.enemyCards[i].isBlank() ? &state.enemyCards[i] : nullptr;
+        packLane(lanes, i, playerCard, enemyCard);
+    }
+}
+
+void resolveAssaultScalar(AssaultLanes& lanes) {
+    // Written with masks instead of branches so the compiler can vectorise it as well
+    for (int i = 0; i < AssaultLanes::width; i++) {
+        const std::int32_t both = lanes.playerPresent[i] & lanes.enemyPresent[i];
+        const std::int32_t onlyPlayer = lanes.playerPresent[i] & ~lanes.enemyPresent[i];
+        const std::int32_t onlyEnemy = lanes.enemyPresent[i] & ~lanes.playerPresent[i];
+
+        // Abilities: HATE raises the attacker's attack, ARMOR_PIERCE removes the target's defense, KAMIKAZE zeroes both healths
+        const std::int32_t playerAttack = lanes.playerAttack[i] + lanes.playerHate[i];
+        const std::int32_t enemyAttack = lanes.enemyAttack[i] + lanes.enemyHate[i];
+        const std::int32_t playerDefense = lanes.playerDefense[i] & ~lanes.enemyPierce[i];
+        const std::int32_t enemyDefense = lanes.enemyDefense[i] & ~lanes.playerPierce[i];
+        const std::int32_t prevPlayerHP = lanes.playerHealth[i] & ~lanes.kamikaze[i];
+        const std::int32_t prevEnemyHP = lanes.enemyHealth[i] & ~lanes.kamikaze[i];
+
+        const std::int32_t damageToPlayer = std::max(0, enemyAttack - playerDefense) & both;
+        const std::int32_t damageToEnemy = std::max(0, playerAttack - enemyDefense) & both;
+        const std::int32_t overflowToPlayer = std::max(0, damageToPlayer - prevPlayerHP) & both;
+        const std::int32_t overflowToEnemy = std::max(0, damageToEnemy - prevEnemyHP) & both;
+
+        // Fatigue of war: -1 when neither card dealt damage
+        const std::int32_t fatigue = -static_cast<std::int32_t>((damageToPlayer | damageToEnemy) == 0) & both;
+
+        const std::int32_t playerHP = prevPlayerHP - damageToPlayer + fatigue;
+        const std::int32_t enemyHP = prevEnemyHP - damageToEnemy + fatigue;
+
+        lanes.damageToPlayerCard[i] = damageToPlayer;
+        lanes.damageToEnemyCard[i] = damageToEnemy;
+        lanes.overflowToPlayer[i] = overflowToPlayer;
+        lanes.overflowToEnemy[i] = overflowToEnemy;
+        lanes.fatigue[i] = fatigue;
+        lanes.faceDamageToPlayer[i] = (lanes.enemyAttack[i] & onlyEnemy) + overflowToPlayer;
+        lanes.faceDamageToEnemy[i] = (lanes.playerAttack[i] & onlyPlayer) + overflowToEnemy;
+        lanes.playerDead[i] = -static_cast<std::int32_t>(playerHP <= 0) & both;
+        lanes.enemyDead[i] = -static_cast<std::int32_t>(enemyHP <= 0) & both;
+        lanes.playerHealth[i] = (playerHP & both) | (lanes.playerHealth[i] & ~both);
+        lanes.enemyHealth[i] = (enemyHP & both) | (lanes.enemyHealth[i] & ~both);
+    }
+}
+
+#if defined(__AVX2__)
+void resolveAssaultAVX2(AssaultLanes& lanes) {
+    auto load = [](const std::int32_t* field) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(field)); };
+    auto store = [](std::int32_t* field, __m256i value) { _mm256_store_si256(reinterpret_cast<__m256i*>(field), value); };
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i playerPresent = load(lanes.playerPresent);
+    const __m256i enemyPresent = load(lanes.enemyPresent);
+    const __m256i both = _mm256_and_si256(playerPresent, enemyPresent);
+    const __m256i onlyPlayer = _mm256_andnot_si256(enemyPresent, playerPresent);
+    const __m256i onlyEnemy = _mm256_andnot_si256(playerPresent, enemyPresent);
+    const __m256i kamikaze = load(lanes.kamikaze);
+
+    const __m256i baseEnemyAttack = load(lanes.enemyAttack);
+    const __m256i basePlayerAttack = load(lanes.playerAttack);
+    const __m256i playerAttack = _mm256_add_epi32(basePlayerAttack, load(lanes.playerHate));
+    const __m256i enemyAttack = _mm256_add_epi32(baseEnemyAttack, load(lanes.enemyHate));
+    const __m256i playerDefense = _mm256_andnot_si256(load(lanes.enemyPierce), load(lanes.playerDefense));
+    const __m256i enemyDefense = _mm256_andnot_si256(load(lanes.playerPierce), load(lanes.enemyDefense));
+    const __m256i oldPlayerHP = load(lanes.playerHealth);
+    const __m256i oldEnemyHP = load(lanes.enemyHealth);
+    const __m256i prevPlayerHP = _mm256_andnot_si256(kamikaze, oldPlayerHP);
+    const __m256i prevEnemyHP = _mm256_andnot_si256(kamikaze, oldEnemyHP);
+
+    const __m256i damageToPlayer = _mm256_and_si256(_mm256_max_epi32(zero, _mm256_sub_epi32(enemyAttack, playerDefense)), both);
+    const __m256i damageToEnemy = _mm256_and_si256(_mm256_max_epi32(zero, _mm256_sub_epi32(playerAttack, enemyDefense)), both);
+    const __m256i overflowToPlayer = _mm256_and_si256(_mm256_max_epi32(zero, _mm256_sub_epi32(damageToPlayer, prevPlayerHP)), both);
+    const __m256i overflowToEnemy = _mm256_and_si256(_mm256_max_epi32(zero, _mm256_sub_epi32(damageToEnemy, prevEnemyHP)), both);
+
+    const __m256i fatigue = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_or_si256(damageToPlayer, damageToEnemy), zero), both);
+
+    // fatigue is -1 where it applies, so adding it takes 1 HP
+    const __m256i playerHP = _mm256_add_epi32(_mm256_sub_epi32(prevPlayerHP, damageToPlayer), fatigue);
+    const __m256i enemyHP = _mm256_add_epi32(_mm256_sub_epi32(prevEnemyHP, damageToEnemy), fatigue);
+
+    store(lanes.damageToPlayerCard, damageToPlayer);
+    store(lanes.damageToEnemyCard, damageToEnemy);
+    store(lanes.overflowToPlayer, overflowToPlayer);
+    store(lanes.overflowToEnemy, overflowToEnemy);
+    store(lanes.fatigue, fatigue);
+    store(lanes.faceDamageToPlayer, _mm256_add_epi32(_mm256_and_si256(baseEnemyAttack, onlyEnemy), overflowToPlayer));
+    store(lanes.faceDamageToEnemy, _mm256_add_epi32(_mm256_and_si256(basePlayerAttack, onlyPlayer), overflowToEnemy));
+    // hp <= 0  <=>  !(hp > 0)
+    store(lanes.playerDead, _mm256_andnot_si256(_mm256_cmpgt_epi32(playerHP, zero), both));
+    store(lanes.enemyDead, _mm256_andnot_si256(_mm256_cmpgt_epi32(enemyHP, zero), both));
+    store(lanes.playerHealth, _mm256_blendv_epi8(oldPlayerHP, playerHP, both));
+    store(lanes.enemyHealth, _mm256_blendv_epi8(oldEnemyHP, enemyHP, both));
+}
+#endif
+
+void resolveAssault(AssaultLanes& lanes) {
+#if defined(__AVX2__)
+    resolveAssaultAVX2(lanes);
+#else
+    resolveAssaultScalar(lanes);
+#endif
+}
@@ -0,0 +1,81 @@
+/*
+Assault.hpp defines the assault kernel: the branch-free resolution of all board slots of an Assault phase at once.
+Director::turnAttack packs the board into AssaultLanes, runs the kernel, then applies the results (discards, health, events).
+The kernel has a portable scalar version and an AVX2 version, picked at compile time.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Game.hpp"
+
+/**
+ * @brief AssaultLanes holds one Assault phase in struct-of-arrays form, one lane per board slot.
+ * The lane count is padded from 5 to 8 so a whole field fits one AVX2 register. Masks are -1 (true) or 0 (false).
+ * Inputs must be 0 in lanes where they don't apply (empty slots, padding, abilities of unopposed cards).
+ */
+typedef struct AssaultLanes {
+    static const int width = 8;
+
+    // Inputs (playerHealth and enemyHealth are updated in place)
+    alignas(32) std::int32_t playerAttack[width];
+    alignas(32) std::int32_t playerDefense[width];
+    alignas(32) std::int32_t playerHealth[width];
+    alignas(32) std::int32_t enemyAttack[width];
+    alignas(32) std::int32_t enemyDefense[width];
+    alignas(32) std::int32_t enemyHealth[width];
+
+    alignas(32) std::int32_t playerPresent[width]; // Mask: the player has a card in the slot
+    alignas(32) std::int32_t enemyPresent[width];
+    alignas(32) std::int32_t playerPierce[width]; // Mask: the player card has ARMOR_PIERCE and is opposed
+    alignas(32) std::int32_t enemyPierce[width];
+    alignas(32) std::int32_t playerHate[width]; // Attack bonus of an opposed player HATE card against its target
+    alignas(32) std::int32_t enemyHate[width];
+    alignas(32) std::int32_t kamikaze[width]; // Mask: an opposed card in the slot has KAMIKAZE
+
+    // Outputs
+    alignas(32) std::int32_t damageToPlayerCard[width];
+    alignas(32) std::int32_t damageToEnemyCard[width];
+    alignas(32) std::int32_t overflowToPlayer[width];
+    alignas(32) std::int32_t overflowToEnemy[width];
+    alignas(32) std::int32_t faceDamageToPlayer[width]; // Unblocked attacks plus overflow
+    alignas(32) std::int32_t faceDamageToEnemy[width];
+    alignas(32) std::int32_t fatigue[width]; // Mask: fatigue of war was applied
+    alignas(32) std::int32_t playerDead[width]; // Mask
+    alignas(32) std::int32_t enemyDead[width];
+} AssaultLanes;
+
+/**
+ * @brief packAssault fills the input fields of lanes from the board slots of state.
+ */
+void packAssault(const GameState& state, AssaultLanes& lanes);
+
+/**
+ * @brief packLane fills the input fields of one lane with a player card and an enemy card (null for none), as if they faced each other in a slot.
+ * Lets callers resolve hypothetical match-ups (see Blocking.hpp) with the same kernel.
+ */
+void packLane(AssaultLanes& lanes, int lane, const Card* playerCard, const Card* enemyCard);
+
+/**
+ * @brief resolveAssault runs the kernel over all lanes: abilities, damage, overflow, fatigue and deaths.
+ * Uses resolveAssaultAVX2 when compiled with AVX2 support, resolveAssaultScalar otherwise. Both give identical results.
+ */
+void resolveAssault(AssaultLanes& lanes);
+void resolveAssaultScalar(AssaultLanes& lanes);
+#if defined(__AVX2__)
+void resolveAssaultAVX2(AssaultLanes& lanes);
+#endif
+
+// Attack bonus a HATE card gets against a card with the given ID
+constexpr int hateBonus(CardID target) {
+    switch (target) {
+    case CAVALRY:
+    case RECRUIT:
+        return 1;
+    case KING:
+        return 2;
+    default:
+        return 0;
+    }
+}
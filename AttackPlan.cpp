@@ -0,0 +1,281 @@
+#include "AttackPlan.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Assault.hpp"
+
+
+namespace {
+    const int maxInspire = 3; // INSPIRE cards the planner considers playing in one turn
+
+    /**
+     * @brief MatchUps resolves attacker/blocker pairs through the kernel a lane width at a time,
+     * adding each pair's overflow to the defender, times a weight, to a total of the caller's.
+     */
+    class MatchUps {
+    public:
+        explicit MatchUps(bool attackerIsPlayer) : attackerIsPlayer(attackerIsPlayer) {}
+
+        void add(const Card& attacker, const Card& blocker, double weight, double* total) {
+            packLane(this->lanes, this->count, this->attackerIsPlayer ? &attacker : &blocker, this->attackerIsPlayer ? &blocker : &attacker);
+            this->weights[this->count] = weight;
+            this->totals[this->count++] = total;
+            if (this->count == AssaultLanes::width) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (this->count == 0) {
+                return;
+            }
+            for (int lane = this->count; lane < AssaultLanes::width; lane++) {
+                packLane(this->lanes, lane, nullptr, nullptr);
+            }
+            resolveAssault(this->lanes);
+            for (int lane = 0; lane < this->count; lane++) {
+                int overflow = this->attackerIsPlayer ? this->lanes.overflowToEnemy[lane] : this->lanes.overflowToPlayer[lane];
+                *this->totals[lane] += this->weights[lane] * overflow;
+            }
+            this->count = 0;
+        }
+
+    private:
+        AssaultLanes lanes;
+        double weights[AssaultLanes::width];
+        double* totals[AssaultLanes::width];
+        int count = 0;
+        bool attackerIsPlayer;
+    };
+
+    // A card ID the attacker can play, with the copies it holds
+    typedef struct Attacker {
+        CardID id;
+        int count;
+        bool surprise;
+        bool inspire;
+        std::uint8_t slots; // legalSlots
+        int handIndices[Hand::capacity];
+        double openOverflow[maxInspire + 1]; // Expected overflow when blocked in an open lane, by INSPIRE bonus
+        double coveredOverflow[maxInspire + 1][GameState::slotCount]; // Overflow over the card already in each covered lane
+    } Attacker;
+
+    typedef struct Pick {
+        double value;
+        int attacker;
+    } Pick;
+}
+
+AttackEstimate planAttack(const GameState& state, bool first, bool isPlayer, const AttackModel& model) {
+    return planAttack(state, first, isPlayer, CardCounter(state), model);
+}
+
+AttackEstimate planAttack(const GameState& state, bool first, bool isPlayer, const CardCounter& counter, const AttackModel& model) {
+    AttackEstimate best;
+    best.faceDamage = -1.0;
+    const Card* cards = state.cards(isPlayer);
+    const Card* defenders = state.cards(!isPlayer);
+    const Hand& hand = state.hand(isPlayer);
+
+    // The defender draws up to the hand limit before it blocks
+    const int handTarget = Director::maxCards;
+    double held[CARD_COUNT];
+    double blockers = 0.0; // Cards that block ordinary attackers, expected in the defender's hand
+    double surpriseBlockers = 0.0; // DEFENSE_ONLY cards, the only ones that block SURPRISE
+    for (int id = 0; id < CARD_COUNT; id++) {
+        const CardType& type = getCardType(static_cast<CardID>(id));
+        held[id] = counter.expectedHeld(!isPlayer, static_cast<CardID>(id), handTarget);
+        blockers += inClass(type, CLASS_BLOCKER) ? held[id] : 0.0;
+        surpriseBlockers += inClass(type, CLASS_SURPRISE_BLOCKER) ? held[id] : 0.0;
+    }
+
+    int openSlots[GameState::slotCount];
+    int openCount = 0;
+    int coveredSlots[GameState::slotCount]; // Empty on the attacker's side, facing a card that survived the last assault
+    int coveredCount = 0;
+    std::uint8_t openMask = 0;
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        if (cards[slot].isBlank()) {
+            (defenders[slot].isBlank() ? openSlots[openCount++] : coveredSlots[coveredCount++]) = slot;
+            openMask |= defenders[slot].isBlank() ? 1 << slot : 0;
+        }
+    }
+
+    Attacker attackers[Hand::capacity];
+    int attackerCount = 0;
+    int inspireCards = 0;
+    for (int i = 0; i < hand.size(); i++) {
+        const CardType& type = getCardType(hand[i]);
+        const std::uint8_t slots = legalSlots(state, first, isPlayer, type.id);
+        if ((slots & openMask) != openMask || slots == 0) {
+            continue;
+        }
+        int found = 0;
+        while (found < attackerCount && attackers[found].id != type.id) {
+            found++;
+        }
+        if (found == attackerCount) {
+            attackers[attackerCount++] = { type.id, 0, type.has(FLAG_SURPRISE), type.has(FLAG_INSPIRE), slots, {}, {}, {} };
+        }
+        attackers[found].handIndices[attackers[found].count++] = i;
+        inspireCards += type.has(FLAG_INSPIRE);
+    }
+    // INSPIRE buffs the player's cards whoever plays it, so only the player's attack gains from it
+    const int maxBonus = isPlayer ? std::min({ inspireCards, maxInspire, openCount + coveredCount }) : 0;
+
+    // Overflow tables of the cards in hand, then of the cards already on the board (the side's survivors of the last assault)
+    MatchUps matchUps(isPlayer);
+    for (int bonus = 0; bonus <= maxBonus; bonus++) {
+        for (int a = 0; a < attackerCount; a++) {
+            Attacker& attacker = attackers[a];
+            Card card(attacker.id);
+            card.attack += bonus;
+            double weight = attacker.surprise ? surpriseBlockers : blockers;
+            for (int id = 0; id < CARD_COUNT && weight > 0.0; id++) {
+                const CardType& type = getCardType(static_cast<CardID>(id));
+                if (held[id] > 0.0 && inClass(type, attacker.surprise ? CLASS_SURPRISE_BLOCKER : CLASS_BLOCKER)) {
+                    matchUps.add(card, Card(type), held[id] / weight, &attacker.openOverflow[bonus]);
+                }
+            }
+            for (int c = 0; c < coveredCount; c++) {
+                matchUps.add(card, defenders[coveredSlots[c]], 1.0, &attacker.coveredOverflow[bonus][c]);
+            }
+        }
+    }
+    double boardOverflow[maxInspire + 1] = {}; // Of the side's cards facing the defender's, fixed whatever is played
+    double survivorOverflow[GameState::slotCount][maxInspire + 1] = {}; // Of the side's cards in open lanes, when blocked
+    int survivors = 0;
+    int survivorSlots[GameState::slotCount];
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        if (cards[slot].isBlank()) {
+            continue;
+        }
+        const bool surprise = cards[slot].getType().has(FLAG_SURPRISE);
+        for (int bonus = 0; bonus <= maxBonus; bonus++) {
+            Card card = cards[slot];
+            card.attack += bonus;
+            if (!defenders[slot].isBlank()) {
+                matchUps.add(card, defenders[slot], 1.0, &boardOverflow[bonus]);
+                continue;
+            }
+            double weight = surprise ? surpriseBlockers : blockers;
+            for (int id = 0; id < CARD_COUNT && weight > 0.0; id++) {
+                const CardType& type = getCardType(static_cast<CardID>(id));
+                if (held[id] > 0.0 && inClass(type, surprise ? CLASS_SURPRISE_BLOCKER : CLASS_BLOCKER)) {
+                    matchUps.add(card, Card(type), held[id] / weight, &survivorOverflow[survivors][bonus]);
+                }
+            }
+        }
+        if (defenders[slot].isBlank()) {
+            survivorSlots[survivors++] = slot;
+        }
+    }
+    matchUps.flush();
+    int survivorsSurprise = 0;
+    for (int i = 0; i < survivors; i++) {
+        survivorsSurprise += cards[survivorSlots[i]].getType().has(FLAG_SURPRISE);
+    }
+    // Expected blocks by number of lanes, shared by every choice below
+    double surpriseBlocks[GameState::slotCount + 1];
+    double allBlocks[GameState::slotCount + 1];
+    for (int lanes = 0; lanes <= GameState::slotCount; lanes++) {
+        surpriseBlocks[lanes] = model.blockRate * counter.expectedBlocks(!isPlayer, CLASS_SURPRISE_BLOCKER, lanes, handTarget);
+        allBlocks[lanes] = model.blockRate * counter.expectedBlocks(!isPlayer, CLASS_BLOCKER, lanes, handTarget);
+    }
+
+    // Open lanes are alike, so a choice is only: how many INSPIRE cards (bonus), how many SURPRISE and ordinary attackers, and which
+    for (int bonus = 0; bonus <= maxBonus; bonus++) {
+        for (int surpriseLanes = 0; surpriseLanes <= openCount; surpriseLanes++) {
+            for (int ordinaryLanes = 0; surpriseLanes + ordinaryLanes <= openCount; ordinaryLanes++) {
+                // Lanes the defender can block: its DEFENSE_ONLY cards go to the SURPRISE lanes first, the rest of its blockers to the others
+                const int surpriseTotal = surpriseLanes + survivorsSurprise;
+                const int ordinaryTotal = ordinaryLanes + survivors - survivorsSurprise;
+                double surpriseBlocked = surpriseBlocks[surpriseTotal];
+                double ordinaryBlocked = std::clamp(allBlocks[surpriseTotal + ordinaryTotal] - surpriseBlocked, 0.0, static_cast<double>(ordinaryTotal));
+                const double blocked[2] = { ordinaryTotal > 0 ? ordinaryBlocked / ordinaryTotal : 0.0, surpriseTotal > 0 ? surpriseBlocked / surpriseTotal : 0.0 };
+
+                auto value = [&](int attack, bool surprise, double overflow) {
+                    double chance = blocked[surprise];
+                    return (1.0 - chance) * (attack + bonus) + chance * overflow;
+                };
+
+                // The player's best INSPIRE cards first, then the best of the rest in each kind of lane
+                int used[Hand::capacity] = {};
+                int chosen[GameState::slotCount];
+                int chosenCount = 0;
+                int lanesLeft[2] = { ordinaryLanes, surpriseLanes };
+                double total = boardOverflow[bonus];
+                bool feasible = true;
+                for (int round = 0; round < 2 && feasible; round++) {
+                    const int wanted = round == 0 ? bonus : ordinaryLanes + surpriseLanes - bonus;
+                    for (int n = 0; n < wanted; n++) {
+                        int pick = -1;
+                        double pickValue = 0.0;
+                        for (int a = 0; a < attackerCount; a++) {
+                            const Attacker& attacker = attackers[a];
+                            if (used[a] == attacker.count || (isPlayer && attacker.inspire != (round == 0)) || lanesLeft[attacker.surprise] == 0) {
+                                continue;
+                            }
+                            double v = value(getCardType(attacker.id).attack, attacker.surprise, attacker.openOverflow[bonus]);
+                            if (pick < 0 || v > pickValue) {
+                                pick = a;
+                                pickValue = v;
+                            }
+                        }
+                        if (pick < 0) {
+                            feasible = false;
+                            break;
+                        }
+                        used[pick]++;
+                        lanesLeft[attackers[pick].surprise]--;
+                        chosen[chosenCount++] = pick;
+                        total += pickValue;
+                    }
+                }
+                if (!feasible || lanesLeft[0] > 0 || lanesLeft[1] > 0) {
+                    continue;
+                }
+                for (int i = 0; i < survivors; i++) {
+                    const Card& card = cards[survivorSlots[i]];
+                    total += value(card.attack, card.getType().has(FLAG_SURPRISE), survivorOverflow[i][bonus]);
+                }
+
+                // Covered lanes only deal overflow, known exactly. The player's INSPIRE cards are all placed already
+                int coveredPick[GameState::slotCount];
+                for (int c = 0; c < coveredCount; c++) {
+                    coveredPick[c] = -1;
+                    double pickValue = 0.0;
+                    for (int a = 0; a < attackerCount; a++) {
+                        if (used[a] < attackers[a].count && !(isPlayer && attackers[a].inspire) && ((attackers[a].slots >> coveredSlots[c]) & 1) && attackers[a].coveredOverflow[bonus][c] > pickValue) {
+                            coveredPick[c] = a;
+                            pickValue = attackers[a].coveredOverflow[bonus][c];
+                        }
+                    }
+                    if (coveredPick[c] >= 0) {
+                        used[coveredPick[c]]++;
+                        total += pickValue;
+                    }
+                }
+
+                if (total <= best.faceDamage) {
+                    continue;
+                }
+                best.faceDamage = total;
+                int handIndices[GameState::slotCount];
+                std::fill(handIndices, handIndices + GameState::slotCount, -1);
+                int copies[Hand::capacity] = {};
+                for (int i = 0; i < chosenCount; i++) {
+                    handIndices[openSlots[i]] = attackers[chosen[i]].handIndices[copies[chosen[i]]++];
+                }
+                for (int c = 0; c < coveredCount; c++) {
+                    if (coveredPick[c] >= 0) {
+                        handIndices[coveredSlots[c]] = attackers[coveredPick[c]].handIndices[copies[coveredPick[c]]++];
+                    }
+                }
+                best.plan = orderPlacements(state, isPlayer, handIndices);
+            }
+        }
+    }
+    return best;
+}
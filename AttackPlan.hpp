@@ -0,0 +1,36 @@
+/*
+AttackPlan.hpp defines the attack planner: it picks which cards to attack with, and in which lanes, to deal the most expected face damage.
+A lane's attacker is blocked with the chance that the defender's hand holds a card allowed to block it, counted by a CardCounter (only DEFENSE_ONLY cards block SURPRISE),
+its damage is the attack when unblocked and the overflow over a typical blocker otherwise (resolved with the assault kernel), and INSPIRE cards
+are played last so they buff every attacker. It works on a bare GameState in a few microseconds, so rollouts can use it as their attack policy.
+*/
+
+#pragma once
+
+#include "CardCounting.hpp"
+#include "Game.hpp"
+#include "Moves.hpp"
+
+/**
+ * @brief AttackModel is what the planner assumes about the defender.
+ */
+typedef struct AttackModel {
+    double blockRate = 1.0; // Share of the lanes the defender could block that it does block (0.8 for the scripted enemy)
+} AttackModel;
+
+/**
+ * @brief AttackEstimate is the planner's choice and what it expects of it.
+ */
+typedef struct AttackEstimate {
+    TurnPlan plan;
+    double faceDamage = 0.0; // Expected damage to the defender's health this assault, the side's cards already on the board included
+} AttackEstimate;
+
+/**
+ * @brief planAttack plans the attack of side isPlayer, which must be the attacking side (isPlayer == first).
+ * The defender's hand is unknown: it is what counter knows of it, drawn up to Director::maxCards cards (see CardCounting.hpp).
+ */
+AttackEstimate planAttack(const GameState& state, bool first, bool isPlayer, const CardCounter& counter, const AttackModel& model = AttackModel());
+
+// planAttack with a counter of state, which takes the defender's whole hand and deck as hidden
+AttackEstimate planAttack(const GameState& state, bool first, bool isPlayer, const AttackModel& model = AttackModel());
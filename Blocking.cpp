@@ -0,0 +1,189 @@
+#include "Blocking.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "Assault.hpp"
+
+
+namespace {
+    // Cost of a block the rules don't allow. Every slot can always be left open, so no solution ever uses one
+    const double forbidden = 1e9;
+
+    const int maxRows = GameState::slotCount;
+    const int maxColumns = Hand::capacity + GameState::slotCount; // Every hand card, then one "leave open" column per slot
+
+    double worth(const Card& card) {
+        return card.currHealth + card.getType().attack;
+    }
+
+    /**
+     * @brief hungarian solves the rows x columns assignment problem (rows <= columns) with the shortest augmenting path form of the
+     * Hungarian method, O(rows^2 columns). Arrays are 1-based like the textbook version: row 0 and column 0 are unused.
+     * @param assignment Receives the column of every row.
+     */
+    void hungarian(const double (&cost)[maxRows + 1][maxColumns + 1], int rows, int columns, int* assignment) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        double rowPotential[maxRows + 1] = {};
+        double columnPotential[maxColumns + 1] = {};
+        int owner[maxColumns + 1] = {}; // Row assigned to each column, 0 for none
+        int previous[maxColumns + 1] = {}; // Column before each one on the current augmenting path
+
+        for (int row = 1; row <= rows; row++) {
+            double slack[maxColumns + 1];
+            bool visited[maxColumns + 1] = {};
+            std::fill(slack, slack + columns + 1, infinity);
+            owner[0] = row;
+            int column = 0;
+            do {
+                visited[column] = true;
+                int current = owner[column];
+                double delta = infinity;
+                int next = 0;
+                for (int j = 1; j <= columns; j++) {
+                    if (visited[j]) {
+                        continue;
+                    }
+                    double reduced = cost[current][j] - rowPotential[current] - columnPotential[j];
+                    if (reduced < slack[j]) {
+                        slack[j] = reduced;
+                        previous[j] = column;
+                    }
+                    if (slack[j] < delta) {
+                        delta = slack[j];
+                        next = j;
+                    }
+                }
+                for (int j = 0; j <= columns; j++) {
+                    if (visited[j]) {
+                        rowPotential[owner[j]] += delta;
+                        columnPotential[j] -= delta;
+                    }
+                    else {
+                        slack[j] -= delta;
+                    }
+                }
+                column = next;
+            } while (owner[column] != 0);
+
+            // Flip the augmenting path
+            do {
+                int before = previous[column];
+                owner[column] = owner[before];
+                column = before;
+            } while (column != 0);
+        }
+
+        for (int j = 1; j <= columns; j++) {
+            if (owner[j] != 0) {
+                assignment[owner[j]] = j;
+            }
+        }
+    }
+}
+
+BlockingSolution solveBlocking(const GameState& state, bool first, bool isPlayer, const BlockingWeights& weights) {
+    BlockingSolution solution;
+    std::fill(solution.blocker, solution.blocker + GameState::slotCount, -1);
+
+    const Card* cards = state.cards(isPlayer);
+    const Card* attackers = state.cards(!isPlayer);
+    const Hand& hand = state.hand(isPlayer);
+    LegalMoves legal = generateMoves(state, first, isPlayer, false);
+
+    int slots[maxRows];
+    int rows = 0;
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        if (!attackers[slot].isBlank() && cards[slot].isBlank()) {
+            slots[rows++] = slot;
+        }
+    }
+    if (rows == 0) {
+        return solution;
+    }
+
+    // A RALLY/INSPIRE card played by the enemy gives every card of the player +1 attack: about a point of damage each
+    int playerCards = 0;
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        playerCards += !state.playerCards[slot].isBlank();
+    }
+
+    const int columns = hand.size() + rows;
+    double cost[maxRows + 1][maxColumns + 1];
+    AssaultLanes lanes;
+    for (int row = 0; row < rows; row++) {
+        const int slot = slots[row];
+        const Card& attacker = attackers[slot];
+        const double open = weights.health * attacker.attack;
+        for (int j = 0; j < rows; j++) {
+            cost[row + 1][hand.size() + j + 1] = open;
+        }
+
+        // Copies of a card cost the same, so every card ID is resolved once. Up to a lane width of match-ups go through the kernel at a time
+        double byCard[CARD_COUNT];
+        std::uint32_t priced = 0; // Bit per CardID
+        CardID pending[AssaultLanes::width];
+        int count = 0;
+        auto resolve = [&]() {
+            resolveAssault(lanes);
+            for (int lane = 0; lane < count; lane++) {
+                Card blocker(pending[lane]);
+                const bool blockerDead = isPlayer ? lanes.playerDead[lane] : lanes.enemyDead[lane];
+                const bool attackerDead = isPlayer ? lanes.enemyDead[lane] : lanes.playerDead[lane];
+                const int taken = isPlayer ? lanes.overflowToPlayer[lane] : lanes.overflowToEnemy[lane];
+                const int dealt = isPlayer ? lanes.overflowToEnemy[lane] : lanes.overflowToPlayer[lane];
+                const int wear = isPlayer ? lanes.damageToEnemyCard[lane] : lanes.damageToPlayerCard[lane];
+                double value = weights.health * (taken - dealt);
+                value += blockerDead ? weights.cardLost * worth(blocker) : 0.0;
+                value -= attackerDead ? weights.kill * worth(attacker) : weights.wear * wear;
+                if (!isPlayer && blocker.getType().has(FLAG_INSPIRE)) {
+                    value += weights.health * playerCards;
+                }
+                byCard[pending[lane]] = value;
+            }
+            count = 0;
+        };
+        for (int i = 0; i < hand.size(); i++) {
+            CardID id = hand[i];
+            if (!((legal.slots[i] >> slot) & 1) || (priced & (1u << id))) {
+                continue;
+            }
+            priced |= 1u << id;
+            Card blocker(id);
+            if (isPlayer && blocker.getType().has(FLAG_INSPIRE)) {
+                blocker.attack += 1; // It buffs itself as well
+            }
+            packLane(lanes, count, isPlayer ? &blocker : &attacker, isPlayer ? &attacker : &blocker);
+            pending[count++] = id;
+            if (count == AssaultLanes::width) {
+                resolve();
+            }
+        }
+        if (count > 0) {
+            for (int lane = count; lane < AssaultLanes::width; lane++) {
+                packLane(lanes, lane, nullptr, nullptr);
+            }
+            resolve();
+        }
+
+        for (int i = 0; i < hand.size(); i++) {
+            cost[row + 1][i + 1] = ((legal.slots[i] >> slot) & 1) ? byCard[hand[i]] : forbidden;
+        }
+    }
+
+    int assignment[maxRows + 1] = {};
+    hungarian(cost, rows, columns, assignment);
+    for (int row = 0; row < rows; row++) {
+        int column = assignment[row + 1];
+        solution.cost += cost[row + 1][column];
+        if (column <= hand.size()) {
+            solution.blocker[slots[row]] = column - 1;
+            solution.blocks++;
+        }
+    }
+    return solution;
+}
+
+TurnPlan planBlocking(const GameState& state, bool first, bool isPlayer, const BlockingWeights& weights) {
+    return orderPlacements(state, isPlayer, solveBlocking(state, first, isPlayer, weights).blocker);
+}
@@ -0,0 +1,44 @@
+/*
+Blocking.hpp defines the blocking solver: the defence phase posed as an assignment problem. Every attacked slot gets one of the defender's
+hand cards or is left open, each (slot, card) pair is priced by resolving that match-up with the assault kernel (abilities, overflow, fatigue, deaths),
+and the Hungarian method picks the cheapest assignment. It only works on a GameState and allocates nothing, so rollouts can call it too.
+*/
+
+#pragma once
+
+#include "Game.hpp"
+#include "Moves.hpp"
+
+/**
+ * @brief BlockingWeights prices the outcome of a slot. Costs are in health points of the defender.
+ * A card's worth is its current health plus its attack.
+ */
+typedef struct BlockingWeights {
+    double health = 1.0; // Per point of damage to the defender's health (an open slot, or overflow), and minus per point of overflow it deals back
+    double cardLost = 0.1; // Per point of worth of a blocker that dies
+    double kill = 0.1; // Minus, per point of worth of an attacker that dies
+    double wear = 0.05; // Minus, per point of damage to an attacker that survives
+} BlockingWeights;
+
+/**
+ * @brief BlockingSolution is the solver's assignment: for each slot, the hand index (in the hand before any of the blocks) that blocks it,
+ * or -1 for no block.
+ */
+typedef struct BlockingSolution {
+    int blocker[GameState::slotCount];
+    double cost = 0.0; // Sum of the slots' costs
+    int blocks = 0;
+} BlockingSolution;
+
+/**
+ * @brief solveBlocking finds the cheapest blocks for side isPlayer, which must be the defending side (isPlayer != first).
+ * Only slots with an attacker and an empty blocking slot are considered, each hand card blocks at most one of them.
+ * Effects that reach beyond a slot are estimated: an enemy RALLY/INSPIRE card costs a point of health per player card it buffs.
+ * A player's INSPIRE card only counts its own buff, and REINFORCE's cards are not priced.
+ */
+BlockingSolution solveBlocking(const GameState& state, bool first, bool isPlayer, const BlockingWeights& weights = BlockingWeights());
+
+/**
+ * @brief planBlocking is solveBlocking as a TurnPlan, in the order the blocks should be played: INSPIRE cards last, so a player's INSPIRE card buffs all of its blockers.
+ */
+TurnPlan planBlocking(const GameState& state, bool first, bool isPlayer, const BlockingWeights& weights = BlockingWeights());
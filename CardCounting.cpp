@@ -0,0 +1,243 @@
+#include "CardCounting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+
+std::uint16_t classMask(const CardType& type) {
+    std::uint16_t mask = 0;
+    mask |= type.has(FLAG_CAN_DEFEND) ? 1 << CLASS_BLOCKER : 0;
+    mask |= type.has(FLAG_CAN_DEFEND) && !type.has(FLAG_CAN_ATTACK) ? 1 << CLASS_SURPRISE_BLOCKER : 0;
+    mask |= type.has(FLAG_CAN_ATTACK) ? 1 << CLASS_ATTACKER : 0;
+    mask |= type.has(FLAG_SURPRISE) ? 1 << CLASS_SURPRISE : 0;
+    mask |= type.has(FLAG_INSPIRE) ? 1 << CLASS_INSPIRE : 0;
+    mask |= type.has(FLAG_REINFORCE) ? 1 << CLASS_REINFORCE : 0;
+    mask |= type.has(FLAG_ARMOR_PIERCE) ? 1 << CLASS_ARMOR_PIERCE : 0;
+    mask |= type.has(FLAG_HATE) ? 1 << CLASS_HATE : 0;
+    mask |= type.has(FLAG_KAMIKAZE) ? 1 << CLASS_KAMIKAZE : 0;
+    return mask;
+}
+
+double logChoose(int n, int k) {
+    static const auto logFactorial = []() {
+        std::array<double, CardCounter::maxPool + 1> table = {};
+        for (int i = 1; i <= CardCounter::maxPool; i++) {
+            table[i] = table[i - 1] + std::log(static_cast<double>(i));
+        }
+        return table;
+    }();
+    return logFactorial[n] - logFactorial[k] - logFactorial[n - k];
+}
+
+double hypergeometric(int population, int successes, int draws, int x) {
+    if (x < 0 || x > successes || x > draws || draws - x > population - successes) {
+        return 0.0;
+    }
+    return std::exp(logChoose(successes, x) + logChoose(population - successes, draws - x) - logChoose(population, draws));
+}
+
+double expectedMin(int population, int successes, int draws, int lanes) {
+    if (lanes <= 0 || successes <= 0 || draws <= 0) {
+        return 0.0;
+    }
+    // lanes minus the sum over x < lanes of (lanes - x) P(X = x)
+    double shortfall = 0.0;
+    for (int x = 0; x < lanes; x++) {
+        shortfall += (lanes - x) * hypergeometric(population, successes, draws, x);
+    }
+    return lanes - shortfall;
+}
+
+void CardCounter::reset(const GameState& state) {
+    for (bool isPlayer : { false, true }) {
+        Side& side = this->sides[isPlayer];
+        side = Side();
+        const Hand& hand = state.hand(isPlayer);
+        const Deck& deck = state.deck(isPlayer);
+        side.hand = hand.size();
+        side.deck = deck.size();
+        side.bottom = deck.size() - deck.pendingShuffle();
+        for (int i = 0; i < hand.size(); i++) {
+            side.hiddenById[hand[i]]++;
+        }
+        for (int i = 0; i < deck.size(); i++) {
+            (i < deck.pendingShuffle() ? side.hiddenById : side.bottomById)[deck[i]]++;
+        }
+
+        // Classes are counted once per card ID rather than once per card
+        for (int id = 0; id < CARD_COUNT; id++) {
+            if (side.hiddenById[id] == 0 && side.bottomById[id] == 0) {
+                continue;
+            }
+            const std::uint16_t mask = classMask(getCardType(static_cast<CardID>(id)));
+            for (int c = 0; c < CLASS_COUNT; c++) {
+                if ((mask >> c) & 1) {
+                    side.hiddenByClass[c] = static_cast<std::int16_t>(side.hiddenByClass[c] + side.hiddenById[id]);
+                    side.bottomByClass[c] = static_cast<std::int16_t>(side.bottomByClass[c] + side.bottomById[id]);
+                }
+            }
+        }
+    }
+}
+
+void CardCounter::played(bool isPlayer, CardID id) {
+    Side& side = this->sides[isPlayer];
+    side.hand--;
+    if (side.knownById[id] > 0) {
+        count(side.knownById, side.knownByClass, id, -1);
+        side.known--;
+    }
+    else {
+        count(side.hiddenById, side.hiddenByClass, id, -1);
+    }
+}
+
+void CardCounter::gained(bool isPlayer, CardID id) {
+    Side& side = this->sides[isPlayer];
+    side.hand++;
+    side.known++;
+    count(side.knownById, side.knownByClass, id, 1);
+}
+
+void CardCounter::drew(bool isPlayer, CardID id) {
+    Side& side = this->sides[isPlayer];
+    if (side.deck == side.bottom) {
+        // The shuffled part is used up: the card came from the known bottom, and is still known
+        count(side.bottomById, side.bottomByClass, id, -1);
+        side.bottom--;
+        count(side.knownById, side.knownByClass, id, 1);
+        side.known++;
+    }
+    side.deck--;
+    side.hand++;
+}
+
+void CardCounter::returned(bool isPlayer, CardID id) {
+    Side& side = this->sides[isPlayer];
+    side.deck++;
+    side.bottom++;
+    count(side.bottomById, side.bottomByClass, id, 1);
+}
+
+void CardCounter::shuffled(bool isPlayer) {
+    Side& side = this->sides[isPlayer];
+    for (int id = 0; id < CARD_COUNT; id++) {
+        side.hiddenById[id] += side.bottomById[id];
+        side.bottomById[id] = 0;
+    }
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        side.hiddenByClass[c] += side.bottomByClass[c];
+        side.bottomByClass[c] = 0;
+    }
+    side.bottom = 0;
+}
+
+int CardCounter::hidden(bool isPlayer) const {
+    const Side& side = this->sides[isPlayer];
+    return side.hand - side.known + side.deck - side.bottom;
+}
+
+int CardCounter::sample(bool isPlayer, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    return side.hand - side.known + std::min(std::max(0, handTarget - side.hand), side.deck - side.bottom);
+}
+
+double CardCounter::expectedHeld(bool isPlayer, CardID id, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    const int pool = this->hidden(isPlayer);
+    const int fromBottom = this->bottomDraws(isPlayer, handTarget);
+    double held = side.knownById[id];
+    held += pool > 0 ? static_cast<double>(this->sample(isPlayer, handTarget)) * side.hiddenById[id] / pool : 0.0;
+    held += side.bottom > 0 ? static_cast<double>(fromBottom) * side.bottomById[id] / side.bottom : 0.0;
+    return held;
+}
+
+double CardCounter::expectedHeld(bool isPlayer, CardClass cardClass, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    const int pool = this->hidden(isPlayer);
+    const int fromBottom = this->bottomDraws(isPlayer, handTarget);
+    double held = side.knownByClass[cardClass];
+    held += pool > 0 ? static_cast<double>(this->sample(isPlayer, handTarget)) * side.hiddenByClass[cardClass] / pool : 0.0;
+    held += side.bottom > 0 ? static_cast<double>(fromBottom) * side.bottomByClass[cardClass] / side.bottom : 0.0;
+    return held;
+}
+
+double CardCounter::chanceHeld(bool isPlayer, CardClass cardClass, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    if (side.knownByClass[cardClass] > 0) {
+        return 1.0;
+    }
+    return 1.0 - hypergeometric(this->hidden(isPlayer), side.hiddenByClass[cardClass], this->sample(isPlayer, handTarget), 0);
+}
+
+double CardCounter::expectedDrawn(bool isPlayer, CardClass cardClass, int draws) const {
+    const Side& side = this->sides[isPlayer];
+    const int pool = this->hidden(isPlayer);
+    const int shuffled = std::min(draws, side.deck - side.bottom);
+    const int fromBottom = std::min(draws - shuffled, side.bottom);
+    double drawn = pool > 0 ? static_cast<double>(shuffled) * side.hiddenByClass[cardClass] / pool : 0.0;
+    drawn += side.bottom > 0 ? static_cast<double>(fromBottom) * side.bottomByClass[cardClass] / side.bottom : 0.0;
+    return drawn;
+}
+
+double CardCounter::expectedBlocks(bool isPlayer, CardClass cardClass, int lanes, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    const int known = side.knownByClass[cardClass];
+    if (known >= lanes) {
+        return std::max(0, lanes);
+    }
+    return known + expectedMin(this->hidden(isPlayer), side.hiddenByClass[cardClass], this->sample(isPlayer, handTarget), lanes - known);
+}
+
+int CardCounter::maxHeld(bool isPlayer, CardID id, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    return side.knownById[id] + std::min<int>(this->sample(isPlayer, handTarget), side.hiddenById[id])
+        + std::min<int>(this->bottomDraws(isPlayer, handTarget), side.bottomById[id]);
+}
+
+int CardCounter::maxHeld(bool isPlayer, CardClass cardClass, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    return side.knownByClass[cardClass] + std::min<int>(this->sample(isPlayer, handTarget), side.hiddenByClass[cardClass])
+        + std::min<int>(this->bottomDraws(isPlayer, handTarget), side.bottomByClass[cardClass]);
+}
+
+bool CardCounter::matches(const GameState& state) const {
+    for (bool isPlayer : { false, true }) {
+        const Side& side = this->sides[isPlayer];
+        const Hand& hand = state.hand(isPlayer);
+        const Deck& deck = state.deck(isPlayer);
+        if (side.hand != hand.size() || side.deck != deck.size() || side.known > side.hand || side.bottom > side.deck) {
+            return false;
+        }
+
+        int cards[CARD_COUNT] = {};
+        for (int i = 0; i < hand.size(); i++) {
+            cards[hand[i]]++;
+        }
+        for (int i = 0; i < deck.size(); i++) {
+            cards[deck[i]]++;
+        }
+        for (int id = 0; id < CARD_COUNT; id++) {
+            if (side.hiddenById[id] + side.knownById[id] + side.bottomById[id] != cards[id]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int CardCounter::bottomDraws(bool isPlayer, int handTarget) const {
+    const Side& side = this->sides[isPlayer];
+    return std::min(std::max(0, handTarget - side.hand - (side.deck - side.bottom)), side.bottom);
+}
+
+void CardCounter::count(std::int16_t* byId, std::int16_t* byClass, CardID id, int delta) {
+    byId[id] = static_cast<std::int16_t>(byId[id] + delta);
+    const std::uint16_t mask = classMask(getCardType(id));
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        if ((mask >> c) & 1) {
+            byClass[c] = static_cast<std::int16_t>(byClass[c] + delta);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*
+CardCounting.hpp defines card counting: what a side can know about its opponent's hand and deck, kept up to date as the game goes,
+and closed-form hypergeometric probabilities over it.
+A side's hand and deck start as one hidden pool, whose contents are known from the deck list but not its order.
+- Played cards leave the pool.
+- REINFORCE's cards are known while they sit in the hand.
+- Dead cards sit known at the bottom of the deck until the next shuffle pools them again.
+Draws come from the shuffled part of the deck first, so the hidden cards of a hand are a uniform sample of the hidden pool.
+Every query is a few table lookups, except the expected blocks, which take one term per lane.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Game.hpp"
+
+/**
+ * @brief A CardClass is a set of cards the AIs ask about, by what they can do.
+ */
+enum CardClass {
+    CLASS_BLOCKER, // Can defend
+    CLASS_SURPRISE_BLOCKER, // DEFENSE_ONLY, the only cards that block SURPRISE attackers
+    CLASS_ATTACKER, // Can attack
+    CLASS_SURPRISE,
+    CLASS_INSPIRE, // INSPIRE or RALLY
+    CLASS_REINFORCE,
+    CLASS_ARMOR_PIERCE,
+    CLASS_HATE,
+    CLASS_KAMIKAZE,
+
+    CLASS_COUNT,
+};
+
+// Bit c is set when the card is in CardClass c
+std::uint16_t classMask(const CardType& type);
+inline bool inClass(const CardType& type, CardClass cardClass) { return (classMask(type) >> cardClass) & 1; }
+
+// log C(n, k), from a table of log factorials up to CardCounter::maxPool
+double logChoose(int n, int k);
+
+// P(X = x) for X the successes among draws cards drawn without replacement from population cards, successes of which are successes
+double hypergeometric(int population, int successes, int draws, int x);
+
+// E[min(X, lanes)] for the same X. One term per lane
+double expectedMin(int population, int successes, int draws, int lanes);
+
+/**
+ * @brief CardCounter counts the cards of both sides as an observer with a perfect memory would.
+ * Director keeps the one attached to it up to date (see Director::setCounter). Searches build one from a bare GameState instead.
+ */
+class CardCounter {
+public:
+    static const int maxPool = Hand::capacity + Deck::capacity;
+
+    CardCounter() = default;
+    explicit CardCounter(const GameState& state) { this->reset(state); }
+
+    /**
+     * @brief reset counts state from scratch. Hands are taken as hidden, and so is the deck except for its unshuffled bottom.
+     */
+    void reset(const GameState& state);
+
+    // The observations, in the order Director makes them
+    void played(bool isPlayer, CardID id); // From the hand to the board
+    void gained(bool isPlayer, CardID id); // Put into the hand in the open (REINFORCE)
+    void drew(bool isPlayer, CardID id); // id is only read when the card came from the known bottom of the deck
+    void returned(bool isPlayer, CardID id); // Put on the bottom of the deck (Director::discardCard)
+    void shuffled(bool isPlayer);
+
+    int handSize(bool isPlayer) const { return this->sides[isPlayer].hand; }
+    int deckSize(bool isPlayer) const { return this->sides[isPlayer].deck; }
+    // Cards of the hidden pool: the hidden part of the hand and the shuffled part of the deck
+    int hidden(bool isPlayer) const;
+    int hidden(bool isPlayer, CardID id) const { return this->sides[isPlayer].hiddenById[id]; }
+    int hidden(bool isPlayer, CardClass cardClass) const { return this->sides[isPlayer].hiddenByClass[cardClass]; }
+    // Cards known to be in the hand
+    int known(bool isPlayer, CardID id) const { return this->sides[isPlayer].knownById[id]; }
+    int known(bool isPlayer, CardClass cardClass) const { return this->sides[isPlayer].knownByClass[cardClass]; }
+
+    /**
+     * @brief sample is the number of hidden cards in the hand once it is drawn up to handTarget (0: as it is now).
+     */
+    int sample(bool isPlayer, int handTarget = 0) const;
+
+    // Expected copies in the hand once it is drawn up to handTarget
+    double expectedHeld(bool isPlayer, CardID id, int handTarget = 0) const;
+    double expectedHeld(bool isPlayer, CardClass cardClass, int handTarget = 0) const;
+    // Chance the hand holds at least one card of the class once it is drawn up to handTarget
+    double chanceHeld(bool isPlayer, CardClass cardClass, int handTarget = 0) const;
+    // Expected cards of the class among the next draws cards of the deck
+    double expectedDrawn(bool isPlayer, CardClass cardClass, int draws) const;
+    // Expected slots out of lanes the hand can fill with cards of the class, once it is drawn up to handTarget
+    double expectedBlocks(bool isPlayer, CardClass cardClass, int lanes, int handTarget = 0) const;
+    // Most copies the hand can hold once it is drawn up to handTarget, whatever it draws
+    int maxHeld(bool isPlayer, CardID id, int handTarget = 0) const;
+    int maxHeld(bool isPlayer, CardClass cardClass, int handTarget = 0) const;
+
+    /**
+     * @brief matches checks the counts against state: the hand and deck sizes, and every card of a hand or deck counted exactly once,
+     * as hidden, known or at the bottom. What is known can't be checked, but a counter told of anything that didn't happen fails this.
+     */
+    bool matches(const GameState& state) const;
+
+private:
+    typedef struct Side {
+        std::int16_t hiddenById[CARD_COUNT];
+        std::int16_t knownById[CARD_COUNT];
+        std::int16_t bottomById[CARD_COUNT];
+        std::int16_t hiddenByClass[CLASS_COUNT];
+        std::int16_t knownByClass[CLASS_COUNT];
+        std::int16_t bottomByClass[CLASS_COUNT];
+        int hand;
+        int deck;
+        int known; // Cards of the hand that are known
+        int bottom; // Cards at the bottom of the deck that are known, below the shuffled ones
+    } Side;
+
+    static void count(std::int16_t* byId, std::int16_t* byClass, CardID id, int delta);
+    // Cards the hand draws from the known bottom of the deck when it is drawn up to handTarget
+    int bottomDraws(bool isPlayer, int handTarget) const;
+
+    Side sides[2] = {}; // Indexed by isPlayer
+};
@@ -0,0 +1,364 @@
+#include "CardDatabase.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+
+namespace {
+    // Identifiers used in the text definitions, indexed by their enum value
+    constexpr const char* cardIdNames[] = {
+        "STRIDER", "ELVEN_PRINCE", "RECRUIT", "ELVEN_SOLDIER", "LOCKBEARER", "THE_WHITE", "KING",
+        "EOMER", "CAVALRY",
+        "URUK", "ORC", "DUNLENDING", "BERSERKER", "BATTERING_RAM", "FELGROM",
+    };
+    constexpr const char* abilityNames[] = {
+        "NONE", "SURPRISE", "INSPIRE", "REINFORCE", "RALLY", "ARMOR_PIERCE", "HATE", "KAMIKAZE",
+    };
+    constexpr const char* conditionNames[] = {
+        "FREE", "ATTACK_ONLY", "DEFENSE_ONLY",
+    };
+    static_assert(sizeof(cardIdNames) / sizeof(cardIdNames[0]) == CARD_COUNT, "Every CardID needs an identifier");
+    static_assert(sizeof(abilityNames) / sizeof(abilityNames[0]) == ABILITY_COUNT, "Every SpecialAbility needs an identifier");
+    static_assert(sizeof(conditionNames) / sizeof(conditionNames[0]) == CONDITION_COUNT, "Every PlayCondition needs an identifier");
+
+    template <std::size_t Size>
+    int findName(const char* const (&names)[Size], const std::string& name) {
+        for (std::size_t i = 0; i < Size; i++) {
+            if (name == names[i]) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    std::string trim(const std::string& text) {
+        std::size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        std::size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::vector<std::string> splitFields(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '|')) {
+            fields.push_back(trim(field));
+        }
+        return fields;
+    }
+
+    bool parseNumber(const std::string& text, int minimum, int maximum, int& value) {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 5) {
+            return false;
+        }
+        value = std::stoi(text);
+        return value >= minimum && value <= maximum;
+    }
+
+    std::uint64_t checksum(const unsigned char* data, std::size_t size) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void append(std::vector<unsigned char>& blob, const T& value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        blob.insert(blob.end(), bytes, bytes + sizeof(T));
+    }
+}
+
+std::string CardDatabase::blobPath(const std::string& sourcePath) {
+    return std::filesystem::path(sourcePath).replace_extension(".bin").string();
+}
+
+bool CardDatabase::load(const std::string& sourcePath) {
+    // On failure the set active before stays in use, along with the mapping or copy its names point into
+    const std::string keeping = activeSource.empty() ? "keeping the built-in cards" : "keeping the cards of " + activeSource;
+
+    std::error_code error;
+    std::uint64_t sourceSize = std::filesystem::file_size(sourcePath, error);
+    std::int64_t sourceTime = 0;
+    if (!error) {
+        sourceTime = static_cast<std::int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+    }
+    if (error) {
+        std::cerr << "CardDatabase: Can't read " << sourcePath << ", " << keeping << "\n";
+        return false;
+    }
+
+    // Fast path: the blob is up to date, map it and go
+    std::string binaryPath = blobPath(sourcePath);
+    MappedFile blobFile;
+    if (blobFile.open(binaryPath) && isCurrent(blobFile.getData(), blobFile.getSize(), sourceSize, sourceTime)) {
+        use(std::move(blobFile), sourcePath);
+        return true;
+    }
+    blobFile.close();
+
+    // The text changed (or was never compiled). Rebuild the blob next to it
+    std::vector<unsigned char> blob;
+    if (!compile(sourcePath, sourceSize, sourceTime, blob)) {
+        std::cerr << "CardDatabase: " << sourcePath << " has errors, " << keeping << "\n";
+        return false;
+    }
+
+    // Written to a temporary file first, so a crash never leaves a half-written blob behind
+    std::string temporaryPath = binaryPath + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    }
+    std::filesystem::rename(temporaryPath, binaryPath, error);
+    if (error || !blobFile.open(binaryPath) || !isCurrent(blobFile.getData(), blobFile.getSize(), sourceSize, sourceTime)) {
+        // Read-only install directory, or another instance (or this one) has the old blob open. Use this run's copy
+        std::cerr << "CardDatabase: Can't write " << binaryPath << ", using the definitions without caching them\n";
+        std::filesystem::remove(temporaryPath, error);
+        use(std::move(blob), sourcePath);
+        return true;
+    }
+    use(std::move(blobFile), sourcePath);
+    return true;
+}
+
+void CardDatabase::use(MappedFile&& file, const std::string& sourcePath) {
+    // Moving keeps the mapped address, so the names activated from file stay valid in mapping
+    activate(file.getData());
+    mapping = std::move(file);
+    compiled = std::vector<unsigned char>();
+    activeSource = sourcePath;
+}
+
+void CardDatabase::use(std::vector<unsigned char>&& blob, const std::string& sourcePath) {
+    activate(blob.data());
+    compiled = std::move(blob);
+    mapping.close();
+    activeSource = sourcePath;
+}
+
+bool CardDatabase::compile(const std::string& sourcePath, std::uint64_t sourceSize, std::int64_t sourceTime, std::vector<unsigned char>& blob) {
+    std::ifstream in(sourcePath);
+    if (!in) {
+        return false;
+    }
+
+    CardBlobRecord records[CARD_COUNT] = {};
+    bool defined[CARD_COUNT] = {};
+    std::vector<CardBlobDeckEntry> decks[2]; // 0 = player, 1 = enemy
+    int deckSizes[2] = {};
+    int section = -1; // 0 = cards, 1 = player deck, 2 = enemy deck
+    bool valid = true;
+
+    auto fail = [&](int lineNumber, const std::string& message) {
+        std::cerr << sourcePath << ":" << lineNumber << ": " << message << "\n";
+        valid = false;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            if (line == "[cards]") {
+                section = 0;
+            }
+            else if (line == "[player deck]") {
+                section = 1;
+            }
+            else if (line == "[enemy deck]") {
+                section = 2;
+            }
+            else {
+                fail(lineNumber, "Unknown section " + line);
+            }
+            continue;
+        }
+
+        std::vector<std::string> fields = splitFields(line);
+        int id = findName(cardIdNames, fields[0]);
+        if (id < 0) {
+            fail(lineNumber, "Unknown card ID " + fields[0]);
+            continue;
+        }
+
+        if (section == 0) {
+            // ID | Name | Health | Attack | Defense [| Ability [| Condition]]
+            if (fields.size() < 5 || fields.size() > 7) {
+                fail(lineNumber, "Expected ID | Name | Health | Attack | Defense | Ability | Condition");
+                continue;
+            }
+            if (defined[id]) {
+                fail(lineNumber, fields[0] + " is defined twice");
+                continue;
+            }
+            CardBlobRecord& record = records[id];
+            int health = 0, attack = 0, defense = 0;
+            if (fields[1].empty() || fields[1].size() >= sizeof(record.name)) {
+                fail(lineNumber, "Card names must be 1 to " + std::to_string(sizeof(record.name) - 1) + " characters");
+            }
+            if (!parseNumber(fields[2], 1, 9999, health) || !parseNumber(fields[3], 0, 9999, attack) || !parseNumber(fields[4], 0, 9999, defense)) {
+                fail(lineNumber, "Health must be 1 to 9999, attack and defense 0 to 9999");
+            }
+            int special = fields.size() > 5 ? findName(abilityNames, fields[5]) : NONE;
+            int condition = fields.size() > 6 ? findName(conditionNames, fields[6]) : FREE;
+            if (special < 0) {
+                fail(lineNumber, "Unknown ability " + fields[5]);
+            }
+            if (condition < 0) {
+                fail(lineNumber, "Unknown play condition " + fields[6]);
+            }
+            if (special == REINFORCE && (id == EOMER || id == CAVALRY)) {
+                fail(lineNumber, "EOMER and CAVALRY are what REINFORCE brings, they can't have REINFORCE themselves");
+            }
+
+            defined[id] = true;
+            record.id = static_cast<std::int8_t>(id);
+            record.special = static_cast<std::uint8_t>(special);
+            record.condition = static_cast<std::uint8_t>(condition);
+            record.maxHealth = static_cast<std::int16_t>(health);
+            record.attack = static_cast<std::int16_t>(attack);
+            record.defense = static_cast<std::int16_t>(defense);
+            std::strncpy(record.name, fields[1].c_str(), sizeof(record.name) - 1);
+        }
+        else if (section == 1 || section == 2) {
+            // ID | Copies
+            int count = 0;
+            if (fields.size() != 2 || !parseNumber(fields[1], 1, Deck::capacity, count)) {
+                fail(lineNumber, "Expected ID | Copies, with 1 to " + std::to_string(Deck::capacity) + " copies");
+                continue;
+            }
+            decks[section - 1].push_back({ static_cast<std::int8_t>(id), 0, static_cast<std::uint16_t>(count) });
+            deckSizes[section - 1] += count;
+        }
+        else {
+            fail(lineNumber, "Definitions must be inside a [cards], [player deck] or [enemy deck] section");
+        }
+    }
+
+    for (int id = 0; id < CARD_COUNT; id++) {
+        if (!defined[id]) {
+            fail(lineNumber, std::string("Card ") + cardIdNames[id] + " is not defined");
+        }
+    }
+    for (int side = 0; side < 2; side++) {
+        if (deckSizes[side] == 0 || deckSizes[side] > Deck::capacity) {
+            fail(lineNumber, std::string(side == 0 ? "Player" : "Enemy") + " deck must have 1 to " + std::to_string(Deck::capacity) + " cards");
+        }
+    }
+    if (!valid) {
+        return false;
+    }
+
+    CardBlobHeader header = {};
+    std::memcpy(header.magic, "RLSC", sizeof(header.magic));
+    header.version = version;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.cardCount = CARD_COUNT;
+    header.playerDeckCount = static_cast<std::uint16_t>(decks[0].size());
+    header.enemyDeckCount = static_cast<std::uint16_t>(decks[1].size());
+
+    blob.clear();
+    append(blob, header);
+    for (const CardBlobRecord& record : records) {
+        append(blob, record);
+    }
+    for (const std::vector<CardBlobDeckEntry>& deck : decks) {
+        for (const CardBlobDeckEntry& entry : deck) {
+            append(blob, entry);
+        }
+    }
+    header.checksum = checksum(blob.data() + sizeof(CardBlobHeader), blob.size() - sizeof(CardBlobHeader));
+    std::memcpy(blob.data(), &header, sizeof(header));
+    return true;
+}
+
+bool CardDatabase::isCurrent(const unsigned char* data, std::size_t size, std::uint64_t sourceSize, std::int64_t sourceTime) {
+    if (size < sizeof(CardBlobHeader)) {
+        return false;
+    }
+    const CardBlobHeader* header = reinterpret_cast<const CardBlobHeader*>(data);
+    if (std::memcmp(header->magic, "RLSC", sizeof(header->magic)) != 0 || header->version != version
+        || header->sourceSize != sourceSize || header->sourceTime != sourceTime || header->cardCount != CARD_COUNT) {
+        return false;
+    }
+    std::size_t deckCount = static_cast<std::size_t>(header->playerDeckCount) + header->enemyDeckCount;
+    if (size != sizeof(CardBlobHeader) + CARD_COUNT * sizeof(CardBlobRecord) + deckCount * sizeof(CardBlobDeckEntry)
+        || header->checksum != checksum(data + sizeof(CardBlobHeader), size - sizeof(CardBlobHeader))) {
+        return false;
+    }
+
+    // Never trust a file on disk further than the rules can take: a damaged blob is rebuilt, not used
+    const CardBlobRecord* records = reinterpret_cast<const CardBlobRecord*>(header + 1);
+    for (int id = 0; id < CARD_COUNT; id++) {
+        const CardBlobRecord& record = records[id];
+        if (record.id != id || record.special >= ABILITY_COUNT || record.condition >= CONDITION_COUNT || record.maxHealth <= 0
+            || record.name[0] == '\0' || std::memchr(record.name, '\0', sizeof(record.name)) == nullptr) {
+            return false;
+        }
+    }
+    const CardBlobDeckEntry* entries = reinterpret_cast<const CardBlobDeckEntry*>(records + CARD_COUNT);
+    int deckSizes[2] = {};
+    for (std::size_t i = 0; i < deckCount; i++) {
+        if (entries[i].id < 0 || entries[i].id >= CARD_COUNT) {
+            return false;
+        }
+        deckSizes[i < header->playerDeckCount ? 0 : 1] += entries[i].count;
+    }
+    return deckSizes[0] > 0 && deckSizes[0] <= Deck::capacity && deckSizes[1] > 0 && deckSizes[1] <= Deck::capacity;
+}
+
+void CardDatabase::activate(const unsigned char* data) {
+    const CardBlobHeader* header = reinterpret_cast<const CardBlobHeader*>(data);
+    const CardBlobRecord* records = reinterpret_cast<const CardBlobRecord*>(header + 1);
+    const CardBlobDeckEntry* entries = reinterpret_cast<const CardBlobDeckEntry*>(records + CARD_COUNT);
+
+    // Names point straight into the blob, which stays mapped for the rest of the program
+    for (int id = 0; id < CARD_COUNT; id++) {
+        const CardBlobRecord& record = records[id];
+        cards[id] = CardType(static_cast<CardID>(record.id), record.name, record.maxHealth, record.attack, record.defense,
+            static_cast<SpecialAbility>(record.special), static_cast<PlayCondition>(record.condition));
+    }
+    playerDeck.clear();
+    enemyDeck.clear();
+    for (int i = 0; i < header->playerDeckCount + header->enemyDeckCount; i++) {
+        std::vector<DeckEntry>& deck = i < header->playerDeckCount ? playerDeck : enemyDeck;
+        deck.push_back({ static_cast<CardID>(entries[i].id), entries[i].count });
+    }
+
+    CardSet set;
+    set.cards = cards;
+    set.playerDeck = playerDeck.data();
+    set.playerDeckSize = static_cast<int>(playerDeck.size());
+    set.enemyDeck = enemyDeck.data();
+    set.enemyDeckSize = static_cast<int>(enemyDeck.size());
+    activate(set);
+}
+
+void CardDatabase::activate(const CardSet& set) {
+    activeCardSet = set;
+
+    // Tables derived from the card set, in case another set was active before
+    Director::refreshStartingState();
+}
+
+const char* CardDatabase::identifier(CardID id) {
+    return id > BLANK && id < CARD_COUNT ? cardIdNames[id] : "BLANK";
+}
+
+CardID CardDatabase::findCard(const std::string& identifier) {
+    return static_cast<CardID>(findName(cardIdNames, identifier));
+}
@@ -0,0 +1,94 @@
+/*
+CardDatabase.hpp defines the data-driven card database. Card stats and deck lists are written in a text file (CardDefinitions.txt),
+compiled into a versioned binary blob next to it (CardDefinitions.bin), and the blob is memory-mapped at startup.
+The blob records the size and modification time of the text it was compiled from, so it is rebuilt automatically whenever the text changes.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "MappedFile.hpp"
+
+/**
+ * @brief CardBlobHeader starts the binary blob. It is followed by cardCount CardBlobRecords, then the player and enemy CardBlobDeckEntries.
+ */
+typedef struct CardBlobHeader {
+    char magic[4]; // "RLSC"
+    std::uint32_t version;
+    std::uint64_t sourceSize; // Size and modification time of the text file the blob was compiled from
+    std::int64_t sourceTime;
+    std::uint32_t cardCount; // Always CARD_COUNT, in CardID order
+    std::uint16_t playerDeckCount;
+    std::uint16_t enemyDeckCount;
+    std::uint64_t checksum; // FNV-1a of everything after the header
+} CardBlobHeader;
+
+typedef struct CardBlobRecord {
+    std::int8_t id; // CardID
+    std::uint8_t special; // SpecialAbility
+    std::uint8_t condition; // PlayCondition
+    std::uint8_t reserved;
+    std::int16_t maxHealth;
+    std::int16_t attack;
+    std::int16_t defense;
+    char name[22]; // Zero-terminated
+} CardBlobRecord;
+
+typedef struct CardBlobDeckEntry {
+    std::int8_t id; // CardID
+    std::uint8_t reserved;
+    std::uint16_t count;
+} CardBlobDeckEntry;
+
+static_assert(sizeof(CardBlobHeader) == 40 && sizeof(CardBlobRecord) == 32 && sizeof(CardBlobDeckEntry) == 4, "The blob layout must not depend on the compiler");
+
+/**
+ * @brief CardDatabase loads the card definitions and makes them the active card set (see activeCardSet in Game.hpp).
+ */
+class CardDatabase {
+public:
+    // Bump whenever the blob layout or the meaning of a field changes, so old blobs get rebuilt
+    static const std::uint32_t version = 1;
+
+    /**
+     * @brief load maps the compiled blob of sourcePath, compiling it first if it is missing or stale, and activates its cards and decks.
+     * Must be called before any game starts. On failure (missing file, syntax errors) the errors are printed and the card set active before stays active:
+     * the built-in registries, or the definitions of the last successful load.
+     * @return Whether the definitions were loaded.
+     */
+    static bool load(const std::string& sourcePath);
+
+    // Path of the blob compiled from sourcePath: the same name with a .bin extension
+    static std::string blobPath(const std::string& sourcePath);
+
+    /**
+     * @brief activate makes set the active card set and rebuilds the tables derived from it. The set's arrays must outlive its use.
+     * No game may be running.
+     */
+    static void activate(const CardSet& set);
+
+    // The identifier of a card in the definitions (STRIDER, URUK, ...), and back. findCard returns BLANK for unknown identifiers
+    static const char* identifier(CardID id);
+    static CardID findCard(const std::string& identifier);
+
+private:
+    // Parses the text definitions into a complete blob
+    static bool compile(const std::string& sourcePath, std::uint64_t sourceSize, std::int64_t sourceTime, std::vector<unsigned char>& blob);
+    // Checks that data is a well-formed blob of this version, compiled from a source of this size and time
+    static bool isCurrent(const unsigned char* data, std::size_t size, std::uint64_t sourceSize, std::int64_t sourceTime);
+    static void activate(const unsigned char* data);
+    // Activates a well-formed blob, then keeps it (and releases the previous one) for as long as its names are in use
+    static void use(MappedFile&& file, const std::string& sourcePath);
+    static void use(std::vector<unsigned char>&& blob, const std::string& sourcePath);
+
+    inline static MappedFile mapping;
+    inline static std::vector<unsigned char> compiled; // Used instead of the mapping when the blob couldn't be written
+    inline static std::string activeSource; // Path of the definitions loaded last. Empty while the built-in registries are active
+    inline static CardType cards[CARD_COUNT];
+    inline static std::vector<DeckEntry> playerDeck;
+    inline static std::vector<DeckEntry> enemyDeck;
+};
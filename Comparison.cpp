@@ -0,0 +1,238 @@
+#include "Comparison.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+
+#include "Arguments.hpp"
+#include "CardDatabase.hpp"
+#include "Policy.hpp"
+#include "Simulation.hpp"
+#include "Tournament.hpp"
+
+
+double VariantResult::score() const {
+    if (this->outcomes.empty()) {
+        return 0.5;
+    }
+    long long total = 0;
+    for (std::int8_t outcome : this->outcomes) {
+        total += outcome;
+    }
+    return 0.5 + 0.5 * static_cast<double>(total) / static_cast<double>(this->outcomes.size());
+}
+
+double ComparisonResult::varianceReduction() const {
+    if (this->pairedError <= 0.0) {
+        return this->unpairedError > 0.0 ? INFINITY : 1.0;
+    }
+    double ratio = this->unpairedError / this->pairedError;
+    return ratio * ratio;
+}
+
+ComparisonResult Comparison::run() {
+    ComparisonResult result;
+    if (this->config.policies.size() > 2 || this->config.cardSets.size() > 2) {
+        std::cerr << "A comparison has exactly two variants\n";
+        return result;
+    }
+    std::vector<std::string> policies = this->config.policies;
+    if (policies.empty()) {
+        policies.push_back("scripted");
+    }
+    for (const std::string& name : policies) {
+        if (!makePolicy(name)) {
+            std::cerr << "Unknown policy: " << name << " (scripted, greedy, blocking, tactical, profile:NAME, mcts:MS or alphabeta:MS)\n";
+            return result;
+        }
+    }
+    if (!makePolicy(this->config.opponent)) {
+        std::cerr << "Unknown opponent policy: " << this->config.opponent << "\n";
+        return result;
+    }
+
+    for (int v = 0; v < 2; v++) {
+        const std::string& policy = policies[std::min<std::size_t>(v, policies.size() - 1)];
+        VariantResult& variant = result.variants[v];
+        variant.name = policy;
+        if (!this->config.cardSets.empty()) {
+            // Card sets are swapped between passes: the deck lists and card stats are global
+            const std::string& cards = this->config.cardSets[std::min<std::size_t>(v, this->config.cardSets.size() - 1)];
+            if (!CardDatabase::load(cards)) {
+                return result;
+            }
+            variant.name += " with " + cards;
+        }
+        playVariant(policy, variant);
+    }
+
+    analyse(result);
+    result.valid = true;
+    return result;
+}
+
+void Comparison::playVariant(const std::string& policy, VariantResult& variant) {
+    int threadCount = this->config.threads;
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Every seed has its own outcome slot, so workers write without locking
+    variant.outcomes.assign(static_cast<std::size_t>(std::max(0LL, this->config.games)), 0);
+    const long long gameCount = static_cast<long long>(variant.outcomes.size());
+    const long long chunkSize = 64;
+    std::atomic<long long> nextGame = 0;
+
+    auto worker = [&]() {
+        std::unique_ptr<Policy> player = makePolicy(this->config.opponent);
+        std::unique_ptr<Policy> enemy = makePolicy(policy);
+        Director game;
+
+        while (true) {
+            long long start = nextGame.fetch_add(chunkSize);
+            if (start >= gameCount) {
+                break;
+            }
+            long long end = std::min(start + chunkSize, gameCount);
+            for (long long k = start; k < end; k++) {
+                std::uint64_t seed = Simulator::gameSeed(this->config.seed, k);
+                variant.outcomes[k] = static_cast<std::int8_t>(-Tournament::playGame(game, *player, *enemy, seed, this->config.maxRounds));
+            }
+        }
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    variant.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Comparison::analyse(ComparisonResult& result) {
+    const std::vector<std::int8_t>& a = result.variants[0].outcomes;
+    const std::vector<std::int8_t>& b = result.variants[1].outcomes;
+    const long long n = static_cast<long long>(a.size());
+    if (n < 2) {
+        return;
+    }
+
+    // Scores in half points (0, 1, 2) keep the sums exact
+    long long sumA = 0, sumB = 0, squaresA = 0, squaresB = 0, products = 0;
+    for (long long k = 0; k < n; k++) {
+        long long x = a[k] + 1;
+        long long y = b[k] + 1;
+        sumA += x;
+        sumB += y;
+        squaresA += x * x;
+        squaresB += y * y;
+        products += x * y;
+        result.changedOutcomes += x != y;
+    }
+
+    // Sample variances and covariance, converted back to whole points
+    const double scale = 0.25 / static_cast<double>(n - 1);
+    double varianceA = (squaresA - static_cast<double>(sumA) * sumA / n) * scale;
+    double varianceB = (squaresB - static_cast<double>(sumB) * sumB / n) * scale;
+    double covariance = (products - static_cast<double>(sumA) * sumB / n) * scale;
+    double varianceDifference = std::max(0.0, varianceA + varianceB - 2.0 * covariance);
+
+    result.difference = 0.5 * static_cast<double>(sumB - sumA) / n;
+    result.pairedError = 1.96 * std::sqrt(varianceDifference / n);
+    result.unpairedError = 1.96 * std::sqrt((varianceA + varianceB) / n);
+    result.correlation = varianceA > 0.0 && varianceB > 0.0 ? covariance / std::sqrt(varianceA * varianceB) : 0.0;
+}
+
+void Comparison::printReport(const ComparisonResult& result) {
+    const long long games = static_cast<long long>(result.variants[0].outcomes.size());
+    std::cout << std::fixed;
+    std::cout << "Games per variant:  " << games << "\n";
+    for (int v = 0; v < 2; v++) {
+        const VariantResult& variant = result.variants[v];
+        double score = variant.score();
+        double error = games > 1 ? 1.96 * std::sqrt(std::max(0.0, score * (1.0 - score)) / games) : 0.5;
+        std::cout << "Variant " << static_cast<char>('A' + v) << ":          " << variant.name << "\n";
+        std::cout << "  Enemy score:      " << std::setprecision(4) << score << " +/- " << error
+            << std::setprecision(1) << " (" << variant.seconds << " s)\n";
+    }
+
+    std::cout << std::setprecision(4);
+    std::cout << "\nDifference (B - A): " << std::showpos << result.difference << std::noshowpos << " +/- " << result.pairedError << " (paired, 95%)\n";
+    std::cout << "Unpaired interval:  +/- " << result.unpairedError << "\n";
+    std::cout << "Correlation:        " << result.correlation << "\n";
+    std::cout << "Changed outcomes:   " << result.changedOutcomes << " of " << games << " seeds\n";
+    std::cout << std::setprecision(1);
+    std::cout << "Variance reduction: " << result.varianceReduction() << "x (an unpaired run would need about "
+        << result.varianceReduction() * games << " games per variant for this interval)\n";
+}
+
+int runComparison(int argc, char* argv[]) {
+    ComparisonConfig config;
+    bool hasSeed = false;
+    const int maxInt = std::numeric_limits<int>::max();
+    const char* usage = "Usage: --compare (--policy NAME --policy NAME | --cards FILE --cards FILE) [--opponent NAME] [--games N] [--threads N] [--max-rounds N] [--seed N]\n";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--compare") {
+            continue;
+        }
+        else if (arg == "--policy" && hasValue) {
+            config.policies.push_back(argv[++i]);
+        }
+        else if (arg == "--cards" && hasValue) {
+            config.cardSets.push_back(argv[++i]);
+        }
+        else if (arg == "--opponent" && hasValue) {
+            config.opponent = argv[++i];
+        }
+        else if (arg == "--games" && hasValue) {
+            valid = parseNumber(argv[++i], 1, std::numeric_limits<long long>::max(), config.games);
+        }
+        else if (arg == "--threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.threads);
+        }
+        else if (arg == "--max-rounds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxInt, config.maxRounds);
+        }
+        else if (arg == "--seed" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<std::uint64_t>::max(), config.seed);
+            hasSeed = true;
+        }
+        else {
+            std::cerr << "Unknown comparison argument: " << arg << "\n" << usage;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n" << usage;
+            return 1;
+        }
+    }
+    if (config.policies.size() != 2 && config.cardSets.size() != 2) {
+        std::cerr << "A comparison needs two enemy policies (--policy) or two card files (--cards)\n";
+        return 1;
+    }
+    if (!hasSeed) {
+        config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    std::cout << "Run seed: " << config.seed << "\n";
+
+    Comparison comparison(config);
+    ComparisonResult result = comparison.run();
+    if (!result.valid) {
+        return 1;
+    }
+    Comparison::printReport(result);
+    return 0;
+}
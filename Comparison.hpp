@@ -0,0 +1,69 @@
+/*
+Comparison.hpp defines the paired comparison of two variants: two enemy policies, or two card definition files.
+Both variants play the same seeds, and Director reseeds every deck shuffle from the game seed (see Director::shuffleSeed),
+so both see the same shuffles. The difference is then measured seed by seed, which removes most of the shuffle luck from it.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef struct ComparisonConfig {
+    // The two variants. A list with a single entry is shared by both; an empty list means the scripted enemy or the loaded cards
+    std::vector<std::string> policies; // Enemy policies, see makePolicy
+    std::vector<std::string> cardSets; // Card definition files, see CardDatabase::load
+    std::string opponent = "greedy"; // Policy of the player side, the same for both variants
+    long long games = 10000; // Seeds played by each variant
+    int threads = 0; // Worker threads. 0 = one per hardware thread
+    int maxRounds = 500; // Games still running after this many rounds count as draws
+    std::uint64_t seed = 0; // Run seed. Seed k is gameSeed(seed, k) for both variants
+} ComparisonConfig;
+
+/**
+ * @brief VariantResult is one variant's games, scored from the enemy's point of view (1 = win, 0.5 = draw, 0 = loss).
+ */
+typedef struct VariantResult {
+    std::string name;
+    std::vector<std::int8_t> outcomes; // Per seed: 1 enemy win, -1 player win, 0 draw or timeout
+    double seconds = 0.0;
+
+    double score() const;
+} VariantResult;
+
+typedef struct ComparisonResult {
+    VariantResult variants[2];
+    double difference = 0.0; // Mean score of the second variant minus the first
+    double pairedError = 0.0; // Half-width of the 95% confidence interval of difference, from the per-seed differences
+    double unpairedError = 0.0; // The same, had both variants played independent seeds
+    double correlation = 0.0; // Between the two variants' per-seed scores
+    long long changedOutcomes = 0; // Seeds whose outcome differs between the variants
+    bool valid = false;
+
+    // How many times more games an unpaired run would need for the same confidence
+    double varianceReduction() const;
+} ComparisonResult;
+
+class Comparison {
+public:
+    Comparison(ComparisonConfig config) : config(config) {}
+
+    // Returns an invalid result if a policy name is unknown or a card file doesn't load
+    ComparisonResult run();
+
+    static void printReport(const ComparisonResult& result);
+
+private:
+    // Plays every seed with one variant, on all threads
+    void playVariant(const std::string& policy, VariantResult& variant);
+    static void analyse(ComparisonResult& result);
+
+    ComparisonConfig config;
+};
+
+/**
+ * @brief runComparison is the entry point of --compare mode.
+ * Usage: --compare (--policy NAME --policy NAME | --cards FILE --cards FILE) [--opponent NAME] [--games N] [--threads N] [--max-rounds N] [--seed N]
+ */
+int runComparison(int argc, char* argv[]);
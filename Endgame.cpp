@@ -0,0 +1,646 @@
+#include "Endgame.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "Assault.hpp"
+#include "CardCounting.hpp"
+#include "Playout.hpp"
+
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Outside the values' range [0, 1], so a window bounded by them never cuts
+    const float below = -1.0f;
+    const float above = 2.0f;
+
+    // One way a draw can come out: the copies of each card drawn, and its odds
+    typedef struct Outcome {
+        std::int8_t drawn[CARD_COUNT];
+        double probability;
+    } Outcome;
+
+    std::uint64_t checksum(const unsigned char* data, std::size_t size) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // Moves the side's hand into its deck and shuffles it, so the hand is dealt again by the next draw
+    // @return Whether the whole hand fit in the deck
+    bool poolHand(GameState& state, bool isPlayer) {
+        while (!state.hand(isPlayer).empty() && !state.deck(isPlayer).full()) {
+            state.putBottom(isPlayer, state.removeHand(isPlayer, state.hand(isPlayer).size() - 1));
+        }
+        state.deck(isPlayer).shuffle();
+        return state.hand(isPlayer).empty();
+    }
+
+    // Every multiset of draws cards the deck can deal, with its hypergeometric odds, most likely first
+    void drawOutcomes(const Deck& deck, int draws, std::vector<Outcome>& outcomes) {
+        int counts[CARD_COUNT] = {};
+        for (int i = 0; i < deck.size(); i++) {
+            counts[deck[i]]++;
+        }
+        const double total = logChoose(deck.size(), draws);
+
+        Outcome outcome = {};
+        auto enumerate = [&](auto& self, int id, int left, double logWays) -> void {
+            if (left == 0) {
+                outcome.probability = std::exp(logWays - total);
+                outcomes.push_back(outcome);
+                return;
+            }
+            if (id == CARD_COUNT) {
+                return;
+            }
+            for (int copies = std::min(left, counts[id]); copies >= 0; copies--) {
+                outcome.drawn[id] = static_cast<std::int8_t>(copies);
+                self(self, id + 1, left - copies, logWays + logChoose(counts[id], copies));
+            }
+            outcome.drawn[id] = 0;
+        };
+        enumerate(enumerate, 0, draws, 0.0);
+        std::sort(outcomes.begin(), outcomes.end(), [](const Outcome& a, const Outcome& b) { return a.probability > b.probability; });
+    }
+
+    /**
+     * In the last round solved, what a hand holds past the turn doesn't matter: only the cards the side can place count, and no more copies
+     * than the slots they fit. Merges the outcomes alike in those, keeping the likeliest as the one dealt, most likely first.
+     */
+    void mergeOutcomes(const GameState& state, bool first, bool isPlayer, std::vector<Outcome>& outcomes) {
+        int held[CARD_COUNT] = {};
+        for (int i = 0; i < state.hand(isPlayer).size(); i++) {
+            held[state.hand(isPlayer)[i]]++;
+        }
+        int usable[CARD_COUNT];
+        for (int id = 0; id < CARD_COUNT; id++) {
+            usable[id] = std::popcount(legalSlots(state, first, isPlayer, static_cast<CardID>(id)));
+        }
+
+        std::vector<std::pair<std::uint64_t, int>> keys(outcomes.size()); // 4 bits per card ID, and the outcome's index
+        for (int i = 0; i < static_cast<int>(outcomes.size()); i++) {
+            std::uint64_t key = 0;
+            for (int id = 0; id < CARD_COUNT; id++) {
+                key |= static_cast<std::uint64_t>(std::min(held[id] + outcomes[i].drawn[id], usable[id])) << (4 * id);
+            }
+            keys[i] = { key, i };
+        }
+        std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<Outcome> merged;
+        for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+            const Outcome& outcome = outcomes[keys[i].second];
+            if (i > 0 && keys[i].first == keys[i - 1].first) {
+                merged.back().probability += outcome.probability;
+            }
+            else {
+                merged.push_back(outcome);
+            }
+        }
+        std::sort(merged.begin(), merged.end(), [](const Outcome& a, const Outcome& b) { return a.probability > b.probability; });
+        outcomes = std::move(merged);
+    }
+
+    // Deals outcome from the side's deck into its hand. The deck stays shuffled
+    void dealOutcome(GameState& state, bool isPlayer, const Outcome& outcome) {
+        Deck& deck = state.deck(isPlayer);
+        int left[CARD_COUNT];
+        for (int id = 0; id < CARD_COUNT; id++) {
+            left[id] = outcome.drawn[id];
+        }
+        CardID kept[Deck::capacity];
+        int keptCount = 0;
+        for (int i = 0; i < deck.size(); i++) {
+            CardID id = deck[i];
+            if (left[id] > 0) {
+                left[id]--;
+                state.pushHand(isPlayer, id);
+                state.hash.piles -= Zobrist::deckKey(isPlayer, id);
+            }
+            else {
+                kept[keptCount++] = id;
+            }
+        }
+        deck.clear();
+        for (int i = 0; i < keptCount; i++) {
+            deck.putBottom(kept[i]);
+        }
+        deck.shuffle();
+    }
+}
+
+bool EndgameTable::probe(std::uint64_t key, EndgameEntry& entry) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(key);
+    if (found == this->entries.end()) {
+        return false;
+    }
+    entry = found->second;
+    return true;
+}
+
+void EndgameTable::store(std::uint64_t key, const EndgameEntry& entry) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(key);
+    if (found == this->entries.end()) {
+        if (this->entries.size() < this->maxEntries) {
+            this->entries.emplace(key, entry);
+        }
+    }
+    else if (found->second.rounds <= entry.rounds) {
+        found->second = entry;
+    }
+}
+
+std::size_t EndgameTable::size() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+}
+
+std::uint64_t EndgameTable::rulesHash() {
+    std::vector<std::int32_t> rules = { Director::maxCards, GameState::slotCount, CARD_COUNT };
+    for (int id = 0; id < CARD_COUNT; id++) {
+        const CardType& type = getCardType(static_cast<CardID>(id));
+        rules.insert(rules.end(), { type.maxHealth, type.attack, type.defense, type.special, type.condition });
+    }
+    return checksum(reinterpret_cast<const unsigned char*>(rules.data()), rules.size() * sizeof(std::int32_t));
+}
+
+bool EndgameTable::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false; // Never saved yet
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    EndgameFileHeader header = {};
+    if (data.size() >= sizeof(header)) {
+        std::memcpy(&header, data.data(), sizeof(header));
+    }
+    const std::size_t recordBytes = data.size() - std::min(data.size(), sizeof(header));
+    if (data.size() < sizeof(header) || std::memcmp(header.magic, "RLSG", sizeof(header.magic)) != 0 || header.version != version
+        || recordBytes != header.count * sizeof(EndgameRecord) || header.checksum != checksum(data.data() + sizeof(header), recordBytes)) {
+        std::cerr << "EndgameTable: " << path << " is damaged or out of date, starting an empty table\n";
+        return false;
+    }
+    if (header.rules != rulesHash()) {
+        std::cerr << "EndgameTable: " << path << " was solved with other card definitions, starting an empty table\n";
+        return false;
+    }
+
+    for (std::uint64_t i = 0; i < header.count; i++) {
+        EndgameRecord record;
+        std::memcpy(&record, data.data() + sizeof(header) + i * sizeof(EndgameRecord), sizeof(record));
+        if (record.entry.bound <= EndgameEntry::UPPER && record.entry.rounds > 0) {
+            this->store(record.key, record.entry);
+        }
+    }
+    return true;
+}
+
+bool EndgameTable::save(const std::string& path) const {
+    std::vector<EndgameRecord> records;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        records.reserve(this->entries.size());
+        for (const auto& [key, entry] : this->entries) {
+            records.push_back({ key, entry });
+        }
+    }
+
+    EndgameFileHeader header = {};
+    std::memcpy(header.magic, "RLSG", sizeof(header.magic));
+    header.version = version;
+    header.rules = rulesHash();
+    header.count = records.size();
+    header.checksum = checksum(reinterpret_cast<const unsigned char*>(records.data()), records.size() * sizeof(EndgameRecord));
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(EndgameRecord)));
+        if (!out) {
+            std::cerr << "EndgameTable: Can't write " << temporaryPath << "\n";
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::cerr << "EndgameTable: Can't write " << path << "\n";
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+EndgameSolver::EndgameSolver(const EndgameConfig& config, std::shared_ptr<EndgameTable> table, std::shared_ptr<TurnPlanner> fallback)
+    : config(config), table(std::move(table)), fallback(std::move(fallback)) {
+    this->config.rounds = std::clamp(this->config.rounds, 1, EndgameEntry::completeRounds - 1);
+    if (!this->table) {
+        this->table = std::make_shared<EndgameTable>();
+    }
+}
+
+std::uint64_t EndgameSolver::canonicalKey(const GameState& state, bool first) {
+    std::uint64_t lanes = 0;
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        const Card& enemy = state.enemyCards[slot];
+        const Card& player = state.playerCards[slot];
+        if (!enemy.isBlank() || !player.isBlank()) {
+            lanes += Rng::mix(GameState::slotKey(false, 0, enemy) ^ Rng::mix(GameState::slotKey(true, 0, player) + 1));
+        }
+    }
+    return Zobrist::key(28, lanes) ^ Zobrist::healthKey(true, state.playerHealth) ^ Zobrist::healthKey(false, state.enemyHealth)
+        ^ Rng::mix(state.hash.piles) ^ (first ? Zobrist::firstKey : 0);
+}
+
+std::uint64_t EndgameSolver::hiddenKey(std::uint64_t key, Stage stage, int rounds) const {
+    const bool dealt = rounds < this->hiddenRounds || (rounds == this->hiddenRounds && stage == BLOCK);
+    return this->hiddenCards > Director::maxCards && !dealt ? key ^ Zobrist::key(31, this->hiddenCards) : key;
+}
+
+bool EndgameSolver::probe(std::uint64_t key, int rounds, float& alpha, float& beta, float& value) {
+    EndgameEntry entry;
+    if (!this->table->probe(key, entry) || entry.rounds < rounds) {
+        return false;
+    }
+    if (entry.rounds != EndgameEntry::completeRounds) {
+        this->hitHorizon = true;
+    }
+    if (entry.bound == EndgameEntry::LOWER) {
+        alpha = std::max(alpha, entry.value);
+    }
+    else if (entry.bound == EndgameEntry::UPPER) {
+        beta = std::min(beta, entry.value);
+    }
+    if (entry.bound == EndgameEntry::EXACT || alpha >= beta) {
+        this->own.tableHits++;
+        value = entry.value;
+        return true;
+    }
+    return false;
+}
+
+void EndgameSolver::store(std::uint64_t key, int rounds, float value, float alpha, float beta) {
+    EndgameEntry entry;
+    entry.value = value;
+    entry.rounds = static_cast<std::int8_t>(this->hitHorizon ? rounds : EndgameEntry::completeRounds);
+    entry.bound = value <= alpha ? EndgameEntry::UPPER : value >= beta ? EndgameEntry::LOWER : EndgameEntry::EXACT;
+    this->table->store(key, entry);
+}
+
+void EndgameSolver::assignments(const GameState& state, bool first, bool isPlayer, std::vector<Assignment>& list) const {
+    const Hand& hand = state.hand(isPlayer);
+    const Card* own = state.cards(isPlayer);
+    const Card* opposite = state.cards(!isPlayer);
+    const bool attacking = isPlayer == first;
+
+    // The card IDs the side can place somewhere, with their copies, in CardID order so the hand's order doesn't matter
+    int held[CARD_COUNT] = {};
+    for (int i = 0; i < hand.size(); i++) {
+        held[hand[i]]++;
+    }
+    CardID ids[CARD_COUNT];
+    int counts[CARD_COUNT];
+    std::uint8_t masks[CARD_COUNT];
+    int idCount = 0;
+    for (int id = 0; id < CARD_COUNT; id++) {
+        std::uint8_t slots = held[id] > 0 ? legalSlots(state, first, isPlayer, static_cast<CardID>(id)) : 0;
+        if (slots != 0) {
+            ids[idCount] = static_cast<CardID>(id);
+            counts[idCount] = held[id];
+            masks[idCount++] = slots;
+        }
+    }
+
+    // A slot that looks like an earlier one takes a choice no lower than it, so each way of filling alike lanes is listed once
+    int twin[GameState::slotCount];
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        twin[slot] = -1;
+        for (int earlier = 0; earlier < slot; earlier++) {
+            if (own[slot].isBlank() && own[earlier].isBlank() && opposite[slot] == opposite[earlier]) {
+                twin[slot] = earlier;
+            }
+        }
+    }
+
+    int choices[GameState::slotCount]; // 0 for none, i + 1 for ids[i]
+    auto enumerate = [&](auto& self, int slot) -> void {
+        if (slot == GameState::slotCount) {
+            Assignment assignment;
+            assignment.score = 0;
+            for (int s = 0; s < GameState::slotCount; s++) {
+                assignment.ids[s] = static_cast<std::int8_t>(choices[s] > 0 ? ids[choices[s] - 1] : BLANK);
+                if (choices[s] == 0) {
+                    continue;
+                }
+                const CardType& type = getCardType(ids[choices[s] - 1]);
+                // Attack: the most damage, preferably unblocked. Defense: the biggest threats blocked with the sturdiest cards
+                assignment.score += attacking ? type.attack * (opposite[s].isBlank() ? 2 : 1)
+                    : 4 * opposite[s].attack + 2 * type.defense + type.maxHealth;
+            }
+            list.push_back(assignment);
+            return;
+        }
+        const int lowest = twin[slot] >= 0 ? choices[twin[slot]] : 0;
+        for (int choice = lowest; choice <= idCount; choice++) {
+            if (choice > 0 && (counts[choice - 1] == 0 || !((masks[choice - 1] >> slot) & 1))) {
+                continue;
+            }
+            choices[slot] = choice;
+            if (choice > 0) {
+                counts[choice - 1]--;
+            }
+            self(self, slot + 1);
+            if (choice > 0) {
+                counts[choice - 1]++;
+            }
+        }
+    };
+    list.clear();
+    enumerate(enumerate, 0);
+    std::stable_sort(list.begin(), list.end(), [](const Assignment& a, const Assignment& b) { return a.score > b.score; });
+}
+
+TurnPlan EndgameSolver::toPlan(const GameState& state, bool isPlayer, const Assignment& assignment) const {
+    const Hand& hand = state.hand(isPlayer);
+    bool used[Hand::capacity] = {};
+    int handIndices[GameState::slotCount];
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        handIndices[slot] = -1;
+        for (int i = 0; i < hand.size() && assignment.ids[slot] != BLANK; i++) {
+            if (!used[i] && hand[i] == assignment.ids[slot]) {
+                used[i] = true;
+                handIndices[slot] = i;
+                break;
+            }
+        }
+    }
+    return orderPlacements(state, isPlayer, handIndices);
+}
+
+float EndgameSolver::round(GameState& state, bool first, int rounds) {
+    const std::uint64_t key = this->hiddenKey(canonicalKey(state, first) ^ Zobrist::key(29, ROUND), ROUND, rounds);
+    float alpha = below;
+    float beta = above;
+    float value;
+    if (this->probe(key, rounds, alpha, beta, value)) {
+        return value;
+    }
+    bool horizonAbove = this->hitHorizon;
+    this->hitHorizon = false;
+    value = this->draw(state, first, ROUND, rounds, below, above);
+    if (this->aborted) {
+        return 0.0f;
+    }
+    this->store(key, rounds, value, below, above);
+    this->hitHorizon = this->hitHorizon || horizonAbove;
+    return value;
+}
+
+float EndgameSolver::draw(GameState& state, bool first, Stage stage, int rounds, float alpha, float beta) {
+    const bool side = stage == ROUND ? first : !first;
+    const Stage next = stage == ROUND ? ATTACK : BLOCK;
+    const int dealt = stage == DRAW && side == this->hiddenSide && rounds == this->hiddenRounds
+        ? std::max(Director::maxCards, this->hiddenCards) : Director::maxCards;
+    const int draws = std::min(std::max(0, dealt - state.hand(side).size()), state.deck(side).size());
+    if (draws == 0) {
+        return this->turn(state, first, next, rounds, alpha, beta);
+    }
+
+    std::vector<Outcome> outcomes;
+    drawOutcomes(state.deck(side), draws, outcomes);
+    if (rounds == 1) {
+        mergeOutcomes(state, first, side, outcomes);
+    }
+
+    // Star1: the outcomes not seen yet are worth between 0 and 1, which bounds the node after each outcome
+    double sum = 0.0;
+    double remaining = 1.0;
+    for (const Outcome& outcome : outcomes) {
+        remaining = std::max(0.0, remaining - outcome.probability);
+        const double childAlpha = (alpha - sum - remaining) / outcome.probability;
+        const double childBeta = (beta - sum) / outcome.probability;
+
+        GameState dealt = state;
+        dealOutcome(dealt, side, outcome);
+        float value = this->turn(dealt, first, next, rounds, static_cast<float>(std::max(childAlpha, static_cast<double>(below))),
+            static_cast<float>(std::min(childBeta, static_cast<double>(above))));
+        if (this->aborted) {
+            return 0.0f;
+        }
+        sum += outcome.probability * value;
+        if (value <= childAlpha) {
+            return static_cast<float>(sum + remaining); // At most alpha
+        }
+        if (value >= childBeta) {
+            return static_cast<float>(sum); // At least beta
+        }
+    }
+    return static_cast<float>(sum);
+}
+
+float EndgameSolver::turn(GameState& state, bool first, Stage stage, int rounds, float alpha, float beta) {
+    if (this->nodes > this->config.maxNodes) {
+        this->aborted = true;
+    }
+    if (this->aborted) {
+        return 0.0f;
+    }
+
+    // Solving one round, no two lines reach the same turn and nothing is worth keeping. Solving more, the turns of a round meet again
+    // from the different turns of the round before, the last round's blocks included
+    const bool kept = this->config.rounds > 1;
+    const std::uint64_t key = this->hiddenKey(canonicalKey(state, first) ^ Zobrist::key(29, stage), stage, rounds);
+    float value;
+    if (kept && this->probe(key, rounds, alpha, beta, value)) {
+        return value;
+    }
+
+    const bool side = stage == ATTACK ? first : !first;
+    std::vector<Assignment> list;
+    this->assignments(state, first, side, list);
+
+    bool horizonAbove = this->hitHorizon;
+    this->hitHorizon = false;
+    const float alphaBefore = alpha;
+    const float betaBefore = beta;
+    const bool maximizing = side; // Values are the player's
+    float best = maximizing ? below : above;
+    for (const Assignment& assignment : list) {
+        float child = stage == BLOCK && rounds == 1 ? this->lastAssault(state, first, assignment)
+            : this->play(state, first, stage, rounds, assignment, alpha, beta);
+        if (this->aborted) {
+            return 0.0f;
+        }
+        best = maximizing ? std::max(best, child) : std::min(best, child);
+        if (maximizing) {
+            alpha = std::max(alpha, best);
+        }
+        else {
+            beta = std::min(beta, best);
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    if (kept) {
+        this->store(key, rounds, best, alphaBefore, betaBefore);
+    }
+    this->hitHorizon = this->hitHorizon || horizonAbove;
+    return best;
+}
+
+float EndgameSolver::lastAssault(const GameState& state, bool first, const Assignment& assignment) {
+    this->nodes++;
+    Card playerCards[GameState::slotCount];
+    Card enemyCards[GameState::slotCount];
+    std::copy(state.playerCards, state.playerCards + GameState::slotCount, playerCards);
+    std::copy(state.enemyCards, state.enemyCards + GameState::slotCount, enemyCards);
+
+    // Placed in orderPlacements' order, INSPIRE/RALLY last, with applyMove's buffs
+    Card* own = first ? enemyCards : playerCards;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int slot = 0; slot < GameState::slotCount; slot++) {
+            if (assignment.ids[slot] == BLANK || getCardType(static_cast<CardID>(assignment.ids[slot])).has(FLAG_INSPIRE) != (pass == 1)) {
+                continue;
+            }
+            own[slot] = Card(static_cast<CardID>(assignment.ids[slot]));
+            for (int i = 0; i < GameState::slotCount && pass == 1; i++) {
+                playerCards[i].attack += playerCards[i].isBlank() ? 0 : 1;
+            }
+        }
+    }
+
+    AssaultLanes lanes;
+    for (int i = 0; i < AssaultLanes::width; i++) {
+        const bool inBoard = i < GameState::slotCount;
+        packLane(lanes, i, inBoard && !playerCards[i].isBlank() ? &playerCards[i] : nullptr, inBoard && !enemyCards[i].isBlank() ? &enemyCards[i] : nullptr);
+    }
+    resolveAssault(lanes);
+    int playerHealth = state.playerHealth;
+    int enemyHealth = state.enemyHealth;
+    for (int i = 0; i < GameState::slotCount; i++) {
+        playerHealth -= lanes.faceDamageToPlayer[i];
+        enemyHealth -= lanes.faceDamageToEnemy[i];
+    }
+    this->hitHorizon = this->hitHorizon || (playerHealth > 0 && enemyHealth > 0);
+    return scoreHealth(playerHealth, enemyHealth);
+}
+
+float EndgameSolver::play(GameState& state, bool first, Stage stage, int rounds, const Assignment& assignment, float alpha, float beta) {
+    this->nodes++;
+    const bool side = stage == ATTACK ? first : !first;
+    TurnPlan plan = this->toPlan(state, side, assignment);
+    int applied = 0;
+    while (applied < plan.count && applyMove(state, first, plan.moves[applied], this->undo)) {
+        applied++;
+    }
+
+    float value;
+    bool isRunning = false;
+    if (stage == ATTACK) {
+        value = this->draw(state, first, DRAW, rounds, alpha, beta);
+    }
+    else if (!applyAssault(state, this->undo, isRunning)) {
+        this->aborted = true; // More rounds than the undo stack holds: the decision is left to the fallback
+        value = 0.0f;
+    }
+    else {
+        if (isRunning && rounds > 1) {
+            value = this->round(state, !first, rounds - 1);
+        }
+        else {
+            this->hitHorizon = this->hitHorizon || isRunning;
+            value = scoreState(state, true);
+        }
+        undoAssault(state, this->undo);
+    }
+
+    for (int i = 0; i < applied; i++) {
+        undoMove(state, this->undo);
+    }
+    return value;
+}
+
+TurnPlan EndgameSolver::plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) {
+    Clock::time_point startTime = Clock::now();
+    TurnPlan plan;
+    plan.complete = false;
+    bool solved = false;
+    if (this->isEndgame(state)) {
+        // What the side can't see of the opponent's hand is dealt again from its deck, by its first draw: in this round if the side attacks,
+        // in the next one if it blocks
+        GameState root = state;
+        const Stage stage = isPlayer == first ? ATTACK : BLOCK;
+        this->hiddenSide = !isPlayer;
+        this->hiddenRounds = stage == ATTACK ? this->config.rounds : this->config.rounds - 1;
+        this->hiddenCards = root.hand(!isPlayer).size();
+        const bool pooled = poolHand(root, !isPlayer);
+
+        this->nodes = 0;
+        this->aborted = false;
+        this->hitHorizon = false;
+        this->undo.clear();
+        std::vector<Assignment> list;
+        this->assignments(root, first, isPlayer, list);
+
+        // Decisions are kept with their best turn, under the exact position: lanes in another order would list the turns in another order
+        const std::uint64_t key = this->hiddenKey(root.zobrist(first) ^ Zobrist::key(30, stage), stage, this->config.rounds);
+        // A deck too full to take the hand back would leave the solver seeing cards the side can't: the turn goes to the fallback then
+        EndgameEntry entry;
+        if (pooled && this->table->probe(key, entry) && entry.rounds >= this->config.rounds && entry.move < list.size()) {
+            this->own.tableHits++;
+            solved = true;
+        }
+        else if (pooled) {
+            // The root is searched move by move, so the best turn is known, not only its value
+            float best = isPlayer ? below : above;
+            entry.move = 0;
+            for (int i = 0; i < static_cast<int>(list.size()) && !this->aborted; i++) {
+                float value = this->play(root, first, stage, this->config.rounds, list[i], isPlayer ? best : below, isPlayer ? above : best);
+                if (!this->aborted && (isPlayer ? value > best : value < best)) {
+                    best = value;
+                    entry.move = static_cast<std::uint16_t>(i);
+                }
+            }
+            solved = !this->aborted && !list.empty();
+            if (solved) {
+                entry.value = best;
+                entry.rounds = static_cast<std::int8_t>(this->hitHorizon ? this->config.rounds : EndgameEntry::completeRounds);
+                entry.bound = EndgameEntry::EXACT;
+                this->table->store(key, entry);
+            }
+        }
+        if (solved) {
+            plan = this->toPlan(state, isPlayer, list[entry.move]);
+        }
+        this->own.nodes += this->nodes;
+        this->own.endgame += solved;
+    }
+
+    this->own.seconds += std::chrono::duration<double>(Clock::now() - startTime).count();
+    if (!solved && this->fallback) {
+        plan = this->fallback->plan(state, first, isPlayer, seed);
+    }
+    else {
+        this->own.decisions++;
+    }
+    this->totals = this->fallback ? this->fallback->getTotals() : PlannerStats();
+    this->totals.merge(this->own);
+    return plan;
+}
@@ -0,0 +1,180 @@
+/*
+Endgame.hpp defines the endgame solver: once both sides are low on health, it solves the rest of the game exactly instead of searching it.
+It is an expectiminimax over whole turns, with the draws as chance nodes whose outcomes are every multiset of cards the shuffled deck can deal,
+weighted by their hypergeometric odds. Values are kept in an EndgameTable keyed by a canonical hash of the position, which can be saved to disk
+and loaded again, so the table grows over runs and positions solved before cost a lookup. The default depth is two rounds, the shallowest at
+which different lines reach the same turns, so the canonical table is used.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Game.hpp"
+#include "Moves.hpp"
+#include "Planner.hpp"
+
+/**
+ * @brief EndgameConfig sets when the solver takes over and how far it solves.
+ * Decks never run low in this game (dead cards go back to the bottom), so the thresholds are on health, and the work is bounded by rounds and maxNodes.
+ */
+typedef struct EndgameConfig {
+    int totalHealth = 16; // Solve when the health of both sides adds up to at most this
+    // Rounds solved, the current one included. Lines still running after that are scored with scoreState (see Playout.hpp).
+    // Turns are kept in the table under canonicalKey from two rounds on; solving one round only keeps the decisions, under their exact position
+    int rounds = 2;
+    long long maxNodes = 400000; // Give the decision up (and leave it to the fallback) after this many nodes
+} EndgameConfig;
+
+/**
+ * @brief EndgameEntry is what the table stores about a position: its value for the player (1 win, 0.5 draw, 0 loss, see scoreState)
+ * and how it was solved. Packs into 64 bits.
+ */
+typedef struct EndgameEntry {
+    enum Bound : std::uint8_t {
+        EXACT,
+        LOWER, // The true value is at least value
+        UPPER, // The true value is at most value
+    };
+
+    float value = 0.0f;
+    std::int8_t rounds = 0; // Rounds solved, or completeRounds when every line ended within them
+    Bound bound = EXACT;
+    std::uint16_t move = 0; // Decisions only: the best turn, as an index into the solver's list of turns
+
+    static const std::int8_t completeRounds = 127;
+} EndgameEntry;
+
+static_assert(sizeof(EndgameEntry) == sizeof(std::uint64_t), "An EndgameEntry must pack into one 64-bit word");
+
+/**
+ * @brief EndgameFileHeader starts a saved table. It is followed by count EndgameRecords.
+ */
+typedef struct EndgameFileHeader {
+    char magic[4]; // "RLSG"
+    std::uint32_t version;
+    std::uint64_t rules; // EndgameTable::rulesHash of the card set the values were solved with
+    std::uint64_t count;
+    std::uint64_t checksum; // FNV-1a of the records
+} EndgameFileHeader;
+
+typedef struct EndgameRecord {
+    std::uint64_t key;
+    EndgameEntry entry;
+} EndgameRecord;
+
+static_assert(sizeof(EndgameFileHeader) == 32 && sizeof(EndgameRecord) == 16, "The file layout must not depend on the compiler");
+
+/**
+ * @brief EndgameTable holds solved positions, shared by every solver of a run. Access is serialised by a mutex: the solver only probes it
+ * once per turn and per round, far less often than a search probes its transposition table.
+ */
+class EndgameTable {
+public:
+    // Bump whenever the file layout, the keys or the meaning of a value change, so old files are ignored
+    static const std::uint32_t version = 2;
+
+    // At most maxEntries positions are kept. Once full, new positions are solved but not stored
+    explicit EndgameTable(std::size_t maxEntries = 1 << 22) : maxEntries(maxEntries) {}
+
+    EndgameTable(const EndgameTable&) = delete;
+    EndgameTable& operator=(const EndgameTable&) = delete;
+
+    bool probe(std::uint64_t key, EndgameEntry& entry) const;
+    // Keeps the entry solved over more rounds when the key is already stored
+    void store(std::uint64_t key, const EndgameEntry& entry);
+    std::size_t size() const;
+
+    /**
+     * @brief load adds the positions saved at path. A missing file is an empty table; a damaged one, or one solved with other card definitions,
+     * is reported and ignored.
+     * @return Whether positions were loaded.
+     */
+    bool load(const std::string& path);
+
+    // Writes every position to path, through a temporary file so a crash never leaves half a table behind
+    bool save(const std::string& path) const;
+
+    // Hash of the card stats and hand size the values depend on. Deck contents are part of every key
+    static std::uint64_t rulesHash();
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::uint64_t, EndgameEntry> entries;
+    std::size_t maxEntries;
+};
+
+/**
+ * @brief EndgameSolver plans turns in the endgame and leaves the others to a fallback planner (or to the script, with an empty incomplete plan).
+ * A turn is chosen as a whole: one card (or none) per slot, lanes that look alike taken as interchangeable, played in orderPlacements' order.
+ * The opponent's unseen hand is pooled with its deck, so the solver plays for the best expected value over what it may hold. Its next draw
+ * deals it as many cards as it held, even past Director::maxCards after a REINFORCE.
+ * From the following round on, both sides are assumed to see each other's hands. Alpha-beta prunes the turns, and chance nodes are pruned
+ * with the same window, the values being bounded by 0 and 1 (Ballard's Star1).
+ */
+class EndgameSolver : public TurnPlanner {
+public:
+    EndgameSolver(const EndgameConfig& config, std::shared_ptr<EndgameTable> table, std::shared_ptr<TurnPlanner> fallback = nullptr);
+
+    TurnPlan plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) override;
+
+    // Whether state is an endgame under config
+    bool isEndgame(const GameState& state) const { return state.health(true) + state.health(false) <= this->config.totalHealth; }
+
+    /**
+     * @brief canonicalKey hashes a position so that positions differing only in the order of their lanes hash alike: every rule applies lane by lane,
+     * so lanes are hashed without their index and added up, like the cards of a hand.
+     */
+    static std::uint64_t canonicalKey(const GameState& state, bool first);
+
+private:
+    // Where in the round a node is. The assault follows BLOCK
+    enum Stage : std::uint8_t {
+        ROUND, // Both sides still draw
+        ATTACK, // The attacker has drawn and places
+        DRAW, // The attacker has placed, the defender draws
+        BLOCK, // The defender has drawn and places
+    };
+
+    // One card ID (or -1) per slot
+    typedef struct Assignment {
+        std::int8_t ids[GameState::slotCount];
+        int score; // Move ordering, best for the side first
+    } Assignment;
+
+    float round(GameState& state, bool first, int rounds);
+    float turn(GameState& state, bool first, Stage stage, int rounds, float alpha, float beta);
+    // The defender draws (stage DRAW), or the attacker at the start of a round (stage ROUND), then places
+    float draw(GameState& state, bool first, Stage stage, int rounds, float alpha, float beta);
+    // The value after the side of stage plays assignment
+    float play(GameState& state, bool first, Stage stage, int rounds, const Assignment& assignment, float alpha, float beta);
+    // The player's value after the defender plays assignment and the round's assault, when no round follows. Works on a copy of the board
+    float lastAssault(const GameState& state, bool first, const Assignment& assignment);
+    // Every turn of side isPlayer, in an order that only depends on the position
+    void assignments(const GameState& state, bool first, bool isPlayer, std::vector<Assignment>& list) const;
+    TurnPlan toPlan(const GameState& state, bool isPlayer, const Assignment& assignment) const;
+    // Tells the nodes reached before the opponent's hand is dealt again apart, when it is dealt more cards than a draw deals
+    std::uint64_t hiddenKey(std::uint64_t key, Stage stage, int rounds) const;
+    bool probe(std::uint64_t key, int rounds, float& alpha, float& beta, float& value);
+    void store(std::uint64_t key, int rounds, float value, float alpha, float beta);
+
+    EndgameConfig config;
+    std::shared_ptr<EndgameTable> table;
+    std::shared_ptr<TurnPlanner> fallback;
+    UndoStack undo;
+
+    // The decision being solved
+    long long nodes = 0;
+    bool aborted = false;
+    bool hitHorizon = false; // Some line was still running after config.rounds, so results are only good for that many rounds
+    // The opponent's hand, pooled at the root, is dealt again by its draw in round hiddenRounds (counted like rounds), however many cards it held
+    bool hiddenSide = false;
+    int hiddenRounds = 0;
+    int hiddenCards = 0;
+    PlannerStats own; // The solver's share of totals
+};
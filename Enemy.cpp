@@ -1,14 +1,18 @@
 // Enemy.cpp
 #include "Enemy.hpp"
-#include <iostream>
+#include "Events.hpp"
 
 #include "Game.hpp"
+#include "Moves.hpp"
 
 void EnemyAI::turn() {
     // Draw up to hand limit
     game->drawCards(false);
 
-    if (!first) {
+    if (planner) {
+        plannedTurn();
+    }
+    else if (!first) {
         attack();
     }
     else {
@@ -16,62 +20,81 @@ void EnemyAI::turn() {
     }
 }
 
-void EnemyAI::attack() {
+void EnemyAI::plannedTurn() {
+    TurnPlan plan = planner->plan(game->getState(), first, false, rng.next());
+    for (int i = 0; i < plan.count; i++) {
+        game->playCard(false, plan.moves[i].handIndex, plan.moves[i].slot);
+    }
+    if (!plan.complete) {
+        // The search didn't get that far: finish the turn with the script
+        int fromSlot = plan.count > 0 ? plan.moves[plan.count - 1].slot + 1 : 0;
+        if (!first) {
+            attack(fromSlot);
+        }
+        else {
+            defend(fromSlot);
+        }
+    }
+}
+
+void EnemyAI::attack(int fromSlot) {
+    if (attackPlanning && fromSlot == 0) {
+        // A proven win first, then the most expected damage
+        LethalCheck lethal = checkLethal(game->getState(), first, counter);
+        TurnPlan plan = lethal.won ? lethal.plan : planAttack(game->getState(), first, false, counter, attackModel).plan;
+        for (int i = 0; i < plan.count; i++) {
+            game->playCard(false, plan.moves[i].handIndex, plan.moves[i].slot);
+        }
+        return;
+    }
+
     // Fill every empty attack slot
-    for (int pos = 0; pos < cards.size(); ++pos) {
+    for (int pos = fromSlot; pos < GameState::slotCount; ++pos) {
 
-        if (cards[pos] != nullptr) {
+        if (!cards[pos].isBlank()) {
             // This slot is already filled
             continue;
         }
 
-        // Only attack 3/4 of the time
-        if (rand() % 5 == 0) {
-            std::cout << "Enemy skips attacking slot " << pos + 1 << "\n";
+        // Leave some slots empty (one in five with the default profile)
+        if (EnemyProfile::skip(rng, profile.attackSkip)) {
+            logEvent<EventCode::SLOT_SKIPPED>(false, pos, -1, 0);
             continue;
         }
 
-        // Keep trying to play into this pos until either it's full or no playable cards remain
-        while (cards[pos] == nullptr) {
-
-            bool played = false;
-            for (int i = 0; i < hand.size(); ++i) {
-                Card* c = hand[i];
-                // Skip cards that can't attack
-                if (c->getType().condition == DEFENSE_ONLY)
-                    continue;
-                if (game->playCard(false, i, pos)) {
-                    std::cout << "Enemy plays "
-                        << c->getType().name
-                        << " at slot " << pos + 1 << "\n";
-                    played = true;
-                    break;
-                }
-            }
-            if (!played) break;  // no more valid plays for this slot
+        // Play the preferred card in hand that can attack from this pos (the first one with the default profile)
+        int card = chooseCard(game->getState(), first, false, pos, profile);
+        if (card >= 0) {
+            game->playCard(false, card, pos);
         }
     }
 }
 
-void EnemyAI::defend() {
+void EnemyAI::defend(int fromSlot) {
+    if (blocking && fromSlot == 0) {
+        TurnPlan plan = planBlocking(game->getState(), first, false, blockingWeights);
+        for (int i = 0; i < plan.count; i++) {
+            game->playCard(false, plan.moves[i].handIndex, plan.moves[i].slot);
+        }
+        return;
+    }
+
     // Block most incoming attackers
-    for (int pos = 0; pos < playerCards.size(); pos++) {
-        if (playerCards[pos] == nullptr && cards[pos] != nullptr) {
+    for (int pos = fromSlot; pos < GameState::slotCount; pos++) {
+        if (playerCards[pos].isBlank() && !cards[pos].isBlank()) {
             // No need to defend if there's no attacker
             continue;
         }
 
-        // Only defend 4/5 of the time
-        if (rand() % 5 == 0) {
-            std::cout << "Enemy skips defending slot " << pos + 1 << "\n";
+        // Only defend 4/5 of the time with the default profile
+        if (EnemyProfile::skip(rng, profile.defenseSkip)) {
+            logEvent<EventCode::SLOT_SKIPPED>(false, pos, -1, 1);
             continue;
         }
-        for (int i = 0; i < hand.size(); ++i) {
-            if (game->playCard(false, i, pos)) {
-                std::cout << "Enemy defends slot " << pos + 1
-                    << " with " << hand[i]->getType().name << "\n";
-                break;
-            }
+        // Block with the preferred card in hand that is allowed to
+        int card = chooseCard(game->getState(), first, false, pos, profile);
+        if (card >= 0) {
+            game->playCard(false, card, pos);
         }
     }
 }
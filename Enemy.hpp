@@ -3,26 +3,83 @@ This file defines the Enemy AI for the game. The AI is responsible for making de
 */
 #pragma once
 
+#include <memory>
+
 #include "Game.hpp"
+#include "Planner.hpp"
+#include "MonteCarlo.hpp"
+#include "AlphaBeta.hpp"
+#include "Profile.hpp"
+#include "Blocking.hpp"
+#include "AttackPlan.hpp"
+#include "Lethal.hpp"
+#include "Endgame.hpp"
 
 class EnemyAI {
 public:
-    EnemyAI(Director* game) : game(game),
+    EnemyAI(Director* game) : EnemyAI(game, game->getPolicyRng()) {}
+
+    // rng is the stream the AI draws its random choices from. By default it is the Director's policy stream.
+    EnemyAI(Director* game, Rng& rng) : game(game),
         cards(game->getEnemyCards()),
         playerCards(game->getPlayerCards()),
-        hand(game->getEnemyHand()),
-        first(game->first)  // Reference to the first turn
+        first(game->first),  // Reference to the first turn
+        rng(rng),
+        profile(activeProfile) // The difficulty picked at startup
     {
     }
+    ~EnemyAI() {
+        if (this->attackPlanning) {
+            this->game->setCounter(nullptr);
+        }
+    }
 
     void turn();
-    void attack();
-    void defend();
+    // The scripted behaviour. fromSlot lets a plan that stopped early be finished by it
+    void attack(int fromSlot = 0);
+    void defend(int fromSlot = 0);
+
+    /**
+     * @brief usePlanner makes turn() play the turns planner plans instead of following the script.
+     */
+    void usePlanner(std::shared_ptr<TurnPlanner> planner) { this->planner = std::move(planner); }
+    // Monte Carlo Tree Search (see MonteCarlo.hpp)
+    void useMonteCarlo(const MonteCarloConfig& config) { this->usePlanner(std::make_shared<MonteCarloSearch>(config)); }
+    // Expectimax with alpha-beta over the current round (see AlphaBeta.hpp)
+    void useAlphaBeta(const AlphaBetaConfig& config) { this->usePlanner(std::make_shared<AlphaBetaSearch>(config)); }
+    void useScript() { this->planner.reset(); }
+    // Solve endgames exactly (see Endgame.hpp), and leave the other turns to the planner set so far, or to the script
+    void useEndgameSolver(const EndgameConfig& config, std::shared_ptr<EndgameTable> table) {
+        this->usePlanner(std::make_shared<EndgameSolver>(config, std::move(table), this->planner));
+    }
+    // Defend with the blocking solver (see Blocking.hpp) instead of the script. The defense skip rate and the preferences no longer apply to blocks
+    void useBlockingSolver(const BlockingWeights& weights = BlockingWeights()) { this->blocking = true; this->blockingWeights = weights; }
+    // Attack with the attack planner (see AttackPlan.hpp), or a proven win (see Lethal.hpp), instead of the script. The attack skip rate and the preferences no longer apply to attacks.
+    // The AI counts the player's cards from then on (see CardCounting.hpp)
+    void useAttackPlanner(const AttackModel& model = AttackModel()) {
+        this->attackPlanning = true;
+        this->attackModel = model;
+        this->game->setCounter(&this->counter);
+    }
+    // The parameters of the script (skip rates, card preferences, held back cards)
+    void setProfile(const EnemyProfile& profile) { this->profile = profile; }
+    const EnemyProfile& getProfile() const { return this->profile; }
+    const TurnPlanner* getPlanner() const { return this->planner.get(); }
 
 private:
+    // Plays the turn the planner plans
+    void plannedTurn();
+
     Director* game;
-    const std::vector<Card*>& cards;
-    const std::vector<Card*>& playerCards; // Player's assault cards
-    const std::vector<Card*>& hand;
+    const Card* cards; // Points into the Director's GameState
+    const Card* playerCards; // Player's assault cards
     const bool& first;
+    Rng& rng;
+    std::shared_ptr<TurnPlanner> planner; // Null when the AI follows the script
+    EnemyProfile profile;
+    bool blocking = false;
+    BlockingWeights blockingWeights;
+    bool attackPlanning = false;
+    AttackModel attackModel;
+    CardCounter counter; // Attached to the Director while the attack planner is in use
 };
\ No newline at end of file
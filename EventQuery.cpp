@@ -0,0 +1,346 @@
+#include "EventQuery.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "Arguments.hpp"
+#include "CardDatabase.hpp"
+
+
+namespace {
+    const char* const columnNames[] = { "game", "round", "code", "side", "slot", "card", "a", "b" };
+    static_assert(sizeof(columnNames) / sizeof(columnNames[0]) == COLUMN_COUNT, "Every EventColumn needs a name");
+
+    unsigned bit(EventColumn column) {
+        return 1u << column;
+    }
+
+    // A value of column the way the event log prints it: names for codes, cards and sides, slots from 1
+    std::string describe(int column, std::int64_t value) {
+        switch (column) {
+        case COLUMN_CODE: return eventCodeName(static_cast<EventCode>(value));
+        case COLUMN_SIDE: return value ? "player" : "enemy";
+        case COLUMN_SLOT: return value < 0 ? "none" : std::to_string(value + 1);
+        case COLUMN_CARD: return value < 0 ? "none" : CardDatabase::identifier(static_cast<CardID>(value));
+        default: return std::to_string(value);
+        }
+    }
+
+    // A KAMIKAZE ability waiting for the CARD_DAMAGED event of the card it destroys
+    typedef struct PendingKamikaze {
+        bool active = false;
+        std::int64_t game = 0;
+        std::int64_t round = 0;
+        std::int64_t slot = 0;
+        int card = 0;
+    } PendingKamikaze;
+}
+
+bool EventFilter::matches(const EventChunk& chunk, int row) const {
+    return (this->code < 0 || chunk.columns[COLUMN_CODE][row] == this->code)
+        && (this->side < 0 || chunk.columns[COLUMN_SIDE][row] == this->side)
+        && (this->slot < 0 || chunk.columns[COLUMN_SLOT][row] == this->slot)
+        && (this->card < 0 || chunk.columns[COLUMN_CARD][row] == this->card);
+}
+
+void QueryResult::merge(const QueryResult& other) {
+    this->files += other.files;
+    this->chunks += other.chunks;
+    this->bytes += other.bytes;
+    this->rows += other.rows;
+    this->games += other.games;
+    for (int i = 0; i < static_cast<int>(EventCode::COUNT); i++) {
+        this->codes[i] += other.codes[i];
+    }
+    this->damaged = this->damaged || other.damaged;
+    this->matches += other.matches;
+    for (const auto& [value, count] : other.groups) {
+        this->groups[value] += count;
+    }
+    this->kamikazes += other.kamikazes;
+    this->tradesUp += other.tradesUp;
+    this->tradesEven += other.tradesEven;
+    this->tradesDown += other.tradesDown;
+    for (int i = 0; i < CARD_COUNT; i++) {
+        this->victims[i] += other.victims[i];
+    }
+}
+
+int EventQuery::statTotal(int card) {
+    if (card < 0 || card >= CARD_COUNT) {
+        return 0;
+    }
+    const CardType& type = getCardType(static_cast<CardID>(card));
+    return type.maxHealth + type.attack + type.defense;
+}
+
+void EventQuery::scan(const std::string& path, QueryResult& result) const {
+    EventTableReader reader;
+    result.files++;
+    if (!reader.open(path)) {
+        result.damaged = true;
+        return;
+    }
+    result.bytes += static_cast<long long>(reader.getBytes());
+    result.rows += reader.getRows();
+    result.chunks += reader.getChunkCount();
+    // The chunks before a cut are still scanned, but the result is reported as partial
+    result.damaged = result.damaged || !reader.isComplete();
+
+    unsigned mask = bit(COLUMN_CODE);
+    if (this->config.kind == QUERY_SUMMARY) {
+        mask |= bit(COLUMN_GAME);
+    }
+    else if (this->config.kind == QUERY_COUNT) {
+        mask |= bit(COLUMN_SIDE) | bit(COLUMN_SLOT) | bit(COLUMN_CARD);
+        if (this->config.groupBy >= 0) {
+            mask |= 1u << this->config.groupBy;
+        }
+    }
+    else {
+        mask |= bit(COLUMN_GAME) | bit(COLUMN_ROUND) | bit(COLUMN_SIDE) | bit(COLUMN_SLOT) | bit(COLUMN_CARD) | bit(COLUMN_A);
+    }
+
+    // Games and pending abilities carry over from one chunk to the next
+    std::int64_t lastGame = -1;
+    PendingKamikaze pending[2];
+    EventChunk chunk;
+    for (int index = 0; index < reader.getChunkCount(); index++) {
+        if (!reader.readChunk(index, mask, chunk)) {
+            result.damaged = true;
+            break;
+        }
+        const std::int64_t* codes = chunk.column(COLUMN_CODE);
+        for (int row = 0; row < chunk.rows; row++) {
+            if (codes[row] >= 0 && codes[row] < static_cast<int>(EventCode::COUNT)) {
+                result.codes[codes[row]]++;
+            }
+        }
+
+        switch (this->config.kind) {
+        case QUERY_SUMMARY: {
+            const std::int64_t* games = chunk.column(COLUMN_GAME);
+            for (int row = 0; row < chunk.rows; row++) {
+                result.games += games[row] != lastGame;
+                lastGame = games[row];
+            }
+            break;
+        }
+        case QUERY_COUNT: {
+            const std::int64_t* groups = this->config.groupBy >= 0 ? chunk.column(static_cast<EventColumn>(this->config.groupBy)) : nullptr;
+            for (int row = 0; row < chunk.rows; row++) {
+                if (this->config.filter.matches(chunk, row)) {
+                    result.matches++;
+                    if (groups) {
+                        result.groups[groups[row]]++;
+                    }
+                }
+            }
+            break;
+        }
+        case QUERY_KAMIKAZE:
+            for (int row = 0; row < chunk.rows; row++) {
+                EventCode code = static_cast<EventCode>(codes[row]);
+                int side = static_cast<int>(chunk.columns[COLUMN_SIDE][row]) != 0;
+                if (code == EventCode::ABILITY_APPLIED && chunk.columns[COLUMN_A][row] == KAMIKAZE && this->config.filter.matches(chunk, row)) {
+                    pending[side] = { true, chunk.columns[COLUMN_GAME][row], chunk.columns[COLUMN_ROUND][row], chunk.columns[COLUMN_SLOT][row],
+                        static_cast<int>(chunk.columns[COLUMN_CARD][row]) };
+                }
+                else if (code == EventCode::CARD_DAMAGED) {
+                    // Both cards of a slot report their damage after the slot's abilities, so the opposing one is the card destroyed
+                    PendingKamikaze& attacker = pending[!side];
+                    if (!attacker.active || attacker.game != chunk.columns[COLUMN_GAME][row] || attacker.round != chunk.columns[COLUMN_ROUND][row]
+                        || attacker.slot != chunk.columns[COLUMN_SLOT][row]) {
+                        continue;
+                    }
+                    attacker.active = false;
+                    int victim = static_cast<int>(chunk.columns[COLUMN_CARD][row]);
+                    int difference = statTotal(victim) - statTotal(attacker.card);
+                    result.kamikazes++;
+                    result.tradesUp += difference > 0;
+                    result.tradesEven += difference == 0;
+                    result.tradesDown += difference < 0;
+                    if (victim >= 0 && victim < CARD_COUNT) {
+                        result.victims[victim]++;
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+QueryResult EventQuery::run() const {
+    int threadCount = this->config.threads;
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, static_cast<int>(this->config.files.size()));
+
+    std::atomic<std::size_t> nextFile = 0;
+    std::mutex resultMutex;
+    QueryResult total;
+    auto worker = [&]() {
+        QueryResult local;
+        for (std::size_t i = nextFile++; i < this->config.files.size(); i = nextFile++) {
+            scan(this->config.files[i], local);
+        }
+        std::lock_guard<std::mutex> lock(resultMutex);
+        total.merge(local);
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return total;
+}
+
+void EventQuery::printReport(const QueryResult& result) const {
+    auto percent = [](long long count, long long total) {
+        return total > 0 ? 100.0 * count / total : 0.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Files:              " << result.files << " (" << result.chunks << " chunks, " << result.bytes / 1048576.0 << " MB)\n";
+    std::cout << "Events:             " << result.rows << " (" << (result.rows > 0 ? static_cast<double>(result.bytes) / result.rows : 0.0)
+        << " bytes each, " << sizeof(Event) << " uncompressed)\n";
+    std::cout << "Time:               " << result.seconds << " s (" << (result.seconds > 0 ? result.rows / result.seconds / 1e6 : 0.0) << " M events/s)\n";
+    if (result.damaged) {
+        std::cout << "Some files could not be read completely, the results only cover what could\n";
+    }
+
+    switch (this->config.kind) {
+    case QUERY_SUMMARY:
+        std::cout << "Games:              " << result.games << "\n";
+        std::cout << "Rounds:             " << result.codes[static_cast<int>(EventCode::ASSAULT_ENDED)] << "\n";
+        for (int code = 0; code < static_cast<int>(EventCode::COUNT); code++) {
+            if (result.codes[code] > 0) {
+                std::cout << "  " << std::left << std::setw(18) << eventCodeName(static_cast<EventCode>(code)) << std::right << result.codes[code]
+                    << " (" << percent(result.codes[code], result.rows) << "%)\n";
+            }
+        }
+        break;
+    case QUERY_COUNT:
+        std::cout << "Matching events:    " << result.matches << " (" << percent(result.matches, result.rows) << "%)\n";
+        for (const auto& [value, count] : result.groups) {
+            std::cout << "  " << std::left << std::setw(18) << describe(this->config.groupBy, value) << std::right << count
+                << " (" << percent(count, result.matches) << "%)\n";
+        }
+        break;
+    case QUERY_KAMIKAZE:
+        std::cout << "Kamikaze trades:    " << result.kamikazes << "\n";
+        std::cout << "Traded up:          " << result.tradesUp << " (" << percent(result.tradesUp, result.kamikazes) << "%)\n";
+        std::cout << "Traded even:        " << result.tradesEven << " (" << percent(result.tradesEven, result.kamikazes) << "%)\n";
+        std::cout << "Traded down:        " << result.tradesDown << " (" << percent(result.tradesDown, result.kamikazes) << "%)\n";
+        std::cout << "Cards destroyed (stat total):\n";
+        for (int card = 0; card < CARD_COUNT; card++) {
+            if (result.victims[card] > 0) {
+                std::cout << "  " << std::left << std::setw(18) << CardDatabase::identifier(static_cast<CardID>(card)) << std::right
+                    << result.victims[card] << " (" << percent(result.victims[card], result.kamikazes) << "%, " << statTotal(card) << ")\n";
+            }
+        }
+        break;
+    }
+}
+
+int runEventQuery(int argc, char* argv[]) {
+    QueryConfig config;
+    auto usage = [](const std::string& message) {
+        std::cerr << message << "\n";
+        std::cerr << "Usage: --query summary|count|kamikaze FILE... [--code CODE] [--side player|enemy] [--slot N] [--card ID] [--by COLUMN] [--threads N]\n";
+        return 1;
+    };
+
+    int first = 2;
+    if (argc < 3) {
+        return usage("The query needs a kind and at least one file");
+    }
+    std::string kind = argv[2];
+    if (kind == "summary" || kind == "count" || kind == "kamikaze") {
+        config.kind = kind == "summary" ? QUERY_SUMMARY : kind == "count" ? QUERY_COUNT : QUERY_KAMIKAZE;
+        first = 3;
+    }
+
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--code" && hasValue) {
+            std::string name = argv[++i];
+            config.filter.code = -1;
+            for (int code = 0; code < static_cast<int>(EventCode::COUNT); code++) {
+                if (name == eventCodeName(static_cast<EventCode>(code))) {
+                    config.filter.code = code;
+                }
+            }
+            if (config.filter.code < 0) {
+                return usage("Unknown event code: " + name);
+            }
+        }
+        else if (arg == "--side" && hasValue) {
+            std::string side = argv[++i];
+            if (side != "player" && side != "enemy") {
+                return usage("Unknown side: " + side + " (player or enemy)");
+            }
+            config.filter.side = side == "player";
+        }
+        else if (arg == "--slot" && hasValue) {
+            // Slots are numbered from 1 on the command line, like on the board
+            int slot = 0;
+            if (!parseNumber(argv[++i], 1, GameState::slotCount, slot)) {
+                return usage(std::string("Invalid slot: ") + argv[i] + " (1 to " + std::to_string(GameState::slotCount) + ")");
+            }
+            config.filter.slot = slot - 1;
+        }
+        else if (arg == "--card" && hasValue) {
+            CardID card = CardDatabase::findCard(argv[++i]);
+            if (card == BLANK) {
+                return usage(std::string("Unknown card ID: ") + argv[i]);
+            }
+            config.filter.card = card;
+        }
+        else if (arg == "--by" && hasValue) {
+            std::string column = argv[++i];
+            config.groupBy = static_cast<int>(std::find(std::begin(columnNames), std::end(columnNames), column) - std::begin(columnNames));
+            if (config.groupBy >= COLUMN_COUNT) {
+                return usage("Unknown column: " + column + " (game, round, code, side, slot, card, a or b)");
+            }
+        }
+        else if (arg == "--threads" && hasValue) {
+            if (!parseNumber(argv[++i], 0, std::numeric_limits<int>::max(), config.threads)) {
+                return usage(std::string("Invalid value for --threads: ") + argv[i]);
+            }
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            return usage("Unknown query argument: " + arg);
+        }
+        else {
+            config.files.push_back(arg);
+        }
+    }
+    if (config.files.empty()) {
+        return usage("The query needs at least one event file (written by --simulate --events PREFIX)");
+    }
+    if (config.groupBy >= 0 && config.kind != QUERY_COUNT) {
+        return usage("--by only applies to count queries");
+    }
+    if (config.filter.code >= 0 && config.kind == QUERY_KAMIKAZE) {
+        return usage("Kamikaze queries always look at ABILITY_APPLIED, --code doesn't apply");
+    }
+
+    EventQuery query(config);
+    QueryResult result = query.run();
+    query.printReport(result);
+    return result.damaged ? 1 : 0;
+}
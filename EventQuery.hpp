@@ -0,0 +1,90 @@
+/*
+EventQuery.hpp defines the queries over the event files of --simulate --events (see EventTable.hpp). Files are scanned chunk by chunk,
+one worker thread per file, decoding only the columns a query reads, so runs of hundreds of millions of rounds never have to fit in memory.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "EventTable.hpp"
+#include "Game.hpp"
+
+/**
+ * @brief EventFilter selects events by their fields. -1 matches anything.
+ */
+typedef struct EventFilter {
+    int code = -1; // EventCode
+    int side = -1; // 1 = player, 0 = enemy
+    int slot = -1;
+    int card = -1; // CardID
+
+    bool matches(const EventChunk& chunk, int row) const;
+} EventFilter;
+
+enum QueryKind {
+    QUERY_SUMMARY, // Events, games and rounds of the files, events per code, and how well they compressed
+    QUERY_COUNT, // Events matching the filter, optionally grouped by one column
+    QUERY_KAMIKAZE, // What the KAMIKAZE cards matching the filter's card and side destroyed, and whether it was worth more than them
+};
+
+typedef struct QueryConfig {
+    QueryKind kind = QUERY_SUMMARY;
+    std::vector<std::string> files;
+    EventFilter filter;
+    int groupBy = -1; // EventColumn of QUERY_COUNT's groups. -1 = no groups
+    int threads = 0; // 0 = one per hardware thread. Never more than one per file
+} QueryConfig;
+
+/**
+ * @brief QueryResult is what a query found. Workers fill their own copy and merge them at the end.
+ */
+typedef struct QueryResult {
+    int files = 0;
+    int chunks = 0;
+    long long bytes = 0;
+    long long rows = 0;
+    long long games = 0;
+    long long codes[static_cast<int>(EventCode::COUNT)] = {};
+    bool damaged = false; // A file or chunk couldn't be read
+
+    long long matches = 0;
+    std::map<std::int64_t, long long> groups;
+
+    long long kamikazes = 0;
+    long long tradesUp = 0; // The destroyed card's stat total (health + attack + defense) was higher than the KAMIKAZE card's
+    long long tradesEven = 0;
+    long long tradesDown = 0;
+    long long victims[CARD_COUNT] = {};
+
+    double seconds = 0.0;
+
+    void merge(const QueryResult& other);
+} QueryResult;
+
+class EventQuery {
+public:
+    EventQuery(QueryConfig config) : config(config) {}
+
+    QueryResult run() const;
+
+    // Runs the query over one file and adds what it found to result
+    void scan(const std::string& path, QueryResult& result) const;
+
+    void printReport(const QueryResult& result) const;
+
+    // Health + attack + defense of the active card set, what QUERY_KAMIKAZE compares
+    static int statTotal(int card);
+
+private:
+    QueryConfig config;
+};
+
+/**
+ * @brief runEventQuery is the entry point of --query mode.
+ * Usage: --query summary|count|kamikaze FILE... [--code CODE] [--side player|enemy] [--slot N] [--card ID] [--by COLUMN] [--threads N]
+ */
+int runEventQuery(int argc, char* argv[]);
@@ -0,0 +1,406 @@
+#include "EventTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iostream>
+
+
+namespace {
+    // File header: magic, version. Every chunk: magic, rows, columns, payload bytes, then its schema and its columns
+    const char fileMagic[4] = { 'R', 'L', 'S', 'E' };
+    const char chunkMagic[4] = { 'C', 'H', 'N', 'K' };
+    const std::uint32_t fileVersion = 2;
+    const std::size_t fileHeaderSize = 8;
+    const std::size_t chunkHeaderSize = 16;
+    const std::size_t descriptorSize = 8;
+
+    ColumnType columnType(EventColumn column) {
+        switch (column) {
+        case COLUMN_GAME: return TYPE_INT64;
+        case COLUMN_CODE:
+        case COLUMN_SIDE: return TYPE_UINT8;
+        case COLUMN_SLOT:
+        case COLUMN_CARD: return TYPE_INT8;
+        default: return TYPE_INT16;
+        }
+    }
+
+    int typeWidth(ColumnType type) {
+        switch (type) {
+        case TYPE_INT8:
+        case TYPE_UINT8: return 1;
+        case TYPE_INT16: return 2;
+        default: return 8;
+        }
+    }
+
+    void put32(std::vector<unsigned char>& out, std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    std::uint32_t get32(const unsigned char* data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    void putVarint(std::vector<unsigned char>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool getVarint(const unsigned char*& data, const unsigned char* end, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && data < end; shift += 7) {
+            unsigned char byte = *data++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void encode(ColumnEncoding encoding, ColumnType type, const std::vector<std::int64_t>& values, std::vector<unsigned char>& out) {
+        out.clear();
+        const std::size_t count = values.size();
+        switch (encoding) {
+        case ENCODING_RAW: {
+            int width = typeWidth(type);
+            for (std::int64_t value : values) {
+                for (int i = 0; i < width; i++) {
+                    out.push_back(static_cast<unsigned char>(static_cast<std::uint64_t>(value) >> (8 * i)));
+                }
+            }
+            break;
+        }
+        case ENCODING_RUN_LENGTH:
+            for (std::size_t i = 0; i < count;) {
+                std::size_t run = 1;
+                while (i + run < count && values[i + run] == values[i]) {
+                    run++;
+                }
+                putVarint(out, zigzag(values[i]));
+                putVarint(out, run);
+                i += run;
+            }
+            break;
+        case ENCODING_DELTA: {
+            std::int64_t previous = 0;
+            for (std::int64_t value : values) {
+                putVarint(out, zigzag(value - previous));
+                previous = value;
+            }
+            break;
+        }
+        case ENCODING_BIT_PACKED: {
+            std::int64_t minimum = count > 0 ? *std::min_element(values.begin(), values.end()) : 0;
+            std::uint64_t range = 0;
+            for (std::int64_t value : values) {
+                range |= static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(minimum);
+            }
+            int width = std::bit_width(range);
+            putVarint(out, zigzag(minimum));
+            out.push_back(static_cast<unsigned char>(width));
+            // Values go in at most 32 bits at a time, so the bits still pending always fit in 64
+            std::uint64_t pending = 0;
+            int pendingBits = 0;
+            auto push = [&](std::uint64_t bits, int count) {
+                pending |= bits << pendingBits;
+                pendingBits += count;
+                for (; pendingBits >= 8; pendingBits -= 8, pending >>= 8) {
+                    out.push_back(static_cast<unsigned char>(pending));
+                }
+            };
+            for (std::int64_t value : values) {
+                std::uint64_t offset = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(minimum);
+                push(offset & 0xFFFFFFFFull, std::min(width, 32));
+                if (width > 32) {
+                    push(offset >> 32, width - 32);
+                }
+            }
+            if (pendingBits > 0) {
+                out.push_back(static_cast<unsigned char>(pending));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    bool decode(ColumnEncoding encoding, ColumnType type, const unsigned char* data, std::size_t size, int rows, std::int64_t* out) {
+        const unsigned char* end = data + size;
+        switch (encoding) {
+        case ENCODING_RAW: {
+            int width = typeWidth(type);
+            if (size != static_cast<std::size_t>(rows) * width) {
+                return false;
+            }
+            for (int row = 0; row < rows; row++, data += width) {
+                std::uint64_t value = 0;
+                for (int i = 0; i < width; i++) {
+                    value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+                }
+                // Sign-extend the signed types
+                int unused = 64 - 8 * width;
+                out[row] = type == TYPE_UINT8 ? static_cast<std::int64_t>(value)
+                    : unused > 0 ? static_cast<std::int64_t>(value << unused) >> unused : static_cast<std::int64_t>(value);
+            }
+            return true;
+        }
+        case ENCODING_RUN_LENGTH: {
+            int row = 0;
+            while (data < end) {
+                std::uint64_t value = 0;
+                std::uint64_t run = 0;
+                if (!getVarint(data, end, value) || !getVarint(data, end, run) || run > static_cast<std::uint64_t>(rows - row)) {
+                    return false;
+                }
+                std::fill(out + row, out + row + run, unzigzag(value));
+                row += static_cast<int>(run);
+            }
+            return row == rows;
+        }
+        case ENCODING_DELTA: {
+            std::int64_t previous = 0;
+            for (int row = 0; row < rows; row++) {
+                std::uint64_t delta = 0;
+                if (!getVarint(data, end, delta)) {
+                    return false;
+                }
+                previous += unzigzag(delta);
+                out[row] = previous;
+            }
+            return data == end;
+        }
+        case ENCODING_BIT_PACKED: {
+            std::uint64_t minimum = 0;
+            if (!getVarint(data, end, minimum) || data >= end) {
+                return false;
+            }
+            int width = *data++;
+            if (width > 64 || static_cast<std::size_t>(end - data) != (static_cast<std::size_t>(rows) * width + 7) / 8) {
+                return false;
+            }
+            std::int64_t base = unzigzag(minimum);
+            std::uint64_t pending = 0;
+            int pendingBits = 0;
+            auto pull = [&](int count) {
+                for (; pendingBits < count; pendingBits += 8) {
+                    pending |= static_cast<std::uint64_t>(*data++) << pendingBits;
+                }
+                std::uint64_t bits = pending & ((1ull << count) - 1);
+                pending >>= count;
+                pendingBits -= count;
+                return bits;
+            };
+            for (int row = 0; row < rows; row++) {
+                std::uint64_t offset = pull(std::min(width, 32));
+                if (width > 32) {
+                    offset |= pull(width - 32) << 32;
+                }
+                out[row] = static_cast<std::int64_t>(static_cast<std::uint64_t>(base) + offset);
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+Event EventChunk::event(int row) const {
+    return Event{ static_cast<EventCode>(this->columns[COLUMN_CODE][row]), static_cast<std::uint8_t>(this->columns[COLUMN_SIDE][row]),
+        static_cast<std::int8_t>(this->columns[COLUMN_SLOT][row]), static_cast<std::int8_t>(this->columns[COLUMN_CARD][row]),
+        static_cast<std::int16_t>(this->columns[COLUMN_A][row]), static_cast<std::int16_t>(this->columns[COLUMN_B][row]) };
+}
+
+EventTableWriter::EventTableWriter() {
+    for (std::vector<std::int64_t>& column : this->columns) {
+        column.reserve(chunkRows);
+    }
+}
+
+bool EventTableWriter::open(const std::string& path) {
+    close();
+    this->path = path;
+    this->out.open(path, std::ios::binary | std::ios::trunc);
+    if (!this->out) {
+        std::cerr << "EventTable: Can't write " << path << "\n";
+        return false;
+    }
+    std::vector<unsigned char> header(fileMagic, fileMagic + 4);
+    put32(header, fileVersion);
+    this->out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    this->bytes = static_cast<long long>(header.size());
+    this->rows = 0;
+    this->game = -1;
+    this->round = 0;
+    return static_cast<bool>(this->out);
+}
+
+bool EventTableWriter::close() {
+    if (!this->out.is_open()) {
+        return true;
+    }
+    writeChunk();
+    bool written = static_cast<bool>(this->out);
+    this->out.close();
+    if (!written) {
+        std::cerr << "EventTable: Writing " << this->path << " failed\n";
+    }
+    return written;
+}
+
+void EventTableWriter::beginGame(long long game) {
+    this->game = game;
+    this->round = 0;
+}
+
+void EventTableWriter::consume(const Event* events, int count) {
+    for (int i = 0; i < count; i++) {
+        const Event& event = events[i];
+        this->columns[COLUMN_GAME].push_back(this->game);
+        this->columns[COLUMN_ROUND].push_back(this->round);
+        this->columns[COLUMN_CODE].push_back(static_cast<std::int64_t>(event.code));
+        this->columns[COLUMN_SIDE].push_back(event.side);
+        this->columns[COLUMN_SLOT].push_back(event.slot);
+        this->columns[COLUMN_CARD].push_back(event.card);
+        this->columns[COLUMN_A].push_back(event.a);
+        this->columns[COLUMN_B].push_back(event.b);
+        if (event.code == EventCode::ASSAULT_ENDED) {
+            this->round++;
+        }
+        if (static_cast<int>(this->columns[COLUMN_GAME].size()) >= chunkRows) {
+            writeChunk();
+        }
+    }
+}
+
+void EventTableWriter::writeChunk() {
+    const std::size_t count = this->columns[COLUMN_GAME].size();
+    if (count == 0 || !this->out.is_open()) {
+        return;
+    }
+
+    // Every column is encoded every way and stored the smallest, so the schema can differ from chunk to chunk
+    std::vector<unsigned char> schema;
+    std::vector<unsigned char> payload;
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        ColumnType type = columnType(static_cast<EventColumn>(column));
+        int best = ENCODING_RAW;
+        for (int encoding = ENCODING_RAW; encoding < ENCODING_COUNT; encoding++) {
+            encode(static_cast<ColumnEncoding>(encoding), type, this->columns[column], this->encoded[encoding]);
+            if (this->encoded[encoding].size() < this->encoded[best].size()) {
+                best = encoding;
+            }
+        }
+        schema.push_back(static_cast<unsigned char>(column));
+        schema.push_back(type);
+        schema.push_back(static_cast<unsigned char>(best));
+        schema.push_back(0);
+        put32(schema, static_cast<std::uint32_t>(this->encoded[best].size()));
+        payload.insert(payload.end(), this->encoded[best].begin(), this->encoded[best].end());
+        this->columns[column].clear();
+    }
+
+    std::vector<unsigned char> header(chunkMagic, chunkMagic + 4);
+    put32(header, static_cast<std::uint32_t>(count));
+    put32(header, COLUMN_COUNT);
+    put32(header, static_cast<std::uint32_t>(payload.size()));
+    this->out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    this->out.write(reinterpret_cast<const char*>(schema.data()), schema.size());
+    this->out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    this->rows += static_cast<long long>(count);
+    this->bytes += static_cast<long long>(header.size() + schema.size() + payload.size());
+}
+
+bool EventTableReader::open(const std::string& path) {
+    this->path = path;
+    this->chunks.clear();
+    this->rows = 0;
+    this->complete = false;
+    if (!this->file.open(path)) {
+        std::cerr << "EventTable: Can't read " << path << "\n";
+        return false;
+    }
+
+    const unsigned char* data = this->file.getData();
+    const std::size_t size = this->file.getSize();
+    if (size < fileHeaderSize || std::memcmp(data, fileMagic, 4) != 0 || get32(data + 4) != fileVersion) {
+        std::cerr << "EventTable: " << path << " is not an event file of version " << fileVersion << "\n";
+        this->file.close();
+        return false;
+    }
+
+    // Only the chunk headers are touched here, the columns stay on disk until a query decodes them
+    std::size_t offset = fileHeaderSize;
+    while (offset < size) {
+        if (size - offset < chunkHeaderSize || std::memcmp(data + offset, chunkMagic, 4) != 0) {
+            std::cerr << "EventTable: " << path << " is damaged at byte " << offset << ", reading the chunks before it\n";
+            break;
+        }
+        ChunkIndex chunk;
+        chunk.rows = static_cast<int>(get32(data + offset + 4));
+        chunk.columns = static_cast<int>(get32(data + offset + 8));
+        std::size_t payloadSize = get32(data + offset + 12);
+        chunk.schema = offset + chunkHeaderSize;
+        chunk.payload = chunk.schema + chunk.columns * descriptorSize;
+        if (chunk.payload > size || size - chunk.payload < payloadSize) {
+            std::cerr << "EventTable: " << path << " ends in the middle of a chunk, reading the chunks before it\n";
+            break;
+        }
+        chunk.end = chunk.payload + payloadSize;
+        this->chunks.push_back(chunk);
+        this->rows += chunk.rows;
+        offset = chunk.end;
+    }
+    this->complete = offset == size;
+    return true;
+}
+
+bool EventTableReader::readChunk(int index, unsigned mask, EventChunk& chunk) const {
+    const ChunkIndex& entry = this->chunks[index];
+    const unsigned char* data = this->file.getData();
+    chunk.rows = entry.rows;
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        if (mask & (1u << column)) {
+            chunk.columns[column].assign(entry.rows, 0);
+        }
+        else {
+            chunk.columns[column].clear();
+        }
+    }
+
+    std::size_t offset = entry.payload;
+    for (int i = 0; i < entry.columns; i++) {
+        const unsigned char* bytes = data + entry.schema + i * descriptorSize;
+        ColumnDescriptor descriptor = { static_cast<EventColumn>(bytes[0]), static_cast<ColumnType>(bytes[1]), static_cast<ColumnEncoding>(bytes[2]), get32(bytes + 4) };
+        std::size_t size = descriptor.size;
+        if (size > entry.end - offset) {
+            std::cerr << "EventTable: The schema of chunk " << index << " of " << this->path << " is damaged\n";
+            return false;
+        }
+        // Columns of later versions are skipped
+        if (descriptor.column < COLUMN_COUNT && (mask & (1u << descriptor.column))
+            && !decode(descriptor.encoding, descriptor.type, data + offset, size, entry.rows, chunk.columns[descriptor.column].data())) {
+            std::cerr << "EventTable: Column " << static_cast<int>(descriptor.column) << " of chunk " << index << " of " << this->path << " is damaged\n";
+            return false;
+        }
+        offset += size;
+    }
+    return true;
+}
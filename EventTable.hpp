@@ -0,0 +1,143 @@
+/*
+EventTable.hpp defines the columnar event files of long simulation runs. A run with --events writes every event of every game (see Events.hpp),
+tagged with its game and round, one file per worker thread so writers never share anything. Events are stored in chunks of columns:
+each column of a chunk is compressed on its own (run lengths, deltas, bit packing or raw values, whichever is smallest) and described by the chunk's schema.
+Files are read through a memory map one chunk at a time, decoding only the columns a query needs (see EventQuery.hpp).
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Events.hpp"
+#include "MappedFile.hpp"
+
+// Columns of an event table. The values are stored in the files, so new columns go at the end
+enum EventColumn : std::uint8_t {
+    COLUMN_GAME, // Game index within the run (replay it with Simulator::gameSeed)
+    COLUMN_ROUND, // Assaults resolved in the game before this event
+    COLUMN_CODE,
+    COLUMN_SIDE,
+    COLUMN_SLOT,
+    COLUMN_CARD,
+    COLUMN_A,
+    COLUMN_B,
+    COLUMN_COUNT
+};
+
+// Physical type of a column, the width of its RAW encoding
+enum ColumnType : std::uint8_t {
+    TYPE_INT8,
+    TYPE_UINT8,
+    TYPE_INT16,
+    TYPE_INT64,
+};
+
+enum ColumnEncoding : std::uint8_t {
+    ENCODING_RAW, // Little-endian values of the column's type
+    ENCODING_RUN_LENGTH, // (zigzag varint value, varint count) pairs
+    ENCODING_DELTA, // Zigzag varints of the difference to the previous value (the first to 0)
+    ENCODING_BIT_PACKED, // Zigzag varint minimum, one byte of width, then value - minimum in width bits each, lowest bits first
+    ENCODING_COUNT
+};
+
+/**
+ * @brief ColumnDescriptor is one entry of a chunk's schema. The column's bytes follow those of the previous entry.
+ */
+typedef struct ColumnDescriptor {
+    EventColumn column;
+    ColumnType type;
+    ColumnEncoding encoding;
+    std::uint32_t size; // Bytes
+} ColumnDescriptor;
+
+/**
+ * @brief EventChunk holds the decoded columns of one chunk. Columns that were not asked for are left empty.
+ */
+typedef struct EventChunk {
+    int rows = 0;
+    std::vector<std::int64_t> columns[COLUMN_COUNT];
+
+    const std::int64_t* column(EventColumn id) const { return this->columns[id].data(); }
+
+    // Row as an Event. Needs the code, side, slot, card, a and b columns
+    Event event(int row) const;
+} EventChunk;
+
+/**
+ * @brief EventTableWriter is the event consumer of one simulation worker. It collects a chunk's worth of events in columns
+ * and appends the chunk to its file when it is full.
+ */
+class EventTableWriter : public EventConsumer {
+public:
+    inline static const int chunkRows = 65536;
+
+    EventTableWriter();
+    ~EventTableWriter() { close(); }
+
+    // Creates path and writes the file header. Returns false (and prints why) if it can't be written
+    bool open(const std::string& path);
+
+    // Writes the last chunk and closes the file. Returns whether every write succeeded
+    bool close();
+
+    // Events consumed from now on belong to round 0 of game. Pending events of the thread must be flushed first (EventLog::flush)
+    void beginGame(long long game);
+
+    void consume(const Event* events, int count) override;
+
+    long long getRows() const { return this->rows; }
+    long long getBytes() const { return this->bytes; }
+
+private:
+    void writeChunk();
+
+    std::ofstream out;
+    std::string path;
+    std::vector<std::int64_t> columns[COLUMN_COUNT];
+    std::vector<unsigned char> encoded[ENCODING_COUNT]; // Scratch buffers, one per encoding
+    long long game = -1;
+    int round = 0;
+    long long rows = 0;
+    long long bytes = 0;
+};
+
+/**
+ * @brief EventTableReader maps an event file and decodes its chunks on demand, so files far larger than memory can be scanned.
+ */
+class EventTableReader {
+public:
+    // Maps path and indexes its chunks. Returns false (and prints why) if it isn't a valid event file. A file cut short opens with the chunks before the cut
+    bool open(const std::string& path);
+
+    // Whether every byte of the file belonged to a chunk. False if it was cut short or damaged after the chunks that were indexed
+    bool isComplete() const { return this->complete; }
+
+    int getChunkCount() const { return static_cast<int>(this->chunks.size()); }
+    long long getRows() const { return this->rows; }
+    std::size_t getBytes() const { return this->file.getSize(); }
+
+    /**
+     * @brief readChunk decodes the columns of chunk index that are set in mask (bit 1 << EventColumn).
+     * @return false if the chunk is damaged. Columns the chunk doesn't have are filled with zeros.
+     */
+    bool readChunk(int index, unsigned mask, EventChunk& chunk) const;
+
+private:
+    typedef struct ChunkIndex {
+        std::size_t schema; // Offset of the first ColumnDescriptor
+        std::size_t payload; // Offset of the first column
+        std::size_t end; // Offset of the next chunk
+        int rows;
+        int columns;
+    } ChunkIndex;
+
+    MappedFile file;
+    std::string path;
+    std::vector<ChunkIndex> chunks;
+    long long rows = 0;
+    bool complete = false;
+};
@@ -0,0 +1,162 @@
+#include "Events.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include "Game.hpp"
+
+
+namespace {
+    /**
+     * @brief EventBuffer is the per-thread store of pending events.
+     */
+    struct EventBuffer {
+        Event events[EventLog::bufferCapacity];
+        int count = 0;
+        int batchSize = EventLog::bufferCapacity;
+        EventConsumer* consumer = nullptr;
+
+        void flush() {
+            if (count > 0 && consumer != nullptr) {
+                consumer->consume(events, count);
+            }
+            count = 0;
+        }
+    };
+
+    thread_local EventBuffer buffer;
+
+    const char* const codeNames[] = {
+        "PLAY_REJECTED", "DISCARD_REJECTED", "DECK_EMPTY", "HAND_FULL", "DECK_FULL",
+        "CARD_PLAYED", "INSPIRE_PLAYED", "REINFORCE_PLAYED", "SLOT_SKIPPED", "GAME_ENDED",
+        "CARD_DRAWN", "ABILITY_APPLIED", "FATIGUE", "CARD_DAMAGED", "FACE_HIT", "CARD_DIED", "ASSAULT_ENDED",
+    };
+    static_assert(sizeof(codeNames) / sizeof(codeNames[0]) == static_cast<int>(EventCode::COUNT), "Every EventCode needs a name");
+
+    const char* sideName(const Event& event) {
+        return event.side ? "Player" : "Enemy";
+    }
+
+    const char* cardName(const Event& event) {
+        if (event.card < 0 || event.card >= CARD_COUNT) {
+            return "Unknown card";
+        }
+        return getCardType(static_cast<CardID>(event.card)).name.data();
+    }
+}
+
+const char* eventCodeName(EventCode code) {
+    return code < EventCode::COUNT ? codeNames[static_cast<int>(code)] : "UNKNOWN";
+}
+
+void EventLog::setConsumer(EventConsumer* consumer, int batchSize) {
+    buffer.flush();
+    buffer.consumer = consumer;
+    buffer.batchSize = std::max(1, std::min(batchSize, bufferCapacity));
+}
+
+void EventLog::emit(const Event& event) {
+    if (buffer.consumer == nullptr) {
+        return;
+    }
+    buffer.events[buffer.count++] = event;
+    if (buffer.count >= buffer.batchSize) {
+        buffer.flush();
+    }
+}
+
+void EventLog::flush() {
+    buffer.flush();
+}
+
+void TextEventConsumer::consume(const Event* events, int count) {
+    for (int i = 0; i < count; i++) {
+        if (eventLevel(events[i].code) <= maxLevel) {
+            describe(out, events[i]);
+        }
+    }
+}
+
+void TextEventConsumer::describe(std::ostream& out, const Event& event) {
+    switch (event.code) {
+    case EventCode::PLAY_REJECTED:
+    case EventCode::DISCARD_REJECTED:
+        switch (event.a) {
+        case INVALID_POSITION: out << "Invalid position\n"; break;
+        case POSITION_OCCUPIED: out << "Position already occupied\n"; break;
+        case INVALID_CARD_INDEX: out << "Invalid card index\n"; break;
+        case ATTACK_ONLY_ON_DEFENSE: out << "Cannot play card with ATTACK_ONLY condition on defense\n"; break;
+        case NO_ATTACKER: out << "No attacking card\n"; break;
+        case SURPRISE_ATTACKER: out << "Cannot play card on defense against attacking card with SURPRISE special ability\n"; break;
+        case DEFENSE_ONLY_ON_ATTACK: out << "Cannot play card with DEFENSE_ONLY condition on attack\n"; break;
+        case NO_CARD_TO_DISCARD: out << "No card to discard\n"; break;
+        default: out << "Move rejected\n"; break;
+        }
+        break;
+    case EventCode::DECK_EMPTY:
+        out << "Deck is empty\n";
+        break;
+    case EventCode::HAND_FULL:
+        if (event.card >= 0) {
+            out << sideName(event) << "'s hand is full, " << cardName(event) << " is lost\n";
+        }
+        else {
+            out << "Hand is full\n";
+        }
+        break;
+    case EventCode::DECK_FULL:
+        out << sideName(event) << "'s deck is full, " << cardName(event) << " is lost\n";
+        break;
+    case EventCode::CARD_PLAYED:
+        out << sideName(event) << " plays " << cardName(event) << " at slot " << event.slot + 1 << "\n";
+        break;
+    case EventCode::INSPIRE_PLAYED:
+        out << "Inspiring card played\n";
+        break;
+    case EventCode::REINFORCE_PLAYED:
+        out << "Reinforce card played\n";
+        break;
+    case EventCode::SLOT_SKIPPED:
+        out << sideName(event) << " skips " << (event.a ? "defending" : "attacking") << " slot " << event.slot + 1 << "\n";
+        break;
+    case EventCode::GAME_ENDED:
+        out << "Game ended\n";
+        break;
+    case EventCode::CARD_DRAWN:
+        out << sideName(event) << " draws " << cardName(event) << "\n";
+        break;
+    case EventCode::ABILITY_APPLIED:
+        switch (event.a) {
+        case ARMOR_PIERCE: out << "Armor Pierce card applied\n"; break;
+        case HATE: out << "Hate card applied\n"; break;
+        case KAMIKAZE: out << "Kamikaze card applied\n"; break;
+        default: out << "Ability applied\n"; break;
+        }
+        break;
+    case EventCode::FATIGUE:
+        out << "Stalemate detected. Applying fatigue of war.\n";
+        break;
+    case EventCode::CARD_DAMAGED:
+        out << sideName(event) << " " << cardName(event) << " in slot " << event.slot + 1 << " takes " << event.a << " damage";
+        if (event.b > 0) {
+            out << " (" << event.b << " overflow)";
+        }
+        out << "\n";
+        break;
+    case EventCode::FACE_HIT:
+        out << sideName(event) << " " << cardName(event) << " in slot " << event.slot + 1 << " hits for " << event.a << "\n";
+        break;
+    case EventCode::CARD_DIED:
+        out << sideName(event) << " " << cardName(event) << " in slot " << event.slot + 1 << " is destroyed\n";
+        break;
+    case EventCode::ASSAULT_ENDED:
+        out << "Assault ended. Player Health: " << event.a << ", Enemy Health: " << event.b << "\n";
+        break;
+    default:
+        break;
+    }
+}
+
+void BinaryEventConsumer::consume(const Event* events, int count) {
+    out.write(reinterpret_cast<const char*>(events), static_cast<std::streamsize>(count) * sizeof(Event));
+}
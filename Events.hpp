@@ -0,0 +1,152 @@
+/*
+Events.hpp defines the event log of the rules engine. Instead of printing, the engine reports what happens (cards played, abilities, damage, ...)
+as small typed events. Events are collected in a per-thread buffer and handed to whichever consumer is installed on that thread:
+the console for the SDL game, a file for captures, or nothing at all for simulations.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @brief RLS_EVENT_LEVEL is the compile-time event level. Events above this level are compiled away entirely.
+ * 0 = no events, 1 = errors (rejected moves), 2 = game flow (plays, abilities on play), 3 = everything (assault details, draws).
+ */
+#ifndef RLS_EVENT_LEVEL
+#define RLS_EVENT_LEVEL 3
+#endif
+
+enum EventLevel {
+    EVENT_ERROR = 1,
+    EVENT_INFO = 2,
+    EVENT_TRACE = 3,
+};
+
+enum class EventCode : std::uint8_t {
+    // Errors
+    PLAY_REJECTED, // a = PlayError
+    DISCARD_REJECTED, // a = PlayError
+    DECK_EMPTY,
+    HAND_FULL, // card = the card lost, when REINFORCE brings more than the hand holds
+    DECK_FULL, // card = the card REINFORCE didn't bring, the side already owning as many cards as its deck holds
+
+    // Game flow
+    CARD_PLAYED,
+    INSPIRE_PLAYED,
+    REINFORCE_PLAYED,
+    SLOT_SKIPPED, // An AI chose to leave a slot empty. a = 1 on defense, 0 on attack
+    GAME_ENDED,
+
+    // Assault details
+    CARD_DRAWN,
+    ABILITY_APPLIED, // Card is the attacker, a = SpecialAbility
+    FATIGUE, // Both cards of the slot dealt no damage and lose 1 HP
+    CARD_DAMAGED, // a = damage taken, b = overflow dealt to the card owner's health
+    FACE_HIT, // Unblocked attack. side = attacking side, a = damage
+    CARD_DIED,
+    ASSAULT_ENDED, // a = player health, b = enemy health
+
+    COUNT
+};
+
+// Reasons for PLAY_REJECTED and DISCARD_REJECTED
+enum PlayError {
+    INVALID_POSITION,
+    POSITION_OCCUPIED,
+    INVALID_CARD_INDEX,
+    ATTACK_ONLY_ON_DEFENSE,
+    NO_ATTACKER,
+    SURPRISE_ATTACKER,
+    DEFENSE_ONLY_ON_ATTACK,
+    NO_CARD_TO_DISCARD,
+};
+
+/**
+ * @brief An Event is a fixed 8-byte record. Fields that do not apply to an event code are 0 (slot and card are -1).
+ */
+typedef struct Event {
+    EventCode code;
+    std::uint8_t side; // 1 = player, 0 = enemy
+    std::int8_t slot;
+    std::int8_t card; // CardID
+    std::int16_t a;
+    std::int16_t b;
+} Event;
+
+static_assert(sizeof(Event) == 8, "Events are meant to stay 8 bytes");
+
+constexpr EventLevel eventLevel(EventCode code) {
+    return code < EventCode::CARD_PLAYED ? EVENT_ERROR
+        : code < EventCode::CARD_DRAWN ? EVENT_INFO
+        : EVENT_TRACE;
+}
+
+// Upper-case name of code, as used on the command line (CARD_PLAYED, ...). "UNKNOWN" for values outside the enum
+const char* eventCodeName(EventCode code);
+
+/**
+ * @brief An EventConsumer receives the events of the thread it is installed on, in batches, in the order they were emitted.
+ */
+class EventConsumer {
+public:
+    virtual ~EventConsumer() = default;
+    virtual void consume(const Event* events, int count) = 0;
+};
+
+/**
+ * @brief TextEventConsumer writes events as human-readable lines (the messages the engine used to print).
+ */
+class TextEventConsumer : public EventConsumer {
+public:
+    TextEventConsumer(std::ostream& out, EventLevel maxLevel = EVENT_INFO) : out(out), maxLevel(maxLevel) {}
+    void consume(const Event* events, int count) override;
+
+    static void describe(std::ostream& out, const Event& event);
+
+private:
+    std::ostream& out;
+    EventLevel maxLevel;
+};
+
+/**
+ * @brief BinaryEventConsumer writes the raw 8-byte events to a binary stream, for later analysis.
+ */
+class BinaryEventConsumer : public EventConsumer {
+public:
+    BinaryEventConsumer(std::ostream& out) : out(out) {}
+    void consume(const Event* events, int count) override;
+
+private:
+    std::ostream& out;
+};
+
+/**
+ * @brief EventLog owns the per-thread event buffers. Nothing is recorded on threads without a consumer.
+ */
+class EventLog {
+public:
+    inline static const int bufferCapacity = 1024;
+
+    /**
+     * @brief setConsumer installs consumer on the calling thread (nullptr removes it). Any pending events go to the old consumer first.
+     * @param batchSize Events are handed over once this many are pending. 1 = immediately, which is what interactive consumers want.
+     */
+    static void setConsumer(EventConsumer* consumer, int batchSize = bufferCapacity);
+
+    static void emit(const Event& event);
+
+    // Hands all pending events of the calling thread to its consumer
+    static void flush();
+};
+
+/**
+ * @brief logEvent is how the engine reports events. The call compiles to nothing when the event's level is above RLS_EVENT_LEVEL.
+ */
+template <EventCode Code>
+inline void logEvent(bool isPlayer = false, int slot = -1, int card = -1, int a = 0, int b = 0) {
+    if constexpr (eventLevel(Code) <= RLS_EVENT_LEVEL) {
+        EventLog::emit(Event{ Code, static_cast<std::uint8_t>(isPlayer), static_cast<std::int8_t>(slot), static_cast<std::int8_t>(card),
+            static_cast<std::int16_t>(a), static_cast<std::int16_t>(b) });
+    }
+}
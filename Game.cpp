@@ -1,105 +1,57 @@
 #include "Game.hpp"
+#include "Events.hpp"
+#include "Assault.hpp"
+#include "CardCounting.hpp"
 
 #include <iostream>
 #include <iomanip> // Used for the command prompt interface
 #include <random>
 
 
-/**
- * @brief The Card Registry is a static map that contains all the card types and their attributes.
- * The general format is:
- *
- * {CardID, {name, maxHealth, attack, defense}}
- */
-std::map<CardID, CardType> Board::cardRegistry = {
-
-    // {NAME, {"Name", maxHealth, attack, defense, specialAbility, playCondition}}
-
-    {STRIDER, {STRIDER, "Strider", 7, 7, 2, INSPIRE}},
-    {ELVEN_PRINCE, {ELVEN_PRINCE, "Elven Prince", 4, 9, 0, ARMOR_PIERCE}},
-    {RECRUIT, {RECRUIT, "Recruit", 3, 2, 2}},
-    {ELVEN_SOLDIER, {ELVEN_SOLDIER, "Elf Soldier", 4, 4, 0, ARMOR_PIERCE}},
-    {LOCKBEARER, {LOCKBEARER, "Lockbearer", 10, 6, 4, INSPIRE, DEFENSE_ONLY}},
-    {THE_WHITE, {THE_WHITE, "The White", 24, 8, 0, REINFORCE}},
-    {KING, {KING, "The King", 9, 5, 5, INSPIRE}},
-
-    {EOMER, {EOMER, "Eomer", 5, 6, 2, INSPIRE}},
-    {CAVALRY, {CAVALRY, "Cavalry", 5, 5, 2, SURPRISE}},
-
-    {URUK, {URUK, "Uruk-Hai", 3, 5, 1} },
-    {ORC, {ORC, "Orc", 3, 4, 0}},
-    {DUNLENDING, {DUNLENDING, "Dunlending", 3, 3, 1, HATE}},
-    {BERSERKER, {BERSERKER, "Berserker", 9, 6, 3, RALLY}},
-    {BATTERING_RAM, {BATTERING_RAM, "Battering Ram", 2, 10, 1, SURPRISE, ATTACK_ONLY}},
-    {FELGROM, {FELGROM, "Felgrom", 1, 0, 20, KAMIKAZE, ATTACK_ONLY}},
-};
-
-std::map<CardID, int> Board::playerDeckRegistry = {
-    {STRIDER, 2},
-    {ELVEN_PRINCE, 2},
-    {RECRUIT, 20},
-    {ELVEN_SOLDIER, 10},
-    {LOCKBEARER, 2},
-    {THE_WHITE, 1},
-    {KING, 1}
-};
-
-std::map<CardID, int> Board::enemyDeckRegistry = {
-    {URUK, 10},
-    {ORC, 15},
-    {DUNLENDING, 10},
-    {BERSERKER, 8},
-    {BATTERING_RAM, 2},
-    {FELGROM, 2},
-};
-
-Card::Card(CardType type) : type(type) {
-    this->currHealth = type.maxHealth;
-    this->attack = type.attack;
-    this->defense = type.defense;
+void GameState::resetAssault() {
+    for (int i = 0; i < slotCount; i++) {
+        this->setCard(false, i, Card());
+        this->setCard(true, i, Card());
+    }
 }
 
-Board::Board() {
-    this->resetAssault();
-}
+StateHash GameState::computeHash() const {
+    StateHash result;
+    for (int side = 0; side < 2; side++) {
+        bool isPlayer = side != 0;
+        for (int i = 0; i < slotCount; i++) {
+            result.board ^= slotKey(isPlayer, i, this->cards(isPlayer)[i]);
+        }
+        result.board ^= Zobrist::healthKey(isPlayer, this->health(isPlayer));
 
-Board::~Board() {
-    for (int i = 0; i < 5; i++) {
-        if (this->enemyCards[i] != nullptr) {
-            delete this->enemyCards[i];
+        const Hand& hand = this->hand(isPlayer);
+        for (int i = 0; i < hand.size(); i++) {
+            result.piles += Zobrist::handKey(isPlayer, hand[i]);
         }
-        if (this->playerCards[i] != nullptr) {
-            delete this->playerCards[i];
+        const Deck& deck = this->deck(isPlayer);
+        for (int i = 0; i < deck.size(); i++) {
+            result.piles += Zobrist::deckKey(isPlayer, deck[i]);
         }
     }
+    return result;
 }
 
-void Board::resetAssault() {
-    this->enemyCards.clear();
-    this->playerCards.clear();
-
-    for (int i = 0; i < 5; i++) {
-        this->enemyCards.push_back(nullptr);
-        this->playerCards.push_back(nullptr);
-    }
-}
-
-void Board::print() const {
+void GameState::print() const {
     std::cout << "Enemy Health: " << this->enemyHealth << "\n";
     std::cout << "Enemy Deck: " << this->enemyDeck.size() << " Cards\n";
     std::cout << "Enemy Hand:\n";
-    for (Card* card : this->enemyHand) {
-        std::cout << card->getType().name << "\n";
+    for (int i = 0; i < this->enemyHand.size(); i++) {
+        std::cout << getCardType(this->enemyHand[i]).name << "\n";
     }
 
     // Print the Assault. Format so that cards' opposing card are aligned.
     int slotWidth = 15;  // Adjust this to fit the widest card name. Default is 15 due to attributes
     for (int i = 0; i < 5; i++) {
-        if (this->enemyCards[i] != nullptr) {
-            slotWidth = std::max(slotWidth, static_cast<int>(this->enemyCards[i]->getType().name.length()));
+        if (!this->enemyCards[i].isBlank()) {
+            slotWidth = std::max(slotWidth, static_cast<int>(this->enemyCards[i].getType().name.length()));
         }
-        if (this->playerCards[i] != nullptr) {
-            slotWidth = std::max(slotWidth, static_cast<int>(this->playerCards[i]->getType().name.length()));
+        if (!this->playerCards[i].isBlank()) {
+            slotWidth = std::max(slotWidth, static_cast<int>(this->playerCards[i].getType().name.length()));
         }
     }
     slotWidth++; // Add 1 for the minimum space between cards
@@ -107,9 +59,9 @@ void Board::print() const {
     // Enemy Cards
     std::cout << "\nEnemy Cards\n";
     for (int i = 0; i < 5; i++) {
-        if (this->enemyCards[i] != nullptr) {
+        if (!this->enemyCards[i].isBlank()) {
             std::cout << std::left << std::setw(slotWidth)
-                << this->enemyCards[i]->getType().name;
+                << this->enemyCards[i].getType().name;
         }
         else {
             std::cout << std::left << std::setw(slotWidth) << "Empty";
@@ -119,17 +71,17 @@ void Board::print() const {
     // Print attributes
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->enemyCards[i] != nullptr ? "Attack: " + std::to_string(this->enemyCards[i]->attack) : "~");
+            << (!this->enemyCards[i].isBlank() ? "Attack: " + std::to_string(this->enemyCards[i].attack) : "~");
     }
     std::cout << "\n";
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->enemyCards[i] != nullptr ? "Defense: " + std::to_string(this->enemyCards[i]->defense) : "~");
+            << (!this->enemyCards[i].isBlank() ? "Defense: " + std::to_string(this->enemyCards[i].defense) : "~");
     }
     std::cout << "\n";
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->enemyCards[i] != nullptr ? "Health: " + std::to_string(this->enemyCards[i]->currHealth) : "~");
+            << (!this->enemyCards[i].isBlank() ? "Health: " + std::to_string(this->enemyCards[i].currHealth) : "~");
     }
     std::cout << "\n";
     std::cout << "\n\n";
@@ -138,9 +90,9 @@ void Board::print() const {
     std::cout << "Player Cards:\n";
 
     for (int i = 0; i < 5; i++) {
-        if (this->playerCards[i] != nullptr) {
+        if (!this->playerCards[i].isBlank()) {
             std::cout << std::left << std::setw(slotWidth)
-                << this->playerCards[i]->getType().name;
+                << this->playerCards[i].getType().name;
         }
         else {
             std::cout << std::left << std::setw(slotWidth) << "Empty";
@@ -150,172 +102,263 @@ void Board::print() const {
     // Print attributes
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->playerCards[i] != nullptr ? "Attack: " + std::to_string(this->playerCards[i]->attack) : "~");
+            << (!this->playerCards[i].isBlank() ? "Attack: " + std::to_string(this->playerCards[i].attack) : "~");
     }
     std::cout << "\n";
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->playerCards[i] != nullptr ? "Defense: " + std::to_string(this->playerCards[i]->defense) : "~");
+            << (!this->playerCards[i].isBlank() ? "Defense: " + std::to_string(this->playerCards[i].defense) : "~");
     }
     std::cout << "\n";
     for (int i = 0; i < 5; i++) {
         std::cout << std::left << std::setw(slotWidth)
-            << (this->playerCards[i] != nullptr ? "Health: " + std::to_string(this->playerCards[i]->currHealth) : "~");
+            << (!this->playerCards[i].isBlank() ? "Health: " + std::to_string(this->playerCards[i].currHealth) : "~");
     }
     std::cout << "\n\n";
     std::cout << "Player Hand:\n";
-    for (Card* card : this->playerHand) {
-        std::cout << card->getType().name << "\n";
+    for (int i = 0; i < this->playerHand.size(); i++) {
+        std::cout << getCardType(this->playerHand[i]).name << "\n";
     }
     std::cout << "\n";
     std::cout << "Player Deck: " << this->playerDeck.size() << " Cards\n";
     std::cout << "Player Health: " << this->playerHealth << "\n";
 }
 
-void Board::drawCard(bool isPlayer) {
-    std::vector<Card*>& deck = isPlayer ? this->playerDeck : this->enemyDeck;
-    std::vector<Card*>& hand = isPlayer ? this->playerHand : this->enemyHand;
+void GameState::drawCard(bool isPlayer, Rng& rng) {
+    Deck& deck = this->deck(isPlayer);
+    Hand& hand = this->hand(isPlayer);
     if (deck.empty()) {
-        std::cout << "Deck is empty\n";
+        logEvent<EventCode::DECK_EMPTY>(isPlayer);
         return;
     }
-    Card* card = deck[0];
-    deck.erase(deck.begin());
-    hand.push_back(card);
+    if (hand.full()) {
+        logEvent<EventCode::HAND_FULL>(isPlayer);
+        return;
+    }
+    CardID id = deck.draw(rng);
+    hand.push(id);
+    this->hash.piles += Zobrist::handKey(isPlayer, id) - Zobrist::deckKey(isPlayer, id);
+    logEvent<EventCode::CARD_DRAWN>(isPlayer, -1, id);
 }
 
-bool Board::playCard(bool isPlayer, int cardIndex, int pos) {
-    std::vector<Card*>& targetCards = isPlayer ? this->playerCards : this->enemyCards;
-    std::vector<Card*>& handCards = isPlayer ? this->playerHand : this->enemyHand;
+bool GameState::canGain(bool isPlayer) const {
+    int owned = this->deck(isPlayer).size() + this->hand(isPlayer).size();
+    for (int i = 0; i < slotCount; i++) {
+        owned += this->cards(isPlayer)[i].isBlank() ? 0 : 1;
+    }
+    return owned < Deck::capacity;
+}
+
+bool GameState::playCard(bool isPlayer, int cardIndex, int pos) {
+    Card* targetCards = this->cards(isPlayer);
+    Hand& handCards = this->hand(isPlayer);
 
     // Check if the position is valid
-    if (pos < 0 || pos >= 5) {
-        std::cout << "Invalid position\n";
+    if (pos < 0 || pos >= slotCount) {
+        logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, -1, INVALID_POSITION);
         return false;
     }
-    if (targetCards[pos] != nullptr) {
-        std::cout << "Position already occupied\n";
+    if (!targetCards[pos].isBlank()) {
+        logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, -1, POSITION_OCCUPIED);
         return false;
     }
     if (cardIndex < 0 || cardIndex >= handCards.size()) {
-        std::cout << "Invalid card index\n";
+        logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, -1, INVALID_CARD_INDEX);
         return false;
     }
 
     // All conditions met. Play card.
-    targetCards[pos] = handCards[cardIndex];
-    handCards.erase(handCards.begin() + cardIndex);
+    this->setCard(isPlayer, pos, Card(this->removeHand(isPlayer, cardIndex)));
     return true;
 }
 
-Director::Director() : board() {
-    this->startGame();
+Director::Director() : Director((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()) {}
+
+Director::Director(std::uint64_t seed) : state() {
+    this->startGame(seed);
 }
 
-void Director::initializeDecks() {
+Director::Director(const Director& other) {
+    *this = other;
+}
 
-    this->board.playerDeck.clear();
-    this->board.enemyDeck.clear();
+Director& Director::operator=(const Director& other) {
+    this->first = other.first;
+    this->state = other.state;
+    this->seed = other.seed;
+    for (int side = 0; side < 2; side++) {
+        this->deckRngs[side] = other.deckRngs[side];
+        this->shuffles[side] = other.shuffles[side];
+    }
+    this->policyRng = other.policyRng;
+    this->counter = nullptr;
+    return *this;
+}
 
-    for (const auto& card : Board::playerDeckRegistry) {
-        for (int i = 0; i < card.second; i++) {
-            this->board.playerDeck.push_back(new Card(Board::cardRegistry.at(card.first)));
+namespace {
+    GameState buildStartingState() {
+        GameState state;
+        const CardSet& set = activeCardSet;
+        for (int i = 0; i < set.playerDeckSize; i++) {
+            for (int copy = 0; copy < set.playerDeck[i].count; copy++) {
+                state.playerDeck.putBottom(set.playerDeck[i].id);
+            }
+        }
+        for (int i = 0; i < set.enemyDeckSize; i++) {
+            for (int copy = 0; copy < set.enemyDeck[i].count; copy++) {
+                state.enemyDeck.putBottom(set.enemyDeck[i].id);
+            }
         }
+        state.rehash();
+        return state;
     }
 
-    for (const auto& card : Board::enemyDeckRegistry) {
-        for (int i = 0; i < card.second; i++) {
-            this->board.enemyDeck.push_back(new Card(Board::cardRegistry.at(card.first)));
-        }
+    GameState& startingStorage() {
+        // Built from the active deck lists and shared by every game (and every thread) afterwards
+        static GameState start = buildStartingState();
+        return start;
     }
 }
 
+const GameState& Director::startingState() {
+    return startingStorage();
+}
+
+void Director::refreshStartingState() {
+    startingStorage() = buildStartingState();
+}
+
+void Director::initializeDecks() {
+    this->state.playerDeck = startingState().playerDeck;
+    this->state.enemyDeck = startingState().enemyDeck;
+    this->state.rehash();
+}
+
 void Director::startGame() {
-    this->board.resetAssault();
-    this->initializeDecks();
+    // Every card of the match lives inside the GameState, so resetting the whole match is a single copy.
+    this->state = startingState();
+    this->first = true;
+    this->shuffles[0] = this->shuffles[1] = 0;
     this->shuffleDeck(true);
     this->shuffleDeck(false);
+    if (this->counter) {
+        this->counter->reset(this->state);
+    }
 
     // Draw Cards
     this->drawCards(true, maxCards);
     this->drawCards(false, maxCards);
 }
+void Director::startGame(std::uint64_t seed) {
+    this->seed = seed;
+    this->policyRng = Rng(seed).jumped();
+    this->startGame();
+}
+
 void Director::endGame() {
-    std::cout << "Game ended\n";
+    logEvent<EventCode::GAME_ENDED>();
 }
 
 void Director::shuffleDeck(bool isPlayer) {
-    std::vector<Card*>* deck = isPlayer ? &this->board.playerDeck : &this->board.enemyDeck;
-    std::mt19937 rng(std::random_device{}());
-    std::shuffle(deck->begin(), deck->end(), rng);
+    this->deckRngs[isPlayer].seed(shuffleSeed(this->seed, isPlayer, this->shuffles[isPlayer]++));
+    this->state.deck(isPlayer).shuffle();
+    if (this->counter) {
+        this->counter->shuffled(isPlayer);
+    }
+}
+
+void Director::setCounter(CardCounter* counter) {
+    this->counter = counter;
+    if (counter) {
+        counter->reset(this->state);
+    }
+}
+
+void Director::countDraw(bool isPlayer) {
+    const Hand& hand = this->state.hand(isPlayer);
+    this->counter->drew(isPlayer, hand[hand.size() - 1]);
 }
 
 bool Director::playCard(bool isPlayer, int cardIndex, int pos) {
-    Card* card = isPlayer ? this->board.playerHand[cardIndex] : this->board.enemyHand[cardIndex];
+    const Hand& hand = this->state.hand(isPlayer);
+    if (pos < 0 || pos >= GameState::slotCount) {
+        logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, -1, INVALID_POSITION);
+        return false;
+    }
+    if (cardIndex < 0 || cardIndex >= hand.size()) {
+        logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, -1, INVALID_CARD_INDEX);
+        return false;
+    }
+    const CardType& type = getCardType(hand[cardIndex]);
 
     // Detect if the card is placed on defense or not. On defense, cards can only be placed to block other cards
     if ((isPlayer && !first) || (!isPlayer && first)) {
-        Card* oppositeCard = isPlayer ? board.enemyCards[pos] : board.playerCards[pos];
+        const Card& oppositeCard = this->state.cards(!isPlayer)[pos];
 
         // Check if card has ATTACK_ONLY condition
-        if (card->getType().condition == ATTACK_ONLY) {
-            std::cout << "Cannot play card with ATTACK_ONLY condition on defense\n";
+        if (!type.has(FLAG_CAN_DEFEND)) {
+            logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, type.id, ATTACK_ONLY_ON_DEFENSE);
             return false;
         }
 
         // No attacking card. On defense, cards can only be placed to block other cards
-        if (oppositeCard == nullptr) {
-            std::cout << "No attacking card\n";
+        if (oppositeCard.isBlank()) {
+            logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, type.id, NO_ATTACKER);
             return false;
         }
 
         // Check if attacking card has the SURPRISE special ability
-        else if (oppositeCard->getType().special == SURPRISE && card->getType().condition != DEFENSE_ONLY) {
-            std::cout << "Cannot play card on defense against attacking card with SURPRISE special ability\n";
+        else if (oppositeCard.getType().has(FLAG_SURPRISE) && type.condition != DEFENSE_ONLY) {
+            logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, type.id, SURPRISE_ATTACKER);
             return false;
         }
     }
     else { // On attack, cards can be placed anywhere
         // Check if card has DEFENSE_ONLY condition
-        if (card->getType().condition == DEFENSE_ONLY) {
-            std::cout << "Cannot play card with DEFENSE_ONLY condition on attack\n";
+        if (!type.has(FLAG_CAN_ATTACK)) {
+            logEvent<EventCode::PLAY_REJECTED>(isPlayer, pos, type.id, DEFENSE_ONLY_ON_ATTACK);
             return false;
         }
     }
 
 
-    if (this->board.playCard(isPlayer, cardIndex, pos)) {
+    if (this->state.playCard(isPlayer, cardIndex, pos)) {
+        logEvent<EventCode::CARD_PLAYED>(isPlayer, pos, type.id);
+        if (this->counter) {
+            this->counter->played(isPlayer, type.id);
+        }
 
         // Card played successfully. Apply special abilities if any
-        switch (card->getType().special) {
+        switch (type.special) {
         case RALLY: // Alias of the INSPIRE ability
         case INSPIRE: {
-            std::cout << "Inspiring card played\n";
+            logEvent<EventCode::INSPIRE_PLAYED>(isPlayer, pos, type.id);
             // Apply the INSPIRE special ability
-            for (int i = 0; i < 5; i++) {
-                if (this->board.playerCards[i] != nullptr) {
-                    this->board.playerCards[i]->attack += 1;
+            for (int i = 0; i < GameState::slotCount; i++) {
+                if (!this->state.playerCards[i].isBlank()) {
+                    Card buffed = this->state.playerCards[i];
+                    buffed.attack += 1;
+                    this->state.setCard(true, i, buffed);
                 }
             }
             break;
         }
 
         case REINFORCE: {
-            std::cout << "Reinforce card played\n";
-
-            // Look up card types
-            const auto& registry = Board::getCardRegistry();
-
-            // Decide whose hand to augment
-            auto& hand = isPlayer
-                ? board.playerHand
-                : board.enemyHand;
+            logEvent<EventCode::REINFORCE_PLAYED>(isPlayer, pos, type.id);
 
-            // Add 1× Eomer
-            hand.push_back(new Card(registry.at(EOMER)));
-            // Add 2× Cavalry
-            hand.push_back(new Card(registry.at(CAVALRY)));
-            hand.push_back(new Card(registry.at(CAVALRY)));
+            // Add 1x Eomer and 2x Cavalry. Hand is sized so they always fit, but a card that didn't would be reported, not lost unseen
+            for (CardID id : { EOMER, CAVALRY, CAVALRY }) {
+                if (!this->state.canGain(isPlayer)) {
+                    logEvent<EventCode::DECK_FULL>(isPlayer, -1, id);
+                }
+                else if (!this->state.pushHand(isPlayer, id)) {
+                    logEvent<EventCode::HAND_FULL>(isPlayer, -1, id);
+                }
+                else if (this->counter) {
+                    this->counter->gained(isPlayer, id);
+                }
+            }
             break;
         }
 
@@ -326,56 +369,59 @@ bool Director::playCard(bool isPlayer, int cardIndex, int pos) {
         return true;
     }
     else {
-        std::cout << "Failed to play card\n";
+        // GameState::playCard already reported why
         return false;
     }
 }
 
 void Director::discardCard(bool isPlayer, int boardIndex) {
-    auto& slots = isPlayer ? board.playerCards : board.enemyCards;
-    if (boardIndex < 0 || boardIndex >= slots.size()) {
-        std::cout << "Invalid board index\n";
+    Card* slots = this->state.cards(isPlayer);
+    if (boardIndex < 0 || boardIndex >= GameState::slotCount) {
+        logEvent<EventCode::DISCARD_REJECTED>(isPlayer, boardIndex, -1, INVALID_POSITION);
         return;
     }
 
-    Card* dead = slots[boardIndex];
-    if (dead == nullptr) {
-        std::cout << "No card to discard\n";
+    const Card& dead = slots[boardIndex];
+    if (dead.isBlank()) {
+        logEvent<EventCode::DISCARD_REJECTED>(isPlayer, boardIndex, -1, NO_CARD_TO_DISCARD);
         return;
     }
 
-    // Clear the board slot
-    slots[boardIndex] = nullptr;
-
-    // Put the card on the bottom of its owner's deck
-    auto& deck = isPlayer ? board.playerDeck : board.enemyDeck;
-
-    // Reset stats
-    dead->attack = dead->getType().attack;
-    dead->currHealth = dead->getType().maxHealth;
-    dead->defense = dead->getType().defense;
+    // Put the card on the bottom of its owner's deck. Cards off the board always carry their default stats, so only the ID is kept.
+    // There is always room, as a side never owns more cards than its deck holds (see GameState::canGain)
+    if (!this->state.putBottom(isPlayer, dead.getID())) {
+        logEvent<EventCode::DECK_FULL>(isPlayer, boardIndex, dead.getID());
+    }
+    else if (this->counter) {
+        this->counter->returned(isPlayer, dead.getID());
+    }
 
-    deck.push_back(dead);
+    // Clear the board slot
+    this->state.setCard(isPlayer, boardIndex, Card());
 }
 
 void Director::drawCards(bool isPlayer, int targetCards) {
-    std::vector<Card*>& deck = isPlayer ? this->board.playerDeck : this->board.enemyDeck;
-    std::vector<Card*>& hand = isPlayer ? this->board.playerHand : this->board.enemyHand;
+    const Deck& deck = this->state.deck(isPlayer);
+    const Hand& hand = this->state.hand(isPlayer);
     while (hand.size() < targetCards && !deck.empty()) {
         drawCard(isPlayer);
     }
 }
 
 void Director::applyAssaultAbilities(Card* attacker, Card* defender) {
+    // Which side and slot the attacker is in, for the event log
+    bool isPlayer = attacker >= this->state.playerCards && attacker < this->state.playerCards + GameState::slotCount;
+    int slot = static_cast<int>(attacker - this->state.cards(isPlayer));
+
     switch (attacker->getType().special) {
     case ARMOR_PIERCE: {
-        std::cout << "Armor Pierce card applied\n";
+        logEvent<EventCode::ABILITY_APPLIED>(isPlayer, slot, attacker->getID(), ARMOR_PIERCE);
         // Apply the ARMOR_PIERCE special ability
         defender->defense = 0; // Set enemy card's defense to 0
         break;
     };
     case HATE: {
-        std::cout << "Hate card applied\n";
+        logEvent<EventCode::ABILITY_APPLIED>(isPlayer, slot, attacker->getID(), HATE);
         // Apply the HATE special ability
         switch (defender->getType().id) {
         case CAVALRY:
@@ -391,7 +437,7 @@ void Director::applyAssaultAbilities(Card* attacker, Card* defender) {
         break;
     };
     case KAMIKAZE: {
-        std::cout << "Kamikaze card applied\n";
+        logEvent<EventCode::ABILITY_APPLIED>(isPlayer, slot, attacker->getID(), KAMIKAZE);
         // Apply the KAMIKAZE special ability
         attacker->currHealth = 0; // Destroy the card
         defender->currHealth = 0; // Destroy the defending card
@@ -402,23 +448,96 @@ void Director::applyAssaultAbilities(Card* attacker, Card* defender) {
 }
 
 bool Director::turnAttack() {
-    for (int i = 0; i < 5; i++) {
-        Card* enemyCard = this->board.enemyCards[i];
-        Card* playerCard = this->board.playerCards[i];
+    AssaultLanes lanes;
+    packAssault(this->state, lanes);
+    resolveAssault(lanes);
+
+    // Apply the kernel's results slot by slot, in the same order (and with the same events) as turnAttackReference
+    int faceDamageToPlayer = 0;
+    int faceDamageToEnemy = 0;
+    for (int i = 0; i < GameState::slotCount; i++) {
+        Card& playerCard = this->state.playerCards[i];
+        Card& enemyCard = this->state.enemyCards[i];
+        faceDamageToPlayer += lanes.faceDamageToPlayer[i];
+        faceDamageToEnemy += lanes.faceDamageToEnemy[i];
+
+        if (!lanes.playerPresent[i] || !lanes.enemyPresent[i]) {
+            if (lanes.enemyPresent[i]) {
+                logEvent<EventCode::FACE_HIT>(false, i, enemyCard.getID(), enemyCard.attack);
+            }
+            else if (lanes.playerPresent[i]) {
+                logEvent<EventCode::FACE_HIT>(true, i, playerCard.getID(), playerCard.attack);
+            }
+            continue;
+        }
+
+        SpecialAbility playerSpecial = playerCard.getType().special;
+        SpecialAbility enemySpecial = enemyCard.getType().special;
+        if (playerSpecial == ARMOR_PIERCE || playerSpecial == HATE || playerSpecial == KAMIKAZE) {
+            logEvent<EventCode::ABILITY_APPLIED>(true, i, playerCard.getID(), playerSpecial);
+        }
+        if (enemySpecial == ARMOR_PIERCE || enemySpecial == HATE || enemySpecial == KAMIKAZE) {
+            logEvent<EventCode::ABILITY_APPLIED>(false, i, enemyCard.getID(), enemySpecial);
+        }
+        logEvent<EventCode::CARD_DAMAGED>(true, i, playerCard.getID(), lanes.damageToPlayerCard[i], lanes.overflowToPlayer[i]);
+        logEvent<EventCode::CARD_DAMAGED>(false, i, enemyCard.getID(), lanes.damageToEnemyCard[i], lanes.overflowToEnemy[i]);
+        if (lanes.fatigue[i]) {
+            logEvent<EventCode::FATIGUE>(false, i);
+        }
+
+        // Remove dead cards, reset the stats of survivors for next round
+        Card player = playerCard;
+        Card enemy = enemyCard;
+        player.currHealth = static_cast<std::int16_t>(lanes.playerHealth[i]);
+        enemy.currHealth = static_cast<std::int16_t>(lanes.enemyHealth[i]);
+        if (lanes.playerDead[i]) {
+            logEvent<EventCode::CARD_DIED>(true, i, player.getID());
+            this->state.setCard(true, i, player);
+            discardCard(true, i);
+        }
+        else {
+            player.attack = static_cast<std::int16_t>(player.getType().attack);
+            player.defense = static_cast<std::int16_t>(player.getType().defense);
+            this->state.setCard(true, i, player);
+        }
+        if (lanes.enemyDead[i]) {
+            logEvent<EventCode::CARD_DIED>(false, i, enemy.getID());
+            this->state.setCard(false, i, enemy);
+            discardCard(false, i);
+        }
+        else {
+            enemy.attack = static_cast<std::int16_t>(enemy.getType().attack);
+            enemy.defense = static_cast<std::int16_t>(enemy.getType().defense);
+            this->state.setCard(false, i, enemy);
+        }
+    }
+
+    this->state.setHealth(true, this->state.playerHealth - faceDamageToPlayer);
+    this->state.setHealth(false, this->state.enemyHealth - faceDamageToEnemy);
+
+    return finishAssault();
+}
+
+bool Director::turnAttackReference() {
+    for (int i = 0; i < GameState::slotCount; i++) {
+        Card* enemyCard = &this->state.enemyCards[i];
+        Card* playerCard = &this->state.playerCards[i];
 
         // Nothing in this slot
-        if (enemyCard == nullptr && playerCard == nullptr) {
+        if (enemyCard->isBlank() && playerCard->isBlank()) {
             continue;
         }
 
         // Enemy hits face-up
-        if (playerCard == nullptr) {
-            board.playerHealth -= enemyCard->attack;
+        if (playerCard->isBlank()) {
+            logEvent<EventCode::FACE_HIT>(false, i, enemyCard->getID(), enemyCard->attack);
+            state.playerHealth -= enemyCard->attack;
             continue;
         }
         // Player hits face-up
-        else if (enemyCard == nullptr) {
-            board.enemyHealth -= playerCard->attack;
+        else if (enemyCard->isBlank()) {
+            logEvent<EventCode::FACE_HIT>(true, i, playerCard->getID(), playerCard->attack);
+            state.enemyHealth -= playerCard->attack;
             continue;
         }
 
@@ -441,44 +560,57 @@ bool Director::turnAttack() {
         // Compute overflow (only if damage exceeded remaining card HP)
         int overflowToPlayer = std::max(0, dmgToPlayerCard - prevPlayerHP);
         int overflowToEnemy = std::max(0, dmgToEnemyCard - prevEnemyHP);
+        logEvent<EventCode::CARD_DAMAGED>(true, i, playerCard->getID(), dmgToPlayerCard, overflowToPlayer);
+        logEvent<EventCode::CARD_DAMAGED>(false, i, enemyCard->getID(), dmgToEnemyCard, overflowToEnemy);
 
         // Fatigue of war stalemate
         if (dmgToPlayerCard == 0 && dmgToEnemyCard == 0) {
-            std::cout << "Stalemate detected. Applying fatigue of war.\n";
+            logEvent<EventCode::FATIGUE>(false, i);
             playerCard->currHealth -= 1;
             enemyCard->currHealth -= 1;
         }
 
         // Remove dead cards
         if (playerCard->currHealth <= 0) {
+            logEvent<EventCode::CARD_DIED>(true, i, playerCard->getID());
             discardCard(true, i);
         }
         if (enemyCard->currHealth <= 0) {
+            logEvent<EventCode::CARD_DIED>(false, i, enemyCard->getID());
             discardCard(false, i);
         }
 
         // Apply any spill-over to player/enemy health
-        if (overflowToPlayer > 0) board.playerHealth -= overflowToPlayer;
-        if (overflowToEnemy > 0) board.enemyHealth -= overflowToEnemy;
+        if (overflowToPlayer > 0) state.playerHealth -= overflowToPlayer;
+        if (overflowToEnemy > 0) state.enemyHealth -= overflowToEnemy;
 
-        // Reset stats for next round
-        enemyCard->attack = enemyCard->getType().attack;
-        playerCard->attack = playerCard->getType().attack;
-        enemyCard->defense = enemyCard->getType().defense;
-        playerCard->defense = playerCard->getType().defense;
+        // Reset stats of the survivors for next round (discarded slots are blank now)
+        if (!enemyCard->isBlank()) {
+            enemyCard->attack = enemyCard->getType().attack;
+            enemyCard->defense = enemyCard->getType().defense;
+        }
+        if (!playerCard->isBlank()) {
+            playerCard->attack = playerCard->getType().attack;
+            playerCard->defense = playerCard->getType().defense;
+        }
     }
 
+    // The slots and health were edited in place above, so the board part of the hash is stale
+    this->state.rehashBoard();
+    return finishAssault();
+}
+
+bool Director::finishAssault() {
     shuffleDeck(true);
     shuffleDeck(false);
 
     // Check for game over
-    if (board.playerHealth > 0 && board.enemyHealth > 0) {
-        return true;
-    }
-    else {
+    bool isRunning = state.playerHealth > 0 && state.enemyHealth > 0;
+    if (!isRunning) {
         // Clamp to zero
-        board.playerHealth = std::max(0, board.playerHealth);
-        board.enemyHealth = std::max(0, board.enemyHealth);
-        return false;
+        state.setHealth(true, std::max<std::int16_t>(0, state.playerHealth));
+        state.setHealth(false, std::max<std::int16_t>(0, state.enemyHealth));
     }
+    logEvent<EventCode::ASSAULT_ENDED>(false, -1, -1, state.playerHealth, state.enemyHealth);
+    return isRunning;
 }
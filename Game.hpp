@@ -5,9 +5,15 @@ For game rules, see Rules.txt
 
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <vector>
-#include <map>
+#include <string_view>
+#include <type_traits>
+
+#include "Random.hpp"
+#include "Zobrist.hpp"
+
+class CardCounter;
 
 enum CardID {
     BLANK = -1, // Blank card
@@ -32,6 +38,8 @@ enum CardID {
     BERSERKER,
     BATTERING_RAM,
     FELGROM,
+
+    CARD_COUNT, // Number of card types
 };
 
 enum SpecialAbility {
@@ -47,14 +55,56 @@ enum SpecialAbility {
     ARMOR_PIERCE,
     HATE,
     KAMIKAZE,
+
+    ABILITY_COUNT, // Number of abilities
 };
 
 enum PlayCondition {
     FREE,
     ATTACK_ONLY,
     DEFENSE_ONLY,
+
+    CONDITION_COUNT, // Number of play conditions
+};
+
+/**
+ * @brief CardFlags packs a card type's ability and play condition into bits, so rules can test them with a single AND.
+ */
+enum CardFlags : std::uint16_t {
+    FLAG_SURPRISE = 1 << 0,
+    FLAG_INSPIRE = 1 << 1, // INSPIRE or RALLY. Both buff the player's board
+    FLAG_REINFORCE = 1 << 2,
+    FLAG_ARMOR_PIERCE = 1 << 3,
+    FLAG_HATE = 1 << 4,
+    FLAG_KAMIKAZE = 1 << 5,
+    FLAG_CAN_ATTACK = 1 << 6, // Not DEFENSE_ONLY
+    FLAG_CAN_DEFEND = 1 << 7, // Not ATTACK_ONLY
+
+    FLAG_ON_PLAY = FLAG_SURPRISE | FLAG_INSPIRE | FLAG_REINFORCE,
+    FLAG_ON_ASSAULT = FLAG_ARMOR_PIERCE | FLAG_HATE | FLAG_KAMIKAZE,
 };
 
+constexpr std::uint16_t cardFlags(SpecialAbility special, PlayCondition condition) {
+    std::uint16_t flags = 0;
+    switch (special) {
+    case SURPRISE: flags |= FLAG_SURPRISE; break;
+    case INSPIRE:
+    case RALLY: flags |= FLAG_INSPIRE; break;
+    case REINFORCE: flags |= FLAG_REINFORCE; break;
+    case ARMOR_PIERCE: flags |= FLAG_ARMOR_PIERCE; break;
+    case HATE: flags |= FLAG_HATE; break;
+    case KAMIKAZE: flags |= FLAG_KAMIKAZE; break;
+    default: break;
+    }
+    if (condition != DEFENSE_ONLY) {
+        flags |= FLAG_CAN_ATTACK;
+    }
+    if (condition != ATTACK_ONLY) {
+        flags |= FLAG_CAN_DEFEND;
+    }
+    return flags;
+}
+
 
 /**
  * @brief The CardType struct defines the attributes of a card type.
@@ -64,74 +114,387 @@ enum PlayCondition {
  */
 typedef struct CardType {
     CardID id = BLANK; // Default
-    std::string name = "NULL"; // Default to Strider
+    std::string_view name = "NULL"; // Default to Strider
     int maxHealth = 0;
     int attack = 0;
     int defense = 0;
     SpecialAbility special = NONE; // Default none
     PlayCondition condition = FREE; // Default free
+    std::uint16_t flags = cardFlags(NONE, FREE); // Derived from special and condition
+
+    constexpr CardType() = default;
+    constexpr CardType(CardID id, std::string_view name, int maxHealth, int attack, int defense, SpecialAbility special = NONE, PlayCondition condition = FREE)
+        : id(id), name(name), maxHealth(maxHealth), attack(attack), defense(defense), special(special), condition(condition), flags(cardFlags(special, condition)) {}
+
+    constexpr bool has(CardFlags flag) const { return (flags & flag) != 0; }
 } CardType;
 
+/**
+ * @brief The Card Registry is the built-in table of all the card types and their attributes, indexed by CardID.
+ * It is built at compile time and lives in read-only memory. The game normally plays with the definitions from CardDefinitions.txt
+ * (see CardDatabase), and falls back to this table when they can't be loaded.
+ * The general format is:
+ *
+ * {CardID, "Name", maxHealth, attack, defense, specialAbility, playCondition}
+ */
+inline constexpr CardType cardRegistry[CARD_COUNT] = {
+    {STRIDER, "Strider", 7, 7, 2, INSPIRE},
+    {ELVEN_PRINCE, "Elven Prince", 4, 9, 0, ARMOR_PIERCE},
+    {RECRUIT, "Recruit", 3, 2, 2},
+    {ELVEN_SOLDIER, "Elf Soldier", 4, 4, 0, ARMOR_PIERCE},
+    {LOCKBEARER, "Lockbearer", 10, 6, 4, INSPIRE, DEFENSE_ONLY},
+    {THE_WHITE, "The White", 24, 8, 0, REINFORCE},
+    {KING, "The King", 9, 5, 5, INSPIRE},
+
+    {EOMER, "Eomer", 5, 6, 2, INSPIRE},
+    {CAVALRY, "Cavalry", 5, 5, 2, SURPRISE},
+
+    {URUK, "Uruk-Hai", 3, 5, 1},
+    {ORC, "Orc", 3, 4, 0},
+    {DUNLENDING, "Dunlending", 3, 3, 1, HATE},
+    {BERSERKER, "Berserker", 9, 6, 3, RALLY},
+    {BATTERING_RAM, "Battering Ram", 2, 10, 1, SURPRISE, ATTACK_ONLY},
+    {FELGROM, "Felgrom", 1, 0, 20, KAMIKAZE, ATTACK_ONLY},
+};
+
+/**
+ * @brief A DeckEntry is one line of a deck list: how many copies of a card the deck starts with.
+ */
+typedef struct DeckEntry {
+    CardID id;
+    int count;
+} DeckEntry;
+
+inline constexpr DeckEntry playerDeckRegistry[] = {
+    {STRIDER, 2},
+    {ELVEN_PRINCE, 2},
+    {RECRUIT, 20},
+    {ELVEN_SOLDIER, 10},
+    {LOCKBEARER, 2},
+    {THE_WHITE, 1},
+    {KING, 1},
+};
+
+inline constexpr DeckEntry enemyDeckRegistry[] = {
+    {URUK, 10},
+    {ORC, 15},
+    {DUNLENDING, 10},
+    {BERSERKER, 8},
+    {BATTERING_RAM, 2},
+    {FELGROM, 2},
+};
+
+// Every CardID has its own entry, at its own index, with a name and a positive max health
+constexpr bool cardRegistryComplete() {
+    for (int i = 0; i < CARD_COUNT; i++) {
+        const CardType& type = cardRegistry[i];
+        if (type.id != i || type.name.empty() || type.name == "NULL" || type.maxHealth <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t Size>
+constexpr int deckRegistrySize(const DeckEntry (&entries)[Size]) {
+    int total = 0;
+    for (const DeckEntry& entry : entries) {
+        if (entry.id <= BLANK || entry.id >= CARD_COUNT || entry.count <= 0) {
+            return -1;
+        }
+        total += entry.count;
+    }
+    return total;
+}
+
+static_assert(cardRegistryComplete(), "Card registry entries must be in CardID order, named and have health");
+
+/**
+ * @brief CardSet is the card table and deck lists the rules run on. It points at the built-in registries until
+ * CardDatabase::load swaps in loaded definitions, which happens once at startup before any game (or thread) starts.
+ */
+typedef struct CardSet {
+    const CardType* cards = cardRegistry; // CARD_COUNT entries, indexed by CardID
+    const DeckEntry* playerDeck = playerDeckRegistry;
+    int playerDeckSize = static_cast<int>(sizeof(playerDeckRegistry) / sizeof(playerDeckRegistry[0]));
+    const DeckEntry* enemyDeck = enemyDeckRegistry;
+    int enemyDeckSize = static_cast<int>(sizeof(enemyDeckRegistry) / sizeof(enemyDeckRegistry[0]));
+} CardSet;
+
+inline CardSet activeCardSet;
+
+// Looking up a card type is a single indexed load
+inline const CardType& getCardType(CardID id) {
+    return activeCardSet.cards[id];
+}
+
+/**
+ * @brief A Card is one card in play, in a hand or in a deck. It is a small value type (8 bytes) so it can live directly inside a GameState.
+ * The permanent attributes are looked up from the card registry through the card's ID, only the temporary stats are stored per card.
+ * A default-constructed Card is BLANK and marks an empty board slot.
+ */
 class Card {
 public:
-    Card(CardType type);
-    ~Card() = default;
+    Card() = default;
+    constexpr Card(const CardType& type) : currHealth(static_cast<std::int16_t>(type.maxHealth)), attack(static_cast<std::int16_t>(type.attack)),
+        defense(static_cast<std::int16_t>(type.defense)), id(static_cast<std::int8_t>(type.id)) {}
+    Card(CardID id) : Card(getCardType(id)) {}
 
     // Temporary stats. These can change depending on conditions (armor shredding, buffing, etc.)
 
-    // Current health (int)
-    int currHealth;
+    // Current health
+    std::int16_t currHealth = 0;
     // Temporary Attack stat
-    int attack;
+    std::int16_t attack = 0;
     // Temporary Defense stat
-    int defense;
+    std::int16_t defense = 0;
+
+    const CardType& getType() const { return getCardType(getID()); }
+    CardID getID() const { return static_cast<CardID>(id); }
+    bool isBlank() const { return id == BLANK; }
 
-    const CardType& getType() const { return type; }
+    bool operator==(const Card& other) const = default;
 
 private:
-    CardType type;
+    std::int8_t id = BLANK;
+};
+
+
+/**
+ * @brief CardList is a fixed-capacity list of card IDs, used for hands.
+ * Cards outside of the board always have their default stats, so only their ID needs to be stored.
+ */
+template <int Capacity>
+struct CardList {
+    static const int capacity = Capacity;
+
+    std::int8_t cards[Capacity] = {};
+    std::uint8_t count = 0;
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count >= Capacity; }
+    CardID operator[](int index) const { return static_cast<CardID>(cards[index]); }
+
+    // Adds a card to the back of the list. Returns false if the list is full.
+    bool push(CardID id) {
+        if (full()) {
+            return false;
+        }
+        cards[count++] = static_cast<std::int8_t>(id);
+        return true;
+    }
+
+    // Removes the card at index, keeping the order of the remaining cards.
+    CardID remove(int index) {
+        CardID id = (*this)[index];
+        for (int i = index; i < count - 1; i++) {
+            cards[i] = cards[i + 1];
+        }
+        count--;
+        return id;
+    }
+
+    // Inserts a card at index, moving the cards from index on back by one. The list must not be full.
+    void insert(int index, CardID id) {
+        for (int i = count; i > index; i--) {
+            cards[i] = cards[i - 1];
+        }
+        cards[index] = static_cast<std::int8_t>(id);
+        count++;
+    }
+
+    // Removes the last card and puts back the byte push() overwrote, for undoing moves (see Moves.hpp)
+    void pop(std::int8_t spare) { cards[--count] = spare; }
+
+    void clear() { count = 0; }
+
+    bool operator==(const CardList& other) const = default;
 };
 
+/**
+ * Hands are refilled to Director::maxCards, and a draw is the only way a REINFORCE card gets in (CardDatabase keeps the cards it brings from
+ * having REINFORCE themselves). Playing one out of a full hand of them nets 2 cards each, so a hand never holds more than 3 * Director::maxCards.
+ */
+typedef CardList<21> Hand;
+
 
 /**
- * @brief The Board class is responsible for managing the game state, including the player's and enemy's cards, health, and deck.
- * It is manipulated and used by the Director class. Additionally, Director is a friend class of Board.
+ * @brief The Deck class is a fixed-capacity ring buffer of card IDs with O(1) draw from the top and O(1) insertion at the bottom.
+ * Shuffling is lazy: shuffle() only marks the cards currently in the deck as shuffled, and each draw then picks a uniformly random card among the
+ * shuffled cards still left (one step of Fisher-Yates). The order cards are drawn in is the same uniform permutation a full shuffle would give,
+ * but only the cards that are actually drawn are paid for.
+ * Cards put on the bottom after a shuffle stay below every shuffled card, exactly as with an eager shuffle.
  */
-class Board {
+class Deck {
 public:
-    int enemyHealth = 40;
-    int playerHealth = 40;
+    static const int capacity = 128; // Every card a side owns fits back in, as REINFORCE stops there (see GameState::canGain). Must be a power of two
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count >= capacity; }
+
+    // Card at position index, counted from the top. Cards inside the shuffled region are in no particular order.
+    CardID operator[](int index) const { return static_cast<CardID>(cards[(head + index) & mask]); }
+
+    // Puts a card on the bottom of the deck. Returns false if the deck is full.
+    bool putBottom(CardID id) {
+        if (full()) {
+            return false;
+        }
+        cards[(head + count) & mask] = static_cast<std::int8_t>(id);
+        count++;
+        return true;
+    }
+
+    // Takes the top card of the deck. The deck must not be empty.
+    CardID draw(Rng& rng) {
+        if (shuffled > 1) {
+            // Swap a uniformly random shuffled card to the top before taking it
+            int pick = rng.below(shuffled);
+            std::swap(cards[head], cards[(head + pick) & mask]);
+        }
+        if (shuffled > 0) {
+            shuffled--;
+        }
+        CardID id = static_cast<CardID>(cards[head]);
+        head = (head + 1) & mask;
+        count--;
+        return id;
+    }
+
+    // Shuffles the whole deck. O(1): the actual work is done by draw().
+    void shuffle() { shuffled = count; }
+
+    // Undo support for search (see Moves.hpp), so a deck can be put back exactly as it was without copying it.
+    // spare() is the raw byte the offset-th next putBottom will overwrite, takeBottom removes the bottom card and puts that byte back.
+    std::int8_t spare(int offset = 0) const { return cards[(head + count + offset) & mask]; }
+    void takeBottom(std::int8_t spare) {
+        count--;
+        cards[(head + count) & mask] = spare;
+    }
+    int pendingShuffle() const { return shuffled; }
+    void setPendingShuffle(int pending) { shuffled = static_cast<std::uint8_t>(pending); }
+
+    void clear() {
+        head = 0;
+        count = 0;
+        shuffled = 0;
+    }
+
+    bool operator==(const Deck& other) const = default;
+
+private:
+    static const int mask = capacity - 1;
+    static_assert((capacity & mask) == 0, "Deck capacity must be a power of two");
+
+    std::int8_t cards[capacity] = {};
+    std::uint8_t head = 0; // Index of the top card
+    std::uint8_t count = 0;
+    std::uint8_t shuffled = 0; // Number of cards from the top that are still waiting to be shuffled into place
+};
+
+static_assert(deckRegistrySize(playerDeckRegistry) > 0 && deckRegistrySize(playerDeckRegistry) <= Deck::capacity, "Player deck list must be valid and fit in a Deck");
+static_assert(deckRegistrySize(enemyDeckRegistry) > 0 && deckRegistrySize(enemyDeckRegistry) <= Deck::capacity, "Enemy deck list must be valid and fit in a Deck");
+
+
+/**
+ * @brief The GameState struct holds the complete state of a game: the board slots, hands, decks and health of both sides.
+ * It is a fixed-size, trivially copyable value type (a few hundred bytes), so a whole game can be snapshotted or copied with a single memcpy.
+ * It is manipulated and used by the Director class.
+ */
+struct GameState {
+    static constexpr int slotCount = 5; // Board slots per side
+
+    std::int16_t enemyHealth = 40;
+    std::int16_t playerHealth = 40;
+
+    Card enemyCards[slotCount]; // Cards in Play. BLANK cards mark empty slots
+    Card playerCards[slotCount];
+
+    Hand enemyHand; // Cards inside hand
+    Hand playerHand;
+
+    Deck enemyDeck; // Cards in deck
+    Deck playerDeck;
+
+    StateHash hash; // Zobrist hash of everything above. Kept up to date by the mutators below, so rules code must change the state through them
 
-    Board();
-    ~Board();
     void resetAssault();
     void print() const;
 
-    void drawCard(bool isPlayer);
-    bool playCard(bool isPlayer, int cardIndex, int pos);
+    bool operator==(const GameState& other) const = default;
 
-    const static std::map<CardID, CardType>& getCardRegistry() { return cardRegistry; }
+    void drawCard(bool isPlayer, Rng& rng);
+    bool playCard(bool isPlayer, int cardIndex, int pos);
 
-private:
-    friend class Director;
+    // Side accessors, so rules can be written once for both sides
+    Card* cards(bool isPlayer) { return isPlayer ? playerCards : enemyCards; }
+    const Card* cards(bool isPlayer) const { return isPlayer ? playerCards : enemyCards; }
+    Hand& hand(bool isPlayer) { return isPlayer ? playerHand : enemyHand; }
+    const Hand& hand(bool isPlayer) const { return isPlayer ? playerHand : enemyHand; }
+    Deck& deck(bool isPlayer) { return isPlayer ? playerDeck : enemyDeck; }
+    const Deck& deck(bool isPlayer) const { return isPlayer ? playerDeck : enemyDeck; }
+    std::int16_t& health(bool isPlayer) { return isPlayer ? playerHealth : enemyHealth; }
+    std::int16_t health(bool isPlayer) const { return isPlayer ? playerHealth : enemyHealth; }
+
+    // Mutators that keep the hash up to date. Each is a couple of XORs or additions on top of the change itself
+    void setCard(bool isPlayer, int slot, const Card& card) {
+        Card& current = this->cards(isPlayer)[slot];
+        this->hash.board ^= slotKey(isPlayer, slot, current) ^ slotKey(isPlayer, slot, card);
+        current = card;
+    }
+    void setHealth(bool isPlayer, int value) {
+        std::int16_t& current = this->health(isPlayer);
+        this->hash.board ^= Zobrist::healthKey(isPlayer, current) ^ Zobrist::healthKey(isPlayer, value);
+        current = static_cast<std::int16_t>(value);
+    }
+    bool pushHand(bool isPlayer, CardID id) {
+        if (!this->hand(isPlayer).push(id)) {
+            return false;
+        }
+        this->hash.piles += Zobrist::handKey(isPlayer, id);
+        return true;
+    }
+    // Whether the side may be given another card. Every card a side owns must fit back in its deck, so REINFORCE stops at Deck::capacity cards
+    bool canGain(bool isPlayer) const;
+    CardID removeHand(bool isPlayer, int index) {
+        CardID id = this->hand(isPlayer).remove(index);
+        this->hash.piles -= Zobrist::handKey(isPlayer, id);
+        return id;
+    }
+    bool putBottom(bool isPlayer, CardID id) {
+        if (!this->deck(isPlayer).putBottom(id)) {
+            return false;
+        }
+        this->hash.piles += Zobrist::deckKey(isPlayer, id);
+        return true;
+    }
 
-    std::vector<Card*> enemyCards; // Cards in Play
-    std::vector<Card*> playerCards;
+    /**
+     * @brief zobrist is the 64-bit hash of this state with Director::first. Equal states always hash equally, whatever moves led to them.
+     */
+    std::uint64_t zobrist(bool first) const { return this->hash.value(first); }
 
-    std::vector<Card*> enemyHand; // Cards inside hand
-    std::vector<Card*> playerHand;
+    // Hash computed from scratch. Always equal to hash; used to set it up and to check the incremental updates
+    StateHash computeHash() const;
+    void rehash() { this->hash = this->computeHash(); }
+    // Recomputes only the board part, for code that edited the board slots or health directly
+    void rehashBoard() { this->hash.board = this->computeHash().board; }
 
-    std::vector<Card*> enemyDeck; // Cards in deck
-    std::vector<Card*> playerDeck;
-    static std::map<CardID, CardType> cardRegistry;
-    static std::map<CardID, int> playerDeckRegistry;
-    static std::map<CardID, int> enemyDeckRegistry;
+    static std::uint64_t slotKey(bool isPlayer, int slot, const Card& card) {
+        return Zobrist::slotKey(isPlayer, slot, card.getID(), card.attack, card.defense, card.currHealth);
+    }
 };
 
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState must be copyable with memcpy");
+static_assert(sizeof(GameState) <= 512, "GameState should stay small enough to copy cheaply");
+
 
 /**
  * @brief The Director class is responsible for managing the game flow and interactions between the player and the enemy.
- * @note This class is not responsible for rendering or keeping track of cards on the board.
+ * It runs the rules on top of a GameState, which holds every card of the game.
+ * @note This class is not responsible for rendering.
  */
 class Director {
 public:
@@ -146,16 +509,34 @@ public:
     inline static const int maxCards = 7; // Max cards in hand. Players will draw until they have this many cards in hand after every round.
 
     Director();
+    explicit Director(std::uint64_t seed);
+    // Copies leave the counter behind: an attached counter observes one Director, and a copy that plays on would corrupt its counts
+    Director(const Director& other);
+    Director& operator=(const Director& other);
 
     void initializeDecks();
+
+    /**
+     * @brief startGame resets the Director to the start of a new match: full health, empty board, freshly shuffled decks and full hands.
+     * A Director can be reused for any number of matches, nothing is allocated per match.
+     */
     void startGame();
+
+    /**
+     * @brief Reseeds the Director's random streams and starts a new match. The whole match (shuffles and the AI's choices) is reproducible from seed.
+     */
+    void startGame(std::uint64_t seed);
     void endGame();
 
     void shuffleDeck(bool isPlayer);
     bool playCard(bool isPlayer, int cardIndex, int pos);
     void discardCard(bool isPlayer, int cardIndex);
     void drawCard(bool isPlayer) {
-        this->board.drawCard(isPlayer);
+        const int before = this->state.hand(isPlayer).size();
+        this->state.drawCard(isPlayer, this->deckRngs[isPlayer]);
+        if (this->counter && this->state.hand(isPlayer).size() > before) {
+            this->countDraw(isPlayer);
+        }
     }
     void drawCards(bool isPlayer, int targetCards = maxCards);
 
@@ -169,25 +550,76 @@ public:
 
     /**
      * @brief turnAttack simulates the Assault phase of each round (see game rules for more details).
+     * All slots are resolved at once by the assault kernel (see Assault.hpp).
      * @return true if the game is still running, false if the game has ended.
      */
     bool turnAttack();
 
+    /**
+     * @brief turnAttackReference is the straightforward slot-by-slot implementation of the Assault phase.
+     * It must give exactly the same results as turnAttack, and is kept to check the kernel against (see --verify-assault in Simulation.hpp).
+     */
+    bool turnAttackReference();
+
     void printBoard() {
-        this->board.print();
+        this->state.print();
     }
 
     // Get/Setters
 
-    int getEnemyHealth() const { return this->board.enemyHealth; }
-    int getPlayerHealth() const { return this->board.playerHealth; }
-    int getEnemyDeckSize() const { return this->board.enemyDeck.size(); }
-    int getPlayerDeckSize() const { return this->board.playerDeck.size(); }
-    const std::vector<Card*>& getEnemyCards() { return this->board.enemyCards; }
-    const std::vector<Card*>& getPlayerCards() { return this->board.playerCards; }
-    const std::vector<Card*>& getEnemyHand() { return this->board.enemyHand; }
-    const std::vector<Card*>& getPlayerHand() { return this->board.playerHand; }
+    int getEnemyHealth() const { return this->state.enemyHealth; }
+    int getPlayerHealth() const { return this->state.playerHealth; }
+    int getEnemyDeckSize() const { return this->state.enemyDeck.size(); }
+    int getPlayerDeckSize() const { return this->state.playerDeck.size(); }
+    const Card* getEnemyCards() const { return this->state.enemyCards; }
+    const Card* getPlayerCards() const { return this->state.playerCards; }
+    const Hand& getEnemyHand() const { return this->state.enemyHand; }
+    const Hand& getPlayerHand() const { return this->state.playerHand; }
+    const GameState& getState() const { return this->state; }
+    // Zobrist hash of the position, including whose turn it is first (see Zobrist.hpp)
+    std::uint64_t getHash() const { return this->state.zobrist(this->first); }
+    std::uint64_t getSeed() const { return this->seed; }
+    // Stream for policies (EnemyAI and friends). Independent from the deck shuffles, but derived from the same seed.
+    Rng& getPolicyRng() { return this->policyRng; }
+
+    /**
+     * @brief setCounter attaches a card counter (see CardCounting.hpp), which is reset to the current state and then told of every play, draw,
+     * discard and shuffle. nullptr detaches it. The counter must stay alive while it is attached.
+     */
+    void setCounter(CardCounter* counter);
+    const CardCounter* getCounter() const { return this->counter; }
+
+    /**
+     * @brief shuffleSeed seeds the index-th shuffle of one side's deck in the match started with seed.
+     * Every shuffle gets its own stream, so two matches with the same seed shuffle alike even when their policies draw a different number of cards
+     * or the other side reshuffles differently: the basis of paired comparisons (common random numbers, see Comparison.hpp).
+     */
+    static std::uint64_t shuffleSeed(std::uint64_t seed, bool isPlayer, std::uint32_t index) {
+        return Rng::mix(seed ^ Rng::mix((static_cast<std::uint64_t>(index) << 1 | isPlayer) + 0x53485546464C45ull));
+    }
+
+    /**
+     * @brief startingState is the GameState every match starts from (decks filled from the deck registries, not shuffled yet).
+     */
+    static const GameState& startingState();
+
+    /**
+     * @brief refreshStartingState rebuilds startingState from the active card set. Called whenever a card set is activated; no game may be running.
+     */
+    static void refreshStartingState();
 
 private:
-    Board board;
-};
\ No newline at end of file
+    // Shared end of both Assault implementations: reshuffle the decks and check for game over
+    bool finishAssault();
+    // Tells the counter of the card just drawn to the back of the hand
+    void countDraw(bool isPlayer);
+
+    GameState state;
+    std::uint64_t seed = 0;
+    Rng deckRngs[2]; // Drive the lazy deck shuffles, indexed by side. Reseeded at every shuffle (see shuffleSeed)
+    std::uint32_t shuffles[2] = {}; // Shuffles of each deck so far this match
+    Rng policyRng; // Rng(seed) jumped 2^128 steps ahead
+    CardCounter* counter = nullptr; // Null when no counter is attached
+};
+
+static_assert(Hand::capacity >= 3 * Director::maxCards, "A hand must hold every card REINFORCE can bring (see Hand)");
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include "Lethal.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include "Assault.hpp"
+
+
+namespace {
+    const int unblockable = 1 << 20; // Damage a lane keeps when no card the defender may hold can block it
+    const int maxBonus = GameState::slotCount; // INSPIRE cards played in one turn
+
+    /**
+     * @brief PairResolver resolves attacker/blocker pairs through the kernel a lane width at a time.
+     * Each pair lowers *dealt to the overflow the attacker deals, if that is smaller, and raises *back to the overflow it takes, if that is larger.
+     */
+    class PairResolver {
+    public:
+        explicit PairResolver(bool attackerIsPlayer) : attackerIsPlayer(attackerIsPlayer) {}
+
+        void add(const Card& attacker, const Card& blocker, int* dealt, int* back) {
+            packLane(this->lanes, this->count, this->attackerIsPlayer ? &attacker : &blocker, this->attackerIsPlayer ? &blocker : &attacker);
+            this->dealt[this->count] = dealt;
+            this->back[this->count++] = back;
+            if (this->count == AssaultLanes::width) {
+                flush();
+            }
+        }
+
+        void flush() {
+            if (this->count == 0) {
+                return;
+            }
+            for (int lane = this->count; lane < AssaultLanes::width; lane++) {
+                packLane(this->lanes, lane, nullptr, nullptr);
+            }
+            resolveAssault(this->lanes);
+            for (int lane = 0; lane < this->count; lane++) {
+                int toDefender = this->attackerIsPlayer ? this->lanes.overflowToEnemy[lane] : this->lanes.overflowToPlayer[lane];
+                int toAttacker = this->attackerIsPlayer ? this->lanes.overflowToPlayer[lane] : this->lanes.overflowToEnemy[lane];
+                *this->dealt[lane] = std::min(*this->dealt[lane], toDefender);
+                *this->back[lane] = std::max(*this->back[lane], toAttacker);
+            }
+            this->count = 0;
+        }
+
+    private:
+        AssaultLanes lanes;
+        int* dealt[AssaultLanes::width];
+        int* back[AssaultLanes::width];
+        int count = 0;
+        bool attackerIsPlayer;
+    };
+
+    // A card ID the attacker holds, with the copies it holds and its match-ups by INSPIRE bonus
+    typedef struct Group {
+        CardID id;
+        int count;
+        int attack;
+        bool surprise;
+        bool inspire;
+        std::uint8_t slots; // legalSlots
+        int handIndices[Hand::capacity];
+        int blocked[maxBonus + 1]; // Least overflow through any blocker the defender may hold, unblockable if none can block it
+        int back[maxBonus + 1]; // Most overflow any of those blockers deals back
+        int coveredDealt[maxBonus + 1][GameState::slotCount]; // Overflow over the card already in each covered lane
+        int coveredBack[maxBonus + 1][GameState::slotCount];
+    } Group;
+
+    // An attacked lane the defender can still block
+    typedef struct Lane {
+        int full; // Damage when unblocked
+        int blocked; // Damage when blocked by the best blocker
+        bool surprise;
+    } Lane;
+
+    /**
+     * @brief bestSaving is the most damage the defender saves by blocking lanes with at most blockers cards, at most surpriseBlockers
+     * of them on SURPRISE lanes. Every lane gets its best blocker, however few copies of it there are, so this never underestimates the saving.
+     */
+    int bestSaving(const Lane* lanes, int count, int blockers, int surpriseBlockers) {
+        int savings[2][GameState::slotCount];
+        int counts[2] = {};
+        for (int i = 0; i < count; i++) {
+            if (lanes[i].blocked < lanes[i].full) {
+                savings[lanes[i].surprise][counts[lanes[i].surprise]++] = lanes[i].full - lanes[i].blocked;
+            }
+        }
+        for (int kind = 0; kind < 2; kind++) {
+            std::sort(savings[kind], savings[kind] + counts[kind], std::greater<int>());
+        }
+        int best = 0;
+        int surpriseSaved = 0;
+        for (int surprise = 0; surprise <= std::min({ counts[1], surpriseBlockers, blockers }); surprise++) {
+            surpriseSaved += surprise > 0 ? savings[1][surprise - 1] : 0;
+            int saved = surpriseSaved;
+            for (int i = 0; i < std::min(counts[0], blockers - surprise); i++) {
+                saved += savings[0][i];
+            }
+            best = std::max(best, saved);
+        }
+        return best;
+    }
+}
+
+LethalCheck checkLethal(const GameState& state, bool first) {
+    return checkLethal(state, first, CardCounter(state));
+}
+
+LethalCheck checkLethal(const GameState& state, bool first, const CardCounter& counter) {
+    LethalCheck check;
+    const bool isPlayer = first; // The attacker
+    const Card* cards = state.cards(isPlayer);
+    const Card* defenders = state.cards(!isPlayer);
+    const Hand& hand = state.hand(isPlayer);
+    const int health = state.health(!isPlayer);
+
+    // The defender draws up to the hand limit before it blocks, and may hold anything its hand and deck allow
+    const int handTarget = Director::maxCards;
+    const int blockers = counter.maxHeld(!isPlayer, CLASS_BLOCKER, handTarget);
+    const int surpriseBlockers = counter.maxHeld(!isPlayer, CLASS_SURPRISE_BLOCKER, handTarget);
+
+    int openSlots[GameState::slotCount]; // Both sides empty
+    int openCount = 0;
+    int coveredSlots[GameState::slotCount]; // Empty on the attacker's side only
+    int coveredCount = 0;
+    int survivorSlots[GameState::slotCount]; // The attacker's cards facing empty slots
+    int survivors = 0;
+    int fixedSlots[GameState::slotCount]; // Both sides hold a card: nothing the defender does changes these lanes
+    int fixedCount = 0;
+    std::uint8_t openMask = 0;
+    for (int slot = 0; slot < GameState::slotCount; slot++) {
+        if (cards[slot].isBlank()) {
+            (defenders[slot].isBlank() ? openSlots[openCount++] : coveredSlots[coveredCount++]) = slot;
+            openMask |= defenders[slot].isBlank() ? 1 << slot : 0;
+        }
+        else {
+            (defenders[slot].isBlank() ? survivorSlots[survivors++] : fixedSlots[fixedCount++]) = slot;
+        }
+    }
+
+    Group groups[Hand::capacity];
+    int groupCount = 0;
+    int inspireCards = 0;
+    for (int i = 0; i < hand.size(); i++) {
+        const CardType& type = getCardType(hand[i]);
+        const std::uint8_t slots = legalSlots(state, first, isPlayer, type.id);
+        if ((slots & openMask) != openMask || slots == 0) {
+            continue;
+        }
+        int found = 0;
+        while (found < groupCount && groups[found].id != type.id) {
+            found++;
+        }
+        if (found == groupCount) {
+            groups[groupCount++] = { type.id, 0, type.attack, type.has(FLAG_SURPRISE), type.has(FLAG_INSPIRE), slots, {}, {}, {}, {}, {} };
+        }
+        groups[found].handIndices[groups[found].count++] = i;
+        inspireCards += type.has(FLAG_INSPIRE);
+    }
+
+    // INSPIRE buffs the player's cards whoever plays it: the attacker's when it is the player, otherwise the defender's, which only adds to the backlash
+    const int bonusLimit = isPlayer ? std::min(inspireCards, openCount + coveredCount) : 0;
+    const int defenderBuff = isPlayer ? 0 : std::min(counter.maxHeld(true, CLASS_INSPIRE, handTarget), GameState::slotCount) + std::min(inspireCards, openCount);
+
+    PairResolver pairs(isPlayer);
+    int survivorBlocked[GameState::slotCount][maxBonus + 1];
+    int survivorBack[GameState::slotCount][maxBonus + 1];
+    int fixedDealt[GameState::slotCount][maxBonus + 1];
+    int fixedBack[GameState::slotCount][maxBonus + 1];
+    auto blockAll = [&](const Card& card, bool surprise, int* blocked, int* back) {
+        *blocked = unblockable;
+        *back = 0;
+        for (int id = 0; id < CARD_COUNT; id++) {
+            const CardType& type = getCardType(static_cast<CardID>(id));
+            if (inClass(type, surprise ? CLASS_SURPRISE_BLOCKER : CLASS_BLOCKER) && counter.maxHeld(!isPlayer, type.id, handTarget) > 0) {
+                Card blocker(type);
+                blocker.attack += defenderBuff;
+                pairs.add(card, blocker, blocked, back);
+            }
+        }
+    };
+    for (int bonus = 0; bonus <= bonusLimit; bonus++) {
+        for (int g = 0; g < groupCount; g++) {
+            Group& group = groups[g];
+            Card card(group.id);
+            card.attack += bonus;
+            blockAll(card, group.surprise, &group.blocked[bonus], &group.back[bonus]);
+            for (int c = 0; c < coveredCount; c++) {
+                Card defender = defenders[coveredSlots[c]];
+                defender.attack += defenderBuff;
+                group.coveredDealt[bonus][c] = unblockable;
+                group.coveredBack[bonus][c] = 0;
+                pairs.add(card, defender, &group.coveredDealt[bonus][c], &group.coveredBack[bonus][c]);
+            }
+        }
+        for (int i = 0; i < survivors; i++) {
+            Card card = cards[survivorSlots[i]];
+            card.attack += bonus;
+            blockAll(card, card.getType().has(FLAG_SURPRISE), &survivorBlocked[i][bonus], &survivorBack[i][bonus]);
+        }
+        for (int i = 0; i < fixedCount; i++) {
+            Card card = cards[fixedSlots[i]];
+            card.attack += bonus;
+            Card defender = defenders[fixedSlots[i]];
+            defender.attack += defenderBuff;
+            fixedDealt[i][bonus] = unblockable;
+            fixedBack[i][bonus] = 0;
+            pairs.add(card, defender, &fixedDealt[i][bonus], &fixedBack[i][bonus]);
+        }
+    }
+    pairs.flush();
+
+    // Upper bound: every empty slot gets the card that deals the most there unblocked, as if each card could be played any number of times
+    check.upperBound = 0;
+    for (int i = 0; i < survivors; i++) {
+        check.upperBound += cards[survivorSlots[i]].attack + bonusLimit;
+    }
+    for (int i = 0; i < fixedCount; i++) {
+        check.upperBound += fixedDealt[i][bonusLimit];
+    }
+    int strongest = 0;
+    for (int g = 0; g < groupCount; g++) {
+        strongest = std::max(strongest, groups[g].attack + bonusLimit);
+    }
+    check.upperBound += openCount * strongest;
+    for (int c = 0; c < coveredCount; c++) {
+        int best = 0;
+        for (int g = 0; g < groupCount; g++) {
+            if ((groups[g].slots >> coveredSlots[c]) & 1) {
+                best = std::max(best, groups[g].coveredDealt[bonusLimit][c]);
+            }
+        }
+        check.upperBound += best;
+    }
+    check.impossible = check.upperBound < health;
+
+    // Lower bound: every way to fill the open lanes, by number of copies of each card. The rest go to the covered lanes, best overflow first
+    int chosen[Hand::capacity] = {};
+    bool found = false;
+    auto evaluate = [&]() {
+        int inspire = 0;
+        for (int g = 0; g < groupCount; g++) {
+            inspire += isPlayer && groups[g].inspire ? chosen[g] : 0;
+        }
+        // Each INSPIRE card buffs the cards on the board when it is played, itself included. They are played last, in the order listed
+        const int bonus = inspire;
+        Lane lanes[GameState::slotCount];
+        int laneCount = 0;
+        int full = 0;
+        int back = 0;
+        int nextInspire = bonus;
+        for (int g = 0; g < groupCount; g++) {
+            for (int n = 0; n < chosen[g]; n++) {
+                const Group& group = groups[g];
+                int cardBonus = isPlayer && group.inspire ? nextInspire-- : bonus;
+                lanes[laneCount++] = { group.attack + cardBonus, group.blocked[cardBonus], group.surprise };
+                full += group.attack + cardBonus;
+                back += group.back[cardBonus];
+            }
+        }
+        for (int i = 0; i < survivors; i++) {
+            const Card& card = cards[survivorSlots[i]];
+            lanes[laneCount++] = { card.attack + bonus, survivorBlocked[i][bonus], card.getType().has(FLAG_SURPRISE) };
+            full += card.attack + bonus;
+            back += survivorBack[i][bonus];
+        }
+        int damage = full - bestSaving(lanes, laneCount, blockers, surpriseBlockers);
+        for (int i = 0; i < fixedCount; i++) {
+            damage += fixedDealt[i][bonus];
+            back += fixedBack[i][bonus];
+        }
+
+        int used[Hand::capacity];
+        std::copy(chosen, chosen + groupCount, used);
+        int coveredPick[GameState::slotCount];
+        for (int c = 0; c < coveredCount; c++) {
+            coveredPick[c] = -1;
+            int pickDealt = 0;
+            for (int g = 0; g < groupCount; g++) {
+                const Group& group = groups[g];
+                if (used[g] < group.count && !(isPlayer && group.inspire) && ((group.slots >> coveredSlots[c]) & 1) && group.coveredDealt[bonus][c] > pickDealt) {
+                    coveredPick[c] = g;
+                    pickDealt = group.coveredDealt[bonus][c];
+                }
+            }
+            if (coveredPick[c] >= 0) {
+                used[coveredPick[c]]++;
+                damage += pickDealt;
+                back += groups[coveredPick[c]].coveredBack[bonus][c];
+            }
+            else {
+                // Left empty: the defender's card hits the attacker's face
+                back += defenders[coveredSlots[c]].attack + defenderBuff;
+            }
+        }
+
+        // Winning beats killing, which beats dealing more
+        const bool lethal = damage >= health;
+        const bool won = lethal && back < state.health(isPlayer);
+        if (found && (won != check.won ? !won : lethal != check.lethal ? !lethal : damage <= check.lowerBound)) {
+            return;
+        }
+        found = true;
+        check.lowerBound = damage;
+        check.backlash = back;
+        check.lethal = lethal;
+        check.won = won;
+        int handIndices[GameState::slotCount];
+        std::fill(handIndices, handIndices + GameState::slotCount, -1);
+        int copies[Hand::capacity] = {};
+        int lane = 0;
+        for (int g = 0; g < groupCount; g++) {
+            for (int n = 0; n < chosen[g]; n++) {
+                handIndices[openSlots[lane++]] = groups[g].handIndices[copies[g]++];
+            }
+        }
+        for (int c = 0; c < coveredCount; c++) {
+            if (coveredPick[c] >= 0) {
+                handIndices[coveredSlots[c]] = groups[coveredPick[c]].handIndices[copies[coveredPick[c]]++];
+            }
+        }
+        check.plan = orderPlacements(state, isPlayer, handIndices);
+    };
+    int placed = 0;
+    while (true) {
+        evaluate();
+        // Next choice, counting like an odometer and skipping those with more cards than open lanes
+        int g = 0;
+        while (g < groupCount && (chosen[g] == groups[g].count || placed == openCount)) {
+            placed -= chosen[g];
+            chosen[g++] = 0;
+        }
+        if (g == groupCount) {
+            break;
+        }
+        chosen[g]++;
+        placed++;
+    }
+    return check;
+}
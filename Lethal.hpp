@@ -0,0 +1,35 @@
+/*
+Lethal.hpp defines the lethal check: bounds on the face damage the attacking side can deal this round, before it places anything.
+The lower bound is what one concrete placement deals whatever the defender holds and blocks with: the defender is assumed to hold the worst
+cards its counted hand and deck allow (see CardCounting.hpp), and to block the lanes where that saves the most. The upper bound is what any
+placement would deal if nothing were blocked. So a lower bound at the defender's health proves lethal, and an upper bound below it proves
+that no placement is lethal, without a search. Match-ups are resolved with the assault kernel, and a check takes a few microseconds.
+*/
+
+#pragma once
+
+#include "CardCounting.hpp"
+#include "Game.hpp"
+#include "Moves.hpp"
+
+/**
+ * @brief LethalCheck is the result of checkLethal. Damage is face damage to the defender in this round's assault.
+ */
+typedef struct LethalCheck {
+    int lowerBound = 0; // plan deals at least this much, whatever the defender does
+    int upperBound = 0; // No placement deals more than this
+    int backlash = 0; // Most damage the attacker can take in the assault after plan, including overflow from blockers
+    bool lethal = false; // lowerBound reaches the defender's health
+    bool impossible = false; // upperBound is below the defender's health: the defender survives this round whatever the attacker does
+    bool won = false; // lethal, and backlash is below the attacker's health: plan wins the game. The defender's loss is forced
+    TurnPlan plan; // The attacker's placements, in play order
+} LethalCheck;
+
+/**
+ * @brief checkLethal checks the round for side first, which must be about to place its attackers (after drawing).
+ * The defender's cards are what counter knows of them, drawn up to Director::maxCards.
+ */
+LethalCheck checkLethal(const GameState& state, bool first, const CardCounter& counter);
+
+// checkLethal with a counter of state, which takes the defender's whole hand and deck as hidden
+LethalCheck checkLethal(const GameState& state, bool first);
@@ -8,9 +8,50 @@ Driver file.
 #include "SDLConnector.hpp"
 #include "Game.hpp"
 #include "Enemy.hpp"
+#include "Simulation.hpp"
+#include "Tournament.hpp"
+#include "Comparison.hpp"
+#include "Sweep.hpp"
+#include "Tuning.hpp"
+#include "EventQuery.hpp"
+#include "Profile.hpp"
+#include "Events.hpp"
+#include "CardDatabase.hpp"
 
 int main(int argc, char* argv[]) {
-    srand(static_cast<unsigned int>(time(0))); // Seed for random number generation
+    // Cards and decks come from the definitions file (recompiled here if it changed since the last start)
+    CardDatabase::load("CardDefinitions.txt");
+    // The enemy's difficulty profiles. The game plays "normal" unless started with --difficulty NAME
+    if (ProfileDatabase::load("EnemyProfiles.txt")) {
+        ProfileDatabase::select("normal");
+    }
+
+    // Headless mode: play simulated games without ever creating a window
+    if (argc > 1 && std::string(argv[1]) == "--simulate") {
+        return runSimulation(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--tournament") {
+        return runTournament(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--compare") {
+        return runComparison(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        return runSweep(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--tune") {
+        return runTuning(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--query") {
+        return runEventQuery(argc, argv);
+    }
+    if (argc > 2 && std::string(argv[1]) == "--difficulty") {
+        ProfileDatabase::select(argv[2]);
+    }
+
+    // Show what the rules engine does on the console, as it happens
+    TextEventConsumer console(std::cout);
+    EventLog::setConsumer(&console, 1);
 
     SDLConnector connector(1920, 1080, 60, "Rohan's Last Stand");
 
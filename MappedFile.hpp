@@ -0,0 +1,39 @@
+/*
+MappedFile.hpp defines a read-only memory-mapped file. Binary data files (the compiled card database, ...) are mapped instead of read,
+so opening them costs no copies and every thread shares the same pages.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief MappedFile maps a whole file read-only for as long as it is open. Movable, not copyable.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = static_cast<MappedFile&&>(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Maps path, replacing any file mapped before. Returns false (and stays closed) if the file can't be opened or is empty.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const unsigned char* getData() const { return data; }
+    std::size_t getSize() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
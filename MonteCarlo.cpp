@@ -0,0 +1,254 @@
+#include "MonteCarlo.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#include "Lethal.hpp"
+#include "Playout.hpp"
+
+
+namespace {
+    // A node is the turn so far: the placements on the path from the root. Children are stored next to each other
+    typedef struct Node {
+        Move move; // Placement that led here. handIndex -1 = the side ends its turn
+        int firstChild = -1;
+        int childCount = 0;
+        bool expanded = false;
+        int visits = 0;
+        float value = 0.0f; // Sum of playout scores
+    } Node;
+}
+
+struct MonteCarloSearch::Tree {
+    std::vector<Node> nodes;
+    UndoStack undo;
+    long long iterations = 0;
+};
+
+namespace {
+    bool isPass(const Move& move) {
+        return move.handIndex < 0;
+    }
+
+    /**
+     * @brief Adds the children of node: every placement into a slot after the node's own slot, and ending the turn.
+     * Placing in increasing slot order reaches each set of placements once instead of once per order. Order only matters to INSPIRE
+     * (which buffs cards already on the board) and to playing REINFORCE cards in an earlier slot, which the planner gives up.
+     */
+    void expand(std::vector<Node>& nodes, int node, const GameState& state, bool first, bool isPlayer) {
+        int fromSlot = nodes[node].move.handIndex < 0 ? 0 : nodes[node].move.slot + 1;
+        LegalMoves legal = generateMoves(state, first, isPlayer);
+
+        int firstChild = static_cast<int>(nodes.size());
+        Node pass;
+        pass.move = { static_cast<std::int8_t>(isPlayer), -1, -1 };
+        nodes.push_back(pass);
+        for (int i = 0; i < legal.handSize; i++) {
+            for (int slot = fromSlot; slot < GameState::slotCount; slot++) {
+                if (legal.slots[i] & (1 << slot)) {
+                    Node child;
+                    child.move = { static_cast<std::int8_t>(isPlayer), static_cast<std::int8_t>(i), static_cast<std::int8_t>(slot) };
+                    nodes.push_back(child);
+                }
+            }
+        }
+        // nodes may have been reallocated
+        nodes[node].firstChild = firstChild;
+        nodes[node].childCount = static_cast<int>(nodes.size()) - firstChild;
+        nodes[node].expanded = true;
+    }
+
+    // Unvisited children first (in order), then UCB1
+    int select(const std::vector<Node>& nodes, const Node& parent, float exploration) {
+        float logVisits = std::log(static_cast<float>(std::max(1, parent.visits)));
+        int best = -1;
+        float bestScore = -1.0f;
+        for (int i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+            const Node& child = nodes[i];
+            if (child.visits == 0) {
+                return i;
+            }
+            float score = child.value / child.visits + exploration * std::sqrt(logVisits / child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        return best;
+    }
+}
+
+MonteCarloSearch::MonteCarloSearch(const MonteCarloConfig& config) : config(config) {
+    if (this->config.budgetMs <= 0 && this->config.maxIterations <= 0) {
+        this->config.budgetMs = 50;
+    }
+    this->pool = std::make_unique<ThreadPool>(config.threads);
+    this->trees.resize(this->pool->size());
+}
+
+MonteCarloSearch::~MonteCarloSearch() = default;
+
+void MonteCarloSearch::search(Tree& tree, const GameState& root, bool first, bool isPlayer, std::uint64_t seed) const {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(this->config.budgetMs);
+    const int clockInterval = 32; // Iterations between clock reads
+
+    Rng rng(seed);
+    std::vector<Node>& nodes = tree.nodes;
+    nodes.clear();
+    Node start;
+    start.move = { static_cast<std::int8_t>(isPlayer), -1, -1 };
+    nodes.push_back(start);
+    tree.iterations = 0;
+
+    while (true) {
+        if (this->config.maxIterations > 0 && tree.iterations >= this->config.maxIterations) {
+            break;
+        }
+        if (this->config.budgetMs > 0 && tree.iterations % clockInterval == 0 && Clock::now() >= deadline) {
+            break;
+        }
+        tree.iterations++;
+
+        GameState state = root;
+        determinize(state, isPlayer, rng);
+        tree.undo.clear();
+
+        // Selection and expansion: walk down the placements of the turn until a new node or the end of the turn
+        int path[GameState::slotCount + 2];
+        int depth = 0;
+        int node = 0;
+        path[depth++] = node;
+        bool ended = false;
+        while (true) {
+            if (!nodes[node].expanded) {
+                expand(nodes, node, state, first, isPlayer);
+            }
+            int child = select(nodes, nodes[node], this->config.exploration);
+            bool isNew = nodes[child].visits == 0;
+            node = child;
+            path[depth++] = node;
+            if (isPass(nodes[node].move)) {
+                ended = true;
+                break;
+            }
+            applyMove(state, first, nodes[node].move, tree.undo);
+            if (isNew || nodes[node].move.slot == GameState::slotCount - 1) {
+                break;
+            }
+        }
+
+        // Playout: the default policy finishes the turn (unless the tree ended it), then the game goes on
+        int lastSlot = isPass(nodes[node].move) ? GameState::slotCount : nodes[node].move.slot;
+        if (!ended) {
+            playoutTurn(state, first, isPlayer, lastSlot + 1, rng, tree.undo);
+        }
+        float score = playout(state, first, isPlayer, this->config.playoutRounds, rng, tree.undo);
+
+        for (int i = 0; i < depth; i++) {
+            nodes[path[i]].visits++;
+            nodes[path[i]].value += score;
+        }
+    }
+}
+
+TurnPlan MonteCarloSearch::plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // A proven win needs no search
+    if (isPlayer == first) {
+        LethalCheck lethal = checkLethal(state, first);
+        if (lethal.won) {
+            this->lastStats = MonteCarloStats();
+            this->lastStats.threads = static_cast<int>(this->trees.size());
+            this->lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            this->totals.decisions++;
+            this->totals.lethal++;
+            this->totals.seconds += this->lastStats.seconds;
+            return lethal.plan;
+        }
+    }
+
+    this->pool->parallel([&](int thread) {
+        search(this->trees[thread], state, first, isPlayer, Rng::mix(seed + thread));
+    });
+
+    this->lastStats = MonteCarloStats();
+    this->lastStats.threads = static_cast<int>(this->trees.size());
+    for (const Tree& tree : this->trees) {
+        this->lastStats.iterations += tree.iterations;
+        this->lastStats.nodes += static_cast<long long>(tree.nodes.size());
+    }
+
+    // Merge the trees: follow the placement with the most visits summed over all trees, until ending the turn wins
+    TurnPlan plan;
+    plan.complete = false;
+    std::vector<int> at(this->trees.size(), 0); // Current node of each tree, -1 once a tree doesn't have the chosen line
+    while (plan.count < GameState::slotCount) {
+        Move best = {};
+        int bestVisits = 0;
+        for (std::size_t t = 0; t < this->trees.size(); t++) {
+            if (at[t] < 0) {
+                continue;
+            }
+            const std::vector<Node>& nodes = this->trees[t].nodes;
+            const Node& parent = nodes[at[t]];
+            for (int i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+                // Sum this move's visits over every tree
+                int visits = 0;
+                for (std::size_t u = 0; u < this->trees.size(); u++) {
+                    if (at[u] < 0) {
+                        continue;
+                    }
+                    const std::vector<Node>& other = this->trees[u].nodes;
+                    const Node& otherParent = other[at[u]];
+                    for (int j = otherParent.firstChild; j < otherParent.firstChild + otherParent.childCount; j++) {
+                        if (other[j].move == nodes[i].move) {
+                            visits += other[j].visits;
+                            break;
+                        }
+                    }
+                }
+                if (visits > bestVisits) {
+                    bestVisits = visits;
+                    best = nodes[i].move;
+                }
+            }
+        }
+
+        if (bestVisits == 0) {
+            break; // Not searched this deep. The caller finishes the turn
+        }
+        if (isPass(best)) {
+            plan.complete = true;
+            break;
+        }
+        plan.moves[plan.count++] = best;
+
+        for (std::size_t t = 0; t < this->trees.size(); t++) {
+            if (at[t] < 0) {
+                continue;
+            }
+            const std::vector<Node>& nodes = this->trees[t].nodes;
+            const Node& parent = nodes[at[t]];
+            int next = -1;
+            for (int i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+                if (nodes[i].move == best) {
+                    next = i;
+                    break;
+                }
+            }
+            at[t] = next;
+        }
+        if (best.slot == GameState::slotCount - 1) {
+            plan.complete = true; // No slot left to place into
+            break;
+        }
+    }
+
+    this->lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    this->totals.decisions++;
+    this->totals.nodes += this->lastStats.iterations;
+    this->totals.seconds += this->lastStats.seconds;
+    return plan;
+}
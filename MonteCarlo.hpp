@@ -0,0 +1,59 @@
+/*
+MonteCarlo.hpp defines the Monte Carlo Tree Search used by EnemyAI's search mode. It plans the placements of a whole turn within a wall-clock budget,
+handling the hidden hand and decks by searching a fresh random deal of the unseen cards (see determinize in Playout.hpp) on every iteration.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Game.hpp"
+#include "Moves.hpp"
+#include "Planner.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief MonteCarloConfig holds the knobs of the search. Quality grows with budgetMs and with threads.
+ */
+typedef struct MonteCarloConfig {
+    int budgetMs = 50; // Wall-clock time per decision. 0 = no time limit (maxIterations must be set)
+    int threads = 0; // Search threads. 0 = one per hardware thread
+    long long maxIterations = 0; // Iterations per thread. 0 = no limit, only the budget counts
+    float exploration = 0.7f; // UCB1 exploration constant
+    int playoutRounds = 6; // Rounds played past the current one before a playout is scored
+} MonteCarloConfig;
+
+typedef struct MonteCarloStats {
+    long long iterations = 0; // Over all threads
+    long long nodes = 0;
+    int threads = 0;
+    double seconds = 0.0;
+} MonteCarloStats;
+
+/**
+ * @brief MonteCarloSearch plans a turn with root-parallel MCTS: every thread grows its own tree over the turn's placements,
+ * and the trees are merged by visit counts at the end. The tree only holds the deciding side's own moves, which don't depend on the
+ * hidden cards, so one tree serves every deal. The opponent's answer and the following rounds are left to playouts.
+ */
+class MonteCarloSearch : public TurnPlanner {
+public:
+    explicit MonteCarloSearch(const MonteCarloConfig& config);
+    ~MonteCarloSearch();
+
+    // With a budget of 0 and maxIterations set, the plan only depends on the state and the seed
+    TurnPlan plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) override;
+
+    const MonteCarloStats& getLastStats() const { return this->lastStats; }
+
+private:
+    struct Tree;
+
+    void search(Tree& tree, const GameState& root, bool first, bool isPlayer, std::uint64_t seed) const;
+
+    MonteCarloConfig config;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Tree> trees; // One per thread, kept between decisions to reuse their memory
+    MonteCarloStats lastStats;
+};
@@ -0,0 +1,295 @@
+#include "Moves.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "Assault.hpp"
+
+
+bool LegalMoves::empty() const {
+    for (int i = 0; i < handSize; i++) {
+        if (slots[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int LegalMoves::count() const {
+    int total = 0;
+    for (int i = 0; i < handSize; i++) {
+        total += std::popcount(slots[i]);
+    }
+    return total;
+}
+
+int LegalMoves::firstCardFor(int slot) const {
+    for (int i = 0; i < handSize; i++) {
+        if (slots[i] & (1 << slot)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+namespace {
+    /**
+     * @brief SlotMasks is the board seen from one side: which slots are open, and which are attacked (by a SURPRISE card or not).
+     * Legality of a card then only depends on its flags, so the board is read once per generation instead of once per card.
+     */
+    struct SlotMasks {
+        bool onDefense;
+        std::uint8_t open = 0;
+        std::uint8_t attacked = 0;
+        std::uint8_t surprise = 0;
+
+        SlotMasks(const GameState& state, bool first, bool isPlayer) : onDefense((isPlayer && !first) || (!isPlayer && first)) {
+            const Card* own = state.cards(isPlayer);
+            const Card* opposite = state.cards(!isPlayer);
+            for (int i = 0; i < GameState::slotCount; i++) {
+                open |= own[i].isBlank() << i;
+                if (!opposite[i].isBlank()) {
+                    attacked |= 1 << i;
+                    surprise |= opposite[i].getType().has(FLAG_SURPRISE) << i;
+                }
+            }
+        }
+
+        std::uint8_t legalFor(const CardType& type) const {
+            if (onDefense) {
+                // Only to block an attacker, and only DEFENSE_ONLY cards can block SURPRISE
+                if (!type.has(FLAG_CAN_DEFEND)) {
+                    return 0;
+                }
+                return open & (type.has(FLAG_CAN_ATTACK) ? attacked & ~surprise : attacked);
+            }
+            return type.has(FLAG_CAN_ATTACK) ? open : 0;
+        }
+    };
+}
+
+std::uint8_t legalSlots(const GameState& state, bool first, bool isPlayer, CardID id) {
+    return SlotMasks(state, first, isPlayer).legalFor(getCardType(id));
+}
+
+LegalMoves generateMoves(const GameState& state, bool first, bool isPlayer, bool collapseDuplicates) {
+    const Hand& hand = state.hand(isPlayer);
+    const SlotMasks masks(state, first, isPlayer);
+    LegalMoves moves;
+    moves.handSize = hand.size();
+
+    static_assert(CARD_COUNT <= 32, "Seen card IDs are kept in a 32-bit mask");
+    std::uint32_t seen = 0; // Bit per CardID
+    for (int i = 0; i < hand.size(); i++) {
+        CardID id = hand[i];
+        if (collapseDuplicates && (seen & (1u << id))) {
+            continue;
+        }
+        seen |= 1u << id;
+        moves.slots[i] = masks.legalFor(getCardType(id));
+    }
+    return moves;
+}
+
+int firstLegalCard(const GameState& state, bool first, bool isPlayer, int slot) {
+    if (!state.cards(isPlayer)[slot].isBlank()) {
+        return -1;
+    }
+
+    // The flags a card needs for this one slot
+    std::uint16_t required = FLAG_CAN_ATTACK;
+    std::uint16_t forbidden = 0;
+    if ((isPlayer && !first) || (!isPlayer && first)) {
+        const Card& opposite = state.cards(!isPlayer)[slot];
+        if (opposite.isBlank()) {
+            return -1;
+        }
+        required = FLAG_CAN_DEFEND;
+        forbidden = opposite.getType().has(FLAG_SURPRISE) ? FLAG_CAN_ATTACK : 0; // Only DEFENSE_ONLY cards block SURPRISE
+    }
+
+    const Hand& hand = state.hand(isPlayer);
+    for (int i = 0; i < hand.size(); i++) {
+        std::uint16_t flags = getCardType(hand[i]).flags;
+        if ((flags & required) && !(flags & forbidden)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool isLegalMove(const GameState& state, bool first, Move move) {
+    bool isPlayer = move.side != 0;
+    if (move.slot < 0 || move.slot >= GameState::slotCount || move.handIndex < 0 || move.handIndex >= state.hand(isPlayer).size()) {
+        return false;
+    }
+    return (legalSlots(state, first, isPlayer, state.hand(isPlayer)[move.handIndex]) >> move.slot) & 1;
+}
+
+TurnPlan orderPlacements(const GameState& state, bool isPlayer, const int (&handIndices)[GameState::slotCount]) {
+    const Hand& hand = state.hand(isPlayer);
+    TurnPlan plan;
+    bool played[Hand::capacity] = {};
+    for (int pass = 0; pass < 2; pass++) {
+        for (int slot = 0; slot < GameState::slotCount; slot++) {
+            int index = handIndices[slot];
+            if (index < 0 || getCardType(hand[index]).has(FLAG_INSPIRE) != (pass == 1)) {
+                continue;
+            }
+            // Hands keep their order when a card is removed, so the index drops by one for every earlier card already played
+            int shifted = index;
+            for (int i = 0; i < index; i++) {
+                shifted -= played[i];
+            }
+            played[index] = true;
+            plan.moves[plan.count++] = { static_cast<std::int8_t>(isPlayer), static_cast<std::int8_t>(shifted), static_cast<std::int8_t>(slot) };
+        }
+    }
+    return plan;
+}
+
+bool applyMove(GameState& state, bool first, Move move, UndoStack& undo) {
+    if (undo.full() || !isLegalMove(state, first, move)) {
+        return false;
+    }
+    bool isPlayer = move.side != 0;
+    Hand& hand = state.hand(isPlayer);
+
+    UndoRecord& record = undo.push();
+    record.kind = UndoRecord::PLACEMENT;
+    record.hash = state.hash;
+    PlacementUndo& placement = record.placement;
+    placement.move = move;
+    placement.inspired = 0;
+    placement.reinforced = 0;
+
+    CardID id = state.removeHand(isPlayer, move.handIndex);
+    state.setCard(isPlayer, move.slot, Card(id));
+
+    // Same side effects as Director::playCard
+    const CardType& type = getCardType(id);
+    if (type.has(FLAG_INSPIRE)) {
+        for (int i = 0; i < GameState::slotCount; i++) {
+            if (!state.playerCards[i].isBlank()) {
+                Card buffed = state.playerCards[i];
+                buffed.attack += 1;
+                state.setCard(true, i, buffed);
+                placement.inspired |= 1 << i;
+            }
+        }
+    }
+    else if (type.has(FLAG_REINFORCE)) {
+        const CardID reinforcements[3] = { EOMER, CAVALRY, CAVALRY };
+        for (CardID reinforcement : reinforcements) {
+            std::int8_t spare = hand.full() ? 0 : hand.cards[hand.count];
+            if (state.canGain(isPlayer) && state.pushHand(isPlayer, reinforcement)) {
+                placement.spare[placement.reinforced++] = spare;
+            }
+        }
+    }
+    return true;
+}
+
+void undoMove(GameState& state, UndoStack& undo) {
+    const UndoRecord& record = undo.pop();
+    const PlacementUndo& placement = record.placement;
+    bool isPlayer = placement.move.side != 0;
+    Hand& hand = state.hand(isPlayer);
+
+    for (int i = placement.reinforced - 1; i >= 0; i--) {
+        hand.pop(placement.spare[i]);
+    }
+    for (int i = 0; i < GameState::slotCount; i++) {
+        if (placement.inspired & (1 << i)) {
+            state.playerCards[i].attack -= 1;
+        }
+    }
+    Card& placed = state.cards(isPlayer)[placement.move.slot];
+    hand.insert(placement.move.handIndex, placed.getID());
+    placed = Card();
+    state.hash = record.hash;
+}
+
+bool applyAssault(GameState& state, UndoStack& undo, bool& isRunning) {
+    if (undo.full()) {
+        return false;
+    }
+    UndoRecord& record = undo.push();
+    record.kind = UndoRecord::ASSAULT;
+    record.hash = state.hash;
+    AssaultUndo& assault = record.assault;
+    std::copy(state.enemyCards, state.enemyCards + GameState::slotCount, assault.enemyCards);
+    std::copy(state.playerCards, state.playerCards + GameState::slotCount, assault.playerCards);
+    assault.enemyHealth = state.enemyHealth;
+    assault.playerHealth = state.playerHealth;
+    for (int side = 0; side < 2; side++) {
+        const Deck& deck = state.deck(side != 0);
+        assault.discards[side] = 0;
+        assault.pendingShuffle[side] = static_cast<std::uint8_t>(deck.pendingShuffle());
+        for (int i = 0; i < GameState::slotCount; i++) {
+            assault.spare[side][i] = deck.spare(i);
+        }
+    }
+
+    AssaultLanes lanes;
+    packAssault(state, lanes);
+    resolveAssault(lanes);
+
+    // Same post-pass as Director::turnAttack, without the events
+    int faceDamageToPlayer = 0;
+    int faceDamageToEnemy = 0;
+    for (int i = 0; i < GameState::slotCount; i++) {
+        faceDamageToPlayer += lanes.faceDamageToPlayer[i];
+        faceDamageToEnemy += lanes.faceDamageToEnemy[i];
+        if (!lanes.playerPresent[i] || !lanes.enemyPresent[i]) {
+            continue;
+        }
+
+        for (int side = 1; side >= 0; side--) { // Player first, like turnAttack
+            bool isPlayer = side != 0;
+            Card card = state.cards(isPlayer)[i];
+            if (isPlayer ? lanes.playerDead[i] : lanes.enemyDead[i]) {
+                // Only the cards that went in are taken back by undoAssault
+                if (state.putBottom(isPlayer, card.getID())) {
+                    assault.discards[side]++;
+                }
+                card = Card();
+            }
+            else {
+                card.currHealth = static_cast<std::int16_t>(isPlayer ? lanes.playerHealth[i] : lanes.enemyHealth[i]);
+                card.attack = static_cast<std::int16_t>(card.getType().attack);
+                card.defense = static_cast<std::int16_t>(card.getType().defense);
+            }
+            state.setCard(isPlayer, i, card);
+        }
+    }
+
+    state.setHealth(true, state.playerHealth - faceDamageToPlayer);
+    state.setHealth(false, state.enemyHealth - faceDamageToEnemy);
+    state.playerDeck.shuffle();
+    state.enemyDeck.shuffle();
+
+    isRunning = state.playerHealth > 0 && state.enemyHealth > 0;
+    if (!isRunning) {
+        state.setHealth(true, std::max<std::int16_t>(0, state.playerHealth));
+        state.setHealth(false, std::max<std::int16_t>(0, state.enemyHealth));
+    }
+    return true;
+}
+
+void undoAssault(GameState& state, UndoStack& undo) {
+    const UndoRecord& record = undo.pop();
+    const AssaultUndo& assault = record.assault;
+    std::copy(assault.enemyCards, assault.enemyCards + GameState::slotCount, state.enemyCards);
+    std::copy(assault.playerCards, assault.playerCards + GameState::slotCount, state.playerCards);
+    state.enemyHealth = assault.enemyHealth;
+    state.playerHealth = assault.playerHealth;
+    for (int side = 0; side < 2; side++) {
+        Deck& deck = state.deck(side != 0);
+        for (int i = assault.discards[side] - 1; i >= 0; i--) {
+            deck.takeBottom(assault.spare[side][i]);
+        }
+        deck.setPendingShuffle(assault.pendingShuffle[side]);
+    }
+    state.hash = record.hash;
+}
@@ -0,0 +1,152 @@
+/*
+Moves.hpp defines the make/unmake API used by search code. A move (or an assault) is applied directly to a GameState and a compact undo record
+is pushed on an UndoStack; undoing pops the record and restores the exact prior state, byte for byte.
+Nothing here allocates, logs events or touches a random stream, so an AI can try and take back thousands of lines without copying GameStates.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Game.hpp"
+
+/**
+ * @brief A Move places the card at handIndex of one side's hand into one of that side's board slots.
+ */
+typedef struct Move {
+    std::int8_t side; // 1 = player, 0 = enemy
+    std::int8_t handIndex;
+    std::int8_t slot;
+
+    bool operator==(const Move& other) const = default;
+} Move;
+
+/**
+ * @brief TurnPlan is the placements one side makes in a turn, in the order they are played (each hand index refers to the hand as it is
+ * after the moves before it). complete is false when the planner left the rest of the turn undecided.
+ */
+typedef struct TurnPlan {
+    Move moves[GameState::slotCount];
+    int count = 0;
+    bool complete = true;
+} TurnPlan;
+
+// Everything a placement changed that can't be derived from the state after it
+typedef struct PlacementUndo {
+    Move move;
+    std::uint8_t inspired; // Bit i: player slot i got +1 attack from INSPIRE/RALLY
+    std::uint8_t reinforced; // Cards REINFORCE added to the hand (fewer than 3 if the side already owned Deck::capacity cards)
+    std::int8_t spare[3]; // Hand bytes the reinforcements overwrote
+} PlacementUndo;
+
+// Everything an assault changed. Decks are restored from the discard counts, not copied
+typedef struct AssaultUndo {
+    Card enemyCards[GameState::slotCount];
+    Card playerCards[GameState::slotCount];
+    std::int16_t enemyHealth;
+    std::int16_t playerHealth;
+    std::uint8_t discards[2]; // Cards put on the bottom of each deck, indexed by side
+    std::uint8_t pendingShuffle[2]; // Deck::pendingShuffle before the reshuffle
+    std::int8_t spare[2][GameState::slotCount]; // Deck bytes the discards overwrote
+} AssaultUndo;
+
+typedef struct UndoRecord {
+    UndoRecord() : kind(PLACEMENT), placement() {}
+
+    enum Kind : std::uint8_t {
+        PLACEMENT,
+        ASSAULT,
+    } kind;
+    StateHash hash; // GameState::hash before the change, put back as is
+    union {
+        PlacementUndo placement;
+        AssaultUndo assault;
+    };
+} UndoRecord;
+
+/**
+ * @brief UndoStack is a fixed-capacity stack of undo records. Deep enough for any line of play a search looks at (a round is at most
+ * 10 placements and one assault).
+ */
+class UndoStack {
+public:
+    static const int capacity = 256;
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count >= capacity; }
+    const UndoRecord& top() const { return records[count - 1]; }
+
+    UndoRecord& push() { return records[count++]; }
+    UndoRecord& pop() { return records[--count]; }
+    void clear() { count = 0; }
+
+private:
+    UndoRecord records[capacity];
+    int count = 0;
+};
+
+/**
+ * @brief LegalMoves holds the legal placements of one side as bitmasks: bit s of slots[i] is set when the card at hand index i can be placed in slot s.
+ * With duplicates collapsed, only the first hand index of each card ID gets moves: placing any copy of a card leads to the same state.
+ */
+typedef struct LegalMoves {
+    std::uint8_t slots[Hand::capacity] = {};
+    int handSize = 0;
+
+    bool empty() const;
+    int count() const; // Number of (hand index, slot) moves
+
+    // First hand index (in hand order) that can be placed in slot, or -1
+    int firstCardFor(int slot) const;
+} LegalMoves;
+
+/**
+ * @brief legalSlots is the mask of slots a card with the given ID can be placed in by one side. It applies occupancy, the attack/defense rule,
+ * ATTACK_ONLY/DEFENSE_ONLY and the SURPRISE blocking rule, exactly like Director::playCard.
+ * @param first Director::first: whether the player attacks this round.
+ */
+std::uint8_t legalSlots(const GameState& state, bool first, bool isPlayer, CardID id);
+
+/**
+ * @brief generateMoves lists every legal placement of one side, without changing anything.
+ * @param collapseDuplicates Give moves only to the first copy of each card ID in the hand.
+ */
+LegalMoves generateMoves(const GameState& state, bool first, bool isPlayer, bool collapseDuplicates = true);
+
+/**
+ * @brief firstLegalCard is the first hand index (in hand order) that one side can place in slot, or -1.
+ * Same answer as generateMoves(...).firstCardFor(slot), but stops at the first legal card.
+ */
+int firstLegalCard(const GameState& state, bool first, bool isPlayer, int slot);
+
+/**
+ * @brief isLegalMove checks move against the deployment rules of Director::playCard, without changing anything.
+ * @param first Director::first: whether the player attacks this round.
+ */
+bool isLegalMove(const GameState& state, bool first, Move move);
+
+/**
+ * @brief orderPlacements turns a choice of one hand card per slot (hand indices as the hand is now, -1 for none) into a TurnPlan:
+ * slots in order, INSPIRE/RALLY cards last so a player's buffs reach every card placed, hand indices adjusted for the cards played before.
+ */
+TurnPlan orderPlacements(const GameState& state, bool isPlayer, const int (&handIndices)[GameState::slotCount]);
+
+/**
+ * @brief applyMove plays move like Director::playCard (including INSPIRE/RALLY and REINFORCE) and pushes its undo record.
+ * @return false, with nothing changed, if the move is illegal or the stack is full.
+ */
+bool applyMove(GameState& state, bool first, Move move, UndoStack& undo);
+
+// Takes back the placement on top of the stack
+void undoMove(GameState& state, UndoStack& undo);
+
+/**
+ * @brief applyAssault resolves the Assault phase exactly like Director::turnAttack (same kernel, same discard order, decks reshuffled,
+ * health clamped at game over), pushes its undo record and sets isRunning to whether the game is still running.
+ * @return false, with nothing changed, if the stack is full.
+ */
+bool applyAssault(GameState& state, UndoStack& undo, bool& isRunning);
+
+// Takes back the assault on top of the stack
+void undoAssault(GameState& state, UndoStack& undo);
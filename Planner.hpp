@@ -0,0 +1,55 @@
+/*
+Planner.hpp defines the common interface of the search AIs (MonteCarloSearch, AlphaBetaSearch, ...): anything that can plan the placements of
+one side's turn from a GameState. EnemyAI plays whichever planner it is given, and the simulator compares their cost through PlannerStats.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Game.hpp"
+#include "Moves.hpp"
+
+/**
+ * @brief PlannerStats counts the work a planner did. Fields a planner has no use for stay 0.
+ */
+typedef struct PlannerStats {
+    long long decisions = 0; // plan() calls
+    long long nodes = 0; // Tree nodes visited (MCTS: iterations)
+    long long cutoffs = 0; // Alpha-beta: nodes that failed high/low before trying every move
+    long long firstMoveCutoffs = 0; // ... already on their first move, a measure of the move ordering
+    long long tableHits = 0; // Transposition table probes that ended the node
+    long long depth = 0; // Sum over decisions of the deepest completed iteration
+    long long lethal = 0; // Decisions the lethal check (see Lethal.hpp) proved won, without a search
+    long long endgame = 0; // Decisions the endgame solver (see Endgame.hpp) solved
+    double seconds = 0.0;
+
+    void merge(const PlannerStats& other) {
+        this->decisions += other.decisions;
+        this->nodes += other.nodes;
+        this->cutoffs += other.cutoffs;
+        this->firstMoveCutoffs += other.firstMoveCutoffs;
+        this->tableHits += other.tableHits;
+        this->depth += other.depth;
+        this->lethal += other.lethal;
+        this->endgame += other.endgame;
+        this->seconds += other.seconds;
+    }
+} PlannerStats;
+
+class TurnPlanner {
+public:
+    virtual ~TurnPlanner() = default;
+
+    /**
+     * @brief plan chooses the placements of side isPlayer for the current turn. The side must have drawn already.
+     * @param seed Seeds every random choice of the planner (sampled deals, playouts).
+     */
+    virtual TurnPlan plan(const GameState& state, bool first, bool isPlayer, std::uint64_t seed) = 0;
+
+    // Totals over every plan() call so far
+    const PlannerStats& getTotals() const { return this->totals; }
+
+protected:
+    PlannerStats totals;
+};
@@ -0,0 +1,89 @@
+#include "Playout.hpp"
+
+#include <algorithm>
+
+
+void determinize(GameState& state, bool isPlayer, Rng& rng) {
+    Hand& hand = state.hand(!isPlayer);
+    Deck& deck = state.deck(!isPlayer);
+
+    CardID pool[Hand::capacity + Deck::capacity];
+    int count = 0;
+    for (int i = 0; i < hand.size(); i++) {
+        pool[count++] = hand[i];
+    }
+    for (int i = 0; i < deck.size(); i++) {
+        pool[count++] = deck[i];
+    }
+    for (int i = count - 1; i > 0; i--) {
+        std::swap(pool[i], pool[rng.below(i + 1)]);
+    }
+
+    int handSize = hand.size();
+    hand.clear();
+    deck.clear();
+    for (int i = 0; i < count; i++) {
+        if (i < handSize) {
+            hand.push(pool[i]);
+        }
+        else {
+            deck.putBottom(pool[i]);
+        }
+    }
+    deck.shuffle();
+    state.deck(isPlayer).shuffle();
+    state.rehash();
+}
+
+void drawUpTo(GameState& state, bool isPlayer, Rng& rng) {
+    const Deck& deck = state.deck(isPlayer);
+    const Hand& hand = state.hand(isPlayer);
+    while (hand.size() < Director::maxCards && !deck.empty()) {
+        state.drawCard(isPlayer, rng);
+    }
+}
+
+void playoutTurn(GameState& state, bool first, bool isPlayer, int fromSlot, Rng& rng, UndoStack& undo) {
+    for (int slot = fromSlot; slot < GameState::slotCount; slot++) {
+        int card = firstLegalCard(state, first, isPlayer, slot);
+        if (card < 0 || rng.below(5) == 0) {
+            continue;
+        }
+        Move move = { static_cast<std::int8_t>(isPlayer), static_cast<std::int8_t>(card), static_cast<std::int8_t>(slot) };
+        applyMove(state, first, move, undo);
+    }
+}
+
+float playout(GameState& state, bool first, bool isPlayer, int rounds, Rng& rng, UndoStack& undo) {
+    // The rest of the current round
+    undo.clear();
+    if (isPlayer == first) {
+        drawUpTo(state, !isPlayer, rng);
+        playoutTurn(state, first, !isPlayer, 0, rng, undo);
+    }
+    bool isRunning = false;
+    applyAssault(state, undo, isRunning);
+
+    for (int round = 0; isRunning && round < rounds; round++) {
+        first = !first;
+        undo.clear();
+        drawUpTo(state, first, rng); // The attacker deploys first
+        playoutTurn(state, first, first, 0, rng, undo);
+        drawUpTo(state, !first, rng);
+        playoutTurn(state, first, !first, 0, rng, undo);
+        applyAssault(state, undo, isRunning);
+    }
+    return scoreState(state, isPlayer);
+}
+
+float scoreState(const GameState& state, bool isPlayer) {
+    return scoreHealth(state.health(isPlayer), state.health(!isPlayer));
+}
+
+float scoreHealth(int own, int opponent) {
+    if (own <= 0 || opponent <= 0) {
+        return own > 0 ? 1.0f : opponent > 0 ? 0.0f : 0.5f;
+    }
+    float difference = std::clamp((own - opponent) / 40.0f, -1.0f, 1.0f);
+    return 0.5f + 0.4f * difference;
+}
@@ -0,0 +1,41 @@
+/*
+Playout.hpp defines what search AIs need to play a game forward on a bare GameState: sampling the cards a side can't see (determinization),
+a fast default policy, and playing out the following rounds. Everything runs on the make/unmake API (Moves.hpp), without a Director or events.
+*/
+
+#pragma once
+
+#include "Game.hpp"
+#include "Moves.hpp"
+
+/**
+ * @brief determinize replaces what side isPlayer can't see with one random deal that agrees with what it can see.
+ * The opponent's hand and deck are pooled (their contents are known from the deck lists and the cards played, their split is not)
+ * and dealt again; both decks are reshuffled, since nobody knows their order.
+ */
+void determinize(GameState& state, bool isPlayer, Rng& rng);
+
+// Draws up to Director::maxCards, like Director::drawCards
+void drawUpTo(GameState& state, bool isPlayer, Rng& rng);
+
+/**
+ * @brief playoutTurn is the default policy of playouts: it goes over the side's slots from fromSlot on and places the first legal card,
+ * leaving a slot empty one time in five like EnemyAI.
+ */
+void playoutTurn(GameState& state, bool first, bool isPlayer, int fromSlot, Rng& rng, UndoStack& undo);
+
+/**
+ * @brief playout finishes the round side isPlayer has just played its turn in (the opponent answers if isPlayer attacked, then the assault),
+ * then plays up to rounds more rounds with the default policy. undo is only used as scratch space.
+ * @return The score of the final state for isPlayer (see scoreState).
+ */
+float playout(GameState& state, bool first, bool isPlayer, int rounds, Rng& rng, UndoStack& undo);
+
+/**
+ * @brief scoreState rates a state for side isPlayer in [0, 1]: 1 for a win, 0 for a loss, 0.5 for a draw.
+ * Games still running score between 0.1 and 0.9 depending on the health difference, so any finished game outweighs them.
+ */
+float scoreState(const GameState& state, bool isPlayer);
+
+// scoreState from the health of both sides
+float scoreHealth(int own, int opponent);
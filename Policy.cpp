@@ -0,0 +1,133 @@
+#include "Policy.hpp"
+
+#include "Events.hpp"
+#include "Moves.hpp"
+#include "MonteCarlo.hpp"
+#include "AlphaBeta.hpp"
+
+
+void ScriptedPolicy::turn(Director& game, bool isPlayer) {
+    game.drawCards(isPlayer);
+    play(game, isPlayer, 0, this->profile);
+}
+
+void ScriptedPolicy::play(Director& game, bool isPlayer, int fromSlot, const EnemyProfile& profile) {
+    const Card* cards = game.getState().cards(isPlayer);
+    const Card* opposite = game.getState().cards(!isPlayer);
+    bool onDefense = isPlayer != game.first;
+    Rng& rng = game.getPolicyRng();
+
+    // Same checks, in the same order, as EnemyAI::attack and EnemyAI::defend
+    for (int pos = fromSlot; pos < GameState::slotCount; pos++) {
+        if (onDefense ? opposite[pos].isBlank() && !cards[pos].isBlank() : !cards[pos].isBlank()) {
+            continue;
+        }
+        if (EnemyProfile::skip(rng, onDefense ? profile.defenseSkip : profile.attackSkip)) {
+            logEvent<EventCode::SLOT_SKIPPED>(isPlayer, pos, -1, onDefense);
+            continue;
+        }
+        int card = chooseCard(game.getState(), game.first, isPlayer, pos, profile);
+        if (card >= 0) {
+            game.playCard(isPlayer, card, pos);
+        }
+    }
+}
+
+void GreedyPolicy::turn(Director& game, bool isPlayer) {
+    game.drawCards(isPlayer);
+    const Card* cards = game.getState().cards(isPlayer);
+    const Card* opposite = game.getState().cards(!isPlayer);
+    bool onDefense = isPlayer != game.first;
+
+    for (int pos = 0; pos < GameState::slotCount; pos++) {
+        if (!cards[pos].isBlank() || (onDefense && opposite[pos].isBlank())) {
+            continue;
+        }
+        int card = firstLegalCard(game.getState(), game.first, isPlayer, pos);
+        if (card >= 0) {
+            game.playCard(isPlayer, card, pos);
+        }
+    }
+}
+
+void BlockingPolicy::turn(Director& game, bool isPlayer) {
+    if (isPlayer == game.first) {
+        GreedyPolicy().turn(game, isPlayer);
+        return;
+    }
+    game.drawCards(isPlayer);
+    TurnPlan plan = planBlocking(game.getState(), game.first, isPlayer, this->weights);
+    for (int i = 0; i < plan.count; i++) {
+        game.playCard(isPlayer, plan.moves[i].handIndex, plan.moves[i].slot);
+    }
+}
+
+void TacticalPolicy::turn(Director& game, bool isPlayer) {
+    game.drawCards(isPlayer);
+    TurnPlan plan;
+    if (isPlayer == game.first) {
+        LethalCheck lethal = checkLethal(game.getState(), game.first);
+        plan = lethal.won ? lethal.plan : planAttack(game.getState(), game.first, isPlayer, this->model).plan;
+    }
+    else {
+        plan = planBlocking(game.getState(), game.first, isPlayer, this->weights);
+    }
+    for (int i = 0; i < plan.count; i++) {
+        game.playCard(isPlayer, plan.moves[i].handIndex, plan.moves[i].slot);
+    }
+}
+
+void PlannerPolicy::turn(Director& game, bool isPlayer) {
+    game.drawCards(isPlayer);
+    TurnPlan plan = this->planner->plan(game.getState(), game.first, isPlayer, game.getPolicyRng().next());
+    for (int i = 0; i < plan.count; i++) {
+        game.playCard(isPlayer, plan.moves[i].handIndex, plan.moves[i].slot);
+    }
+    if (!plan.complete) {
+        ScriptedPolicy::play(game, isPlayer, plan.count > 0 ? plan.moves[plan.count - 1].slot + 1 : 0);
+    }
+}
+
+std::unique_ptr<Policy> makePolicy(const std::string& spec) {
+    std::string name = spec.substr(0, spec.find(':'));
+    if (name == "profile") {
+        const EnemyProfile* profile = ProfileDatabase::find(spec.substr(name.size() + 1));
+        return profile ? std::make_unique<ScriptedPolicy>(*profile) : nullptr;
+    }
+
+    int budget = 10;
+    if (name.size() < spec.size()) {
+        try {
+            budget = std::stoi(spec.substr(name.size() + 1));
+        }
+        catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    if (spec == "scripted") {
+        return std::make_unique<ScriptedPolicy>();
+    }
+    if (spec == "greedy") {
+        return std::make_unique<GreedyPolicy>();
+    }
+    if (spec == "blocking") {
+        return std::make_unique<BlockingPolicy>();
+    }
+    if (spec == "tactical") {
+        return std::make_unique<TacticalPolicy>();
+    }
+    if (name == "mcts") {
+        MonteCarloConfig config;
+        config.budgetMs = budget;
+        config.threads = 1;
+        return std::make_unique<PlannerPolicy>(std::make_shared<MonteCarloSearch>(config));
+    }
+    if (name == "alphabeta") {
+        AlphaBetaConfig config;
+        config.budgetMs = budget;
+        config.tableMegabytes = 4;
+        return std::make_unique<PlannerPolicy>(std::make_shared<AlphaBetaSearch>(config));
+    }
+    return nullptr;
+}
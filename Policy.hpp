@@ -0,0 +1,104 @@
+/*
+Policy.hpp defines the policy interface: anything that can play one side's turn of a Director game, for either side.
+The scripted AIs and the planners (see Planner.hpp) are all available as policies, so any two of them can be played against each other (see Tournament.hpp).
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Game.hpp"
+#include "Planner.hpp"
+#include "Profile.hpp"
+#include "Blocking.hpp"
+#include "AttackPlan.hpp"
+#include "Lethal.hpp"
+
+class Policy {
+public:
+    virtual ~Policy() = default;
+
+    /**
+     * @brief turn plays side isPlayer's turn: it draws up to the hand limit, then places cards. Random choices come from game.getPolicyRng().
+     */
+    virtual void turn(Director& game, bool isPlayer) = 0;
+};
+
+/**
+ * @brief ScriptedPolicy is EnemyAI's script for either side: by default the first legal card in each slot, leaving a slot empty one time in five.
+ * Played as the enemy with the same profile it makes exactly the same moves as EnemyAI.
+ */
+class ScriptedPolicy : public Policy {
+public:
+    ScriptedPolicy() = default;
+    explicit ScriptedPolicy(const EnemyProfile& profile) : profile(profile) {}
+
+    void turn(Director& game, bool isPlayer) override;
+
+    // The script from fromSlot on, for planners that left the end of a turn undecided
+    static void play(Director& game, bool isPlayer, int fromSlot, const EnemyProfile& profile = EnemyProfile());
+
+private:
+    EnemyProfile profile;
+};
+
+/**
+ * @brief GreedyPolicy is ScriptedPlayer for either side: it fills every slot it can with the first legal card.
+ */
+class GreedyPolicy : public Policy {
+public:
+    void turn(Director& game, bool isPlayer) override;
+};
+
+/**
+ * @brief BlockingPolicy attacks like GreedyPolicy and defends with the blocking solver (see Blocking.hpp).
+ */
+class BlockingPolicy : public Policy {
+public:
+    BlockingPolicy() = default;
+    explicit BlockingPolicy(const BlockingWeights& weights) : weights(weights) {}
+
+    void turn(Director& game, bool isPlayer) override;
+
+private:
+    BlockingWeights weights;
+};
+
+/**
+ * @brief TacticalPolicy plays a proven win when it has one (see Lethal.hpp), otherwise attacks with the attack planner (see AttackPlan.hpp), and defends with the blocking solver.
+ */
+class TacticalPolicy : public Policy {
+public:
+    TacticalPolicy() = default;
+    TacticalPolicy(const AttackModel& model, const BlockingWeights& weights) : model(model), weights(weights) {}
+
+    void turn(Director& game, bool isPlayer) override;
+
+private:
+    AttackModel model;
+    BlockingWeights weights;
+};
+
+/**
+ * @brief PlannerPolicy plays the turns a TurnPlanner plans, and finishes them with the script when the plan is incomplete.
+ */
+class PlannerPolicy : public Policy {
+public:
+    explicit PlannerPolicy(std::shared_ptr<TurnPlanner> planner) : planner(std::move(planner)) {}
+
+    void turn(Director& game, bool isPlayer) override;
+
+    const TurnPlanner& getPlanner() const { return *this->planner; }
+
+private:
+    std::shared_ptr<TurnPlanner> planner;
+};
+
+/**
+ * @brief makePolicy creates a policy from its name: "scripted", "greedy", "blocking", "tactical", "profile:NAME" (the script with a loaded profile, see ProfileDatabase),
+ * "mcts:MS" or "alphabeta:MS", MS being the planner's budget per turn.
+ * Planners get a single search thread, since policies are meant to be run many at a time.
+ * @return null if spec isn't a known policy.
+ */
+std::unique_ptr<Policy> makePolicy(const std::string& spec);
@@ -0,0 +1,204 @@
+#include "Profile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "CardDatabase.hpp"
+
+
+namespace {
+    std::string trim(const std::string& text) {
+        std::size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        std::size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseNumber(const std::string& text, int& value) {
+        std::size_t digits = text.size() > 0 && text[0] == '-' ? 1 : 0;
+        if (text.size() <= digits || text.find_first_not_of("0123456789", digits) != std::string::npos || text.size() > 6) {
+            return false;
+        }
+        value = std::stoi(text);
+        return true;
+    }
+}
+
+int chooseCard(const GameState& state, bool first, bool isPlayer, int slot, const EnemyProfile& profile) {
+    if (!state.cards(isPlayer)[slot].isBlank()) {
+        return -1;
+    }
+
+    // The same legality test as firstLegalCard
+    const Card& opposite = state.cards(!isPlayer)[slot];
+    std::uint16_t required = FLAG_CAN_ATTACK;
+    std::uint16_t forbidden = 0;
+    if (isPlayer != first) {
+        if (opposite.isBlank()) {
+            return -1;
+        }
+        required = FLAG_CAN_DEFEND;
+        forbidden = opposite.getType().has(FLAG_SURPRISE) ? FLAG_CAN_ATTACK : 0; // Only DEFENSE_ONLY cards block SURPRISE
+    }
+
+    const Hand& hand = state.hand(isPlayer);
+    int best = -1;
+    for (int i = 0; i < hand.size(); i++) {
+        const CardType& type = getCardType(hand[i]);
+        if (!(type.flags & required) || (type.flags & forbidden)) {
+            continue;
+        }
+        if (type.has(FLAG_KAMIKAZE) && (opposite.isBlank() ? 0 : opposite.currHealth) < profile.kamikazeMinHealth) {
+            continue;
+        }
+        if (type.has(FLAG_REINFORCE) && hand.size() - 1 > profile.reinforceMaxHand) {
+            continue;
+        }
+        if (best < 0 || profile.preference[type.id] > profile.preference[hand[best]]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool ProfileDatabase::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "ProfileDatabase: Can't read " << path << ", using the default script\n";
+        return false;
+    }
+
+    // The thresholds take the ranges the tuner explores (see TunedParameter::forCardSet)
+    int maxHealth = 1;
+    for (int id = 0; id < CARD_COUNT; id++) {
+        maxHealth = std::max(maxHealth, getCardType(static_cast<CardID>(id)).maxHealth);
+    }
+
+    std::vector<std::pair<std::string, EnemyProfile>> loaded;
+    bool valid = true;
+    auto fail = [&](int lineNumber, const std::string& message) {
+        std::cerr << path << ":" << lineNumber << ": " << message << "\n";
+        valid = false;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.front() == '[' && line.back() == ']') {
+            loaded.push_back({ trim(line.substr(1, line.size() - 2)), EnemyProfile() });
+            continue;
+        }
+        if (loaded.empty()) {
+            fail(lineNumber, "Settings must be inside a [profile name] section");
+            continue;
+        }
+
+        // Key | Value
+        std::size_t bar = line.find('|');
+        int value = 0;
+        if (bar == std::string::npos || !parseNumber(trim(line.substr(bar + 1)), value)) {
+            fail(lineNumber, "Expected Setting | Number");
+            continue;
+        }
+        std::string key = trim(line.substr(0, bar));
+        EnemyProfile& profile = loaded.back().second;
+        if (key == "attack skip" || key == "defense skip") {
+            if (value < 0 || value > 1000) {
+                fail(lineNumber, "Skip rates are per mille, 0 to 1000");
+            }
+            (key == "attack skip" ? profile.attackSkip : profile.defenseSkip) = value;
+        }
+        else if (key == "kamikaze min health") {
+            if (value < 0 || value > maxHealth) {
+                fail(lineNumber, "The KAMIKAZE threshold is a card health, 0 to " + std::to_string(maxHealth));
+            }
+            profile.kamikazeMinHealth = value;
+        }
+        else if (key == "reinforce max hand") {
+            if (value < 0 || value > Hand::capacity) {
+                fail(lineNumber, "The REINFORCE threshold is a hand size, 0 to " + std::to_string(Hand::capacity));
+            }
+            profile.reinforceMaxHand = value;
+        }
+        else if (key.rfind("prefer ", 0) == 0) {
+            CardID id = CardDatabase::findCard(trim(key.substr(7)));
+            if (id == BLANK) {
+                fail(lineNumber, "Unknown card ID " + trim(key.substr(7)));
+                continue;
+            }
+            profile.preference[id] = value;
+        }
+        else {
+            fail(lineNumber, "Unknown setting " + key);
+        }
+    }
+
+    if (!valid) {
+        return false;
+    }
+    profiles = std::move(loaded);
+    return true;
+}
+
+bool ProfileDatabase::save(const std::string& path, const std::string& name, const EnemyProfile& profile) {
+    bool replaced = false;
+    for (auto& entry : profiles) {
+        if (entry.first == name) {
+            entry.second = profile;
+            replaced = true;
+        }
+    }
+    if (!replaced) {
+        profiles.push_back({ name, profile });
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        std::cerr << "ProfileDatabase: Can't write " << path << "\n";
+        return false;
+    }
+    out << "# Enemy difficulty profiles, written by --tune (see Profile.hpp for the settings).\n";
+    out << "# Skip rates are per mille. Cards without a \"prefer\" line have preference 0.\n";
+    for (const auto& [profileName, settings] : profiles) {
+        out << "\n[" << profileName << "]\n";
+        out << "attack skip          | " << settings.attackSkip << "\n";
+        out << "defense skip         | " << settings.defenseSkip << "\n";
+        out << "kamikaze min health  | " << settings.kamikazeMinHealth << "\n";
+        out << "reinforce max hand   | " << settings.reinforceMaxHand << "\n";
+        for (int id = 0; id < CARD_COUNT; id++) {
+            if (settings.preference[id] != 0) {
+                std::string key = std::string("prefer ") + CardDatabase::identifier(static_cast<CardID>(id));
+                out << key << std::string(key.size() < 21 ? 21 - key.size() : 1, ' ') << "| " << settings.preference[id] << "\n";
+            }
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+const EnemyProfile* ProfileDatabase::find(const std::string& name) {
+    for (const auto& entry : profiles) {
+        if (entry.first == name) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+bool ProfileDatabase::select(const std::string& name) {
+    const EnemyProfile* profile = find(name);
+    if (!profile) {
+        std::cerr << "ProfileDatabase: No profile called " << name << ", keeping the current one\n";
+        return false;
+    }
+    activeProfile = *profile;
+    return true;
+}
@@ -0,0 +1,71 @@
+/*
+Profile.hpp defines the enemy's difficulty profiles: the parameters of EnemyAI's script (how often it leaves a slot empty, which cards it prefers,
+when it holds special cards back) and the file they are shipped in. The profiles are calibrated by the tuner (see Tuning.hpp) and one of them
+is made the active profile at startup.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief EnemyProfile parametrises EnemyAI's script. The defaults are the original script: skip a slot one time in five, play the first legal card.
+ */
+typedef struct EnemyProfile {
+    int attackSkip = 200; // Per mille of the empty attack slots left empty
+    int defenseSkip = 200; // Per mille of the defense slots left empty
+    int preference[CARD_COUNT] = {}; // By CardID. The legal card with the highest preference is played, the earliest in the hand on ties
+    int kamikazeMinHealth = 0; // KAMIKAZE cards are only played against an opposing card with at least this much health. 0 = anywhere
+    int reinforceMaxHand = Hand::capacity; // REINFORCE cards are only played with at most this many other cards in hand
+
+    bool operator==(const EnemyProfile& other) const = default;
+
+    // The per mille chance of skipping a slot, drawn from rng
+    static bool skip(Rng& rng, int perMille) { return static_cast<int>(rng.below(1000)) < perMille; }
+} EnemyProfile;
+
+/**
+ * @brief chooseCard is the hand index profile plays in slot, or -1 if it has no legal card it is willing to play there.
+ * With the default profile it is firstLegalCard.
+ */
+int chooseCard(const GameState& state, bool first, bool isPlayer, int slot, const EnemyProfile& profile);
+
+// The profile EnemyAI starts with. The default script until ProfileDatabase::select picks a loaded one
+inline EnemyProfile activeProfile;
+
+/**
+ * @brief ProfileDatabase reads and writes the profiles file. It is a list of named sections:
+ *
+ * [normal]
+ * attack skip        | 200    (per mille)
+ * defense skip       | 200
+ * kamikaze min health | 0
+ * reinforce max hand | 16
+ * prefer URUK        | 10     (one line per card with a preference, 0 if missing)
+ */
+class ProfileDatabase {
+public:
+    /**
+     * @brief load reads all profiles of path, replacing the ones loaded before.
+     * @return Whether the file was read without errors. Errors are printed, and nothing is loaded.
+     */
+    static bool load(const std::string& path);
+
+    /**
+     * @brief save writes every loaded profile to path, with profile stored under name (added, or replacing the one of that name).
+     * @return Whether the file was written.
+     */
+    static bool save(const std::string& path, const std::string& name, const EnemyProfile& profile);
+
+    // The loaded profile called name, or null
+    static const EnemyProfile* find(const std::string& name);
+
+    // Makes the profile called name the active profile. Returns false (and keeps the active one) if there is none
+    static bool select(const std::string& name);
+
+private:
+    inline static std::vector<std::pair<std::string, EnemyProfile>> profiles;
+};
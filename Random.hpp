@@ -0,0 +1,108 @@
+/*
+Random.hpp defines the random number generator used by the rules engine and the AI.
+Every game is driven by its own Rng, so any game can be reproduced from the single 64-bit seed it was started with.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Rng is a xoshiro256** generator: 32 bytes of state, a handful of instructions per number, and no locks or global state.
+ * It satisfies UniformRandomBitGenerator, so it can also be handed to standard algorithms.
+ * jump() advances the generator by 2^128 steps, which splits one seed into independent, non-overlapping streams.
+ */
+class Rng {
+public:
+    typedef std::uint64_t result_type;
+
+    Rng() : Rng(0) {}
+    explicit Rng(std::uint64_t seed) { this->seed(seed); }
+
+    // Expands a 64-bit seed into the full state with splitmix64, as recommended by the xoshiro authors.
+    void seed(std::uint64_t seed) {
+        for (std::uint64_t& word : state) {
+            seed += 0x9E3779B97F4A7C15ull;
+            word = mix(seed);
+        }
+    }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    std::uint64_t operator()() { return next(); }
+    static constexpr std::uint64_t min() { return 0; }
+    static constexpr std::uint64_t max() { return std::numeric_limits<std::uint64_t>::max(); }
+
+    // Uniform integer in [0, bound). Uses Lemire's multiply-shift method, so it is unbiased and almost never divides.
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t product = (next() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            const std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // Uniform double in [0, 1)
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+    // Advances the generator by 2^128 calls to next()
+    void jump() {
+        static const std::uint64_t jumpPolynomial[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+        std::uint64_t jumped[4] = { 0, 0, 0, 0 };
+        for (std::uint64_t word : jumpPolynomial) {
+            for (int bit = 0; bit < 64; bit++) {
+                if (word & (1ull << bit)) {
+                    for (int i = 0; i < 4; i++) {
+                        jumped[i] ^= state[i];
+                    }
+                }
+                next();
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            state[i] = jumped[i];
+        }
+    }
+
+    // Returns a copy of this generator that is 2^128 steps ahead
+    Rng jumped() const {
+        Rng copy = *this;
+        copy.jump();
+        return copy;
+    }
+
+    /**
+     * @brief mix is the splitmix64 finaliser. It turns structured inputs (a run seed plus a game index, for example) into well-spread seeds.
+     */
+    static constexpr std::uint64_t mix(std::uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+private:
+    std::uint64_t state[4];
+
+    static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
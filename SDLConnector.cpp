@@ -10,7 +10,7 @@
 
 
 void CardGraphic::render(Canvas* canvas) {
-    if (card == nullptr) {
+    if (card.isBlank()) {
         std::cerr << "CardGraphic: No card to render\n";
         return;
     }
@@ -26,7 +26,7 @@ void CardGraphic::render(Canvas* canvas) {
     );
     canvas->drawRect(&borderRect);
 
-    CardID id = card->getType().id;
+    CardID id = card.getType().id;
     SDL_Texture* texture = cardTextures[id];
     if (texture == nullptr) {
         std::cerr << "CardGraphic: No texture for card ID " << id << "\n";
@@ -41,26 +41,11 @@ void CardGraphic::render(Canvas* canvas) {
 }
 
 
-std::map<SpecialAbility, std::string> CardGraphic::specialAbilityNames = {
-    {NONE, "None"},
-    {SURPRISE, "Surprise"},
-    {INSPIRE, "Inspire"},
-    {REINFORCE, "Reinforce"},
-    {RALLY, "Rally"},
-    {HATE, "Hate"},
-    {ARMOR_PIERCE, "Armor Pierce"},
-    {KAMIKAZE, "Kamikaze"}
-};
-std::map<PlayCondition, std::string> CardGraphic::playConditionNames = {
-    {FREE, "Free"},
-    {ATTACK_ONLY, "Aggressive"},
-    {DEFENSE_ONLY, "Defensive"}
-};
 void CardGraphic::renderCardStats(Canvas* canvas) {
     static Font font("Middle-Earth.ttf", 20);      // For name
     static Font fontSmall("Middle-Earth.ttf", 15); // For stats + special ability
 
-    if (card == nullptr) {
+    if (card.isBlank()) {
         std::cerr << "CardGraphic: No card to render text for\n";
         return;
     }
@@ -70,11 +55,11 @@ void CardGraphic::renderCardStats(Canvas* canvas) {
     // Attack (top left)
     int ax = rect.x + 10;
     int ay = rect.y + 10;
-    Color col = (card->attack > card->getType().attack) ? GREEN : GRAY;
-    canvas->renderText("ATK: " + std::to_string(card->attack), &fontSmall, ax, ay, col);
+    Color col = (card.attack > card.getType().attack) ? GREEN : GRAY;
+    canvas->renderText("ATK: " + std::to_string(card.attack), &fontSmall, ax, ay, col);
 
     // Defense (top right)
-    std::string txt = "DEF: " + std::to_string(card->defense);
+    std::string txt = "DEF: " + std::to_string(card.defense);
     int tw = 0, th = 0;
     TTF_SizeText(fontSmall.getFont(), txt.c_str(), &tw, &th);
     int dx = rect.x + rect.w - tw - 10;
@@ -82,19 +67,19 @@ void CardGraphic::renderCardStats(Canvas* canvas) {
     canvas->renderText(txt, &fontSmall, dx, dy, GRAY);
 
     // Special Ability (~2/3 down)
-    if (card->getType().special != NONE) {
+    if (card.getType().special != NONE) {
         int sy = rect.y + (2 * rect.h / 3);
         canvas->renderTextCenter(
-            specialAbilityNames.at(card->getType().special),
+            specialAbilityNames[card.getType().special],
             &fontSmall, cx, sy, GRAY
         );
     }
 
     // Play Condition (Just Above HP at Bottom)
-    if (card->getType().condition != FREE) {
+    if (card.getType().condition != FREE) {
         int pcY = ((rect.y + rect.h - 50) + (rect.y + (2 * rect.h / 3))) / 2;
         canvas->renderTextCenter(
-            playConditionNames.at(card->getType().condition),
+            playConditionNames[card.getType().condition],
             &fontSmall, cx, pcY, GRAY);
     }
 
@@ -102,13 +87,13 @@ void CardGraphic::renderCardStats(Canvas* canvas) {
     int healthY = rect.y + rect.h - 25;
     int nameY = healthY - 20;
     canvas->renderTextCenter(
-        card->getType().name,
+        std::string(card.getType().name),
         &font, cx, nameY, GRAY
     );
 
     // Health (Bottom Center)
-    std::string ht = "HP: " + std::to_string(card->currHealth);
-    Color hc = (card->currHealth == card->getType().maxHealth) ? GREEN : RED;
+    std::string ht = "HP: " + std::to_string(card.currHealth);
+    Color hc = (card.currHealth == card.getType().maxHealth) ? GREEN : RED;
     int hy = rect.y + rect.h - 20;
     canvas->renderTextCenter(ht, &fontSmall, cx, hy, hc);
 }
@@ -116,8 +101,6 @@ void CardGraphic::renderCardStats(Canvas* canvas) {
 
 std::map<CardID, SDL_Texture*> CardGraphic::cardTextures; // Declaring a storage for textures so the compiler doesn't freak out
 void CardGraphic::loadTextures(SDL_Renderer* renderer) {
-    const std::map<CardID, CardType>& registry = Board::getCardRegistry();
-
     // Create a default gray texture
     const int defaultW = 400, defaultH = 400;
     SDL_Surface* defaultSurface = SDL_CreateRGBSurface(0, defaultW, defaultH, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
@@ -139,9 +122,10 @@ void CardGraphic::loadTextures(SDL_Renderer* renderer) {
     cardTextures[BLANK] = defaultTexture;
 
     // Actually load the textures for each card
-    for (const auto& pair : registry) {
-        CardID id = pair.first;
-        std::string name = pair.second.name;
+    for (int i = 0; i < CARD_COUNT; i++) {
+        const CardType& type = getCardType(static_cast<CardID>(i));
+        CardID id = type.id;
+        std::string name(type.name);
         std::string path = "cards/" + name + ".png"; // e.g. Strider -> cards/Strider.png
 
         SDL_Surface* surface = IMG_Load(path.c_str());
@@ -363,7 +347,7 @@ void SDLConnector::processClick(int mx, int my) {
         if (cardGraphics[i].selected) {
             selectedCardIndex = i;
             std::cout << "Selected card: "
-                << cardGraphics[i].getCard()->getType().name << "\n";
+                << cardGraphics[i].getCard().getType().name << "\n";
         }
         else {
             selectedCardIndex = -1;
@@ -397,7 +381,7 @@ void SDLConnector::processClick(int mx, int my) {
             std::cout << "Played card in slot " << boardPos << "\n";
 
             // remove from hand graphic
-            cardGraphics[selectedCardIndex].setCard(nullptr);
+            cardGraphics[selectedCardIndex].setCard(Card());
             cardGraphics[selectedCardIndex].selected = false;
 
             assaultSlots[i].addCardGraphic(&cardGraphics[selectedCardIndex]);
@@ -532,9 +516,9 @@ void SDLConnector::resetGraphics() {
     assaultSlots.clear();
 
     // Prevent vector reallocation (so pointers into cardGraphics stay valid)
-    size_t boardSlots = game.getEnemyCards().size() * 2;
+    size_t boardSlots = GameState::slotCount * 2;
     assaultSlots.reserve(boardSlots);
-    size_t maxGraphics = (game.getEnemyCards().size() + game.getPlayerCards().size())
+    size_t maxGraphics = boardSlots
         + game.getPlayerHand().size() + game.getEnemyHand().size();
     cardGraphics.reserve(maxGraphics);
 
@@ -563,8 +547,8 @@ void SDLConnector::resetGraphics() {
     const int middleSplit = 20;
 
     // Board data
-    const auto& enemyCards = game.getEnemyCards();
-    const auto& playerCards = game.getPlayerCards();
+    const Card* enemyCards = game.getEnemyCards();
+    const Card* playerCards = game.getPlayerCards();
 
     // Compute assault area dimensions
     const int assaultW = (5 * (cardW + 2 * cardSpacing)) + (4 * cardSpacing);
@@ -574,7 +558,7 @@ void SDLConnector::resetGraphics() {
     const int playerCardY = (yDimension / 2) + (middleSplit / 2) + cardBorder;
 
     // Create slots and add any cards in play
-    for (size_t i = 0; i < enemyCards.size(); ++i) {
+    for (size_t i = 0; i < GameState::slotCount; ++i) {
         int x = firstCardX + static_cast<int>(i) * (cardW + cardSpacing);
         int ey = enemyCardY + cardBorder;
         int py = playerCardY + cardBorder;
@@ -584,19 +568,19 @@ void SDLConnector::resetGraphics() {
         assaultSlots.push_back(CardSlot(x, ey));   // index = 2*i + 1
 
         // AI card in slot?
-        if (enemyCards[i] != nullptr) {
+        if (!enemyCards[i].isBlank()) {
             cardGraphics.push_back(CardGraphic(enemyCards[i], x, ey));
             assaultSlots[2 * i + 1].addCardGraphic(&cardGraphics.back());
         }
         // Player card in slot?
-        if (playerCards[i] != nullptr) {
+        if (!playerCards[i].isBlank()) {
             cardGraphics.push_back(CardGraphic(playerCards[i], x, py));
             assaultSlots[2 * i].addCardGraphic(&cardGraphics.back());
         }
     }
 
     // Draw the player's hand at the bottom
-    const std::vector<Card*>& playerHand = game.getPlayerHand();
+    const Hand& playerHand = game.getPlayerHand();
     const int vMargin = 20;
     const int handW = static_cast<int>(playerHand.size()) * (cardW + 2 * cardSpacing);
     const int handH = cardH + 2 * cardBorder;
@@ -606,19 +590,18 @@ void SDLConnector::resetGraphics() {
     for (size_t i = 0; i < playerHand.size(); ++i) {
         int x = handX + static_cast<int>(i) * (cardW + cardSpacing);
         int y = handY + cardBorder;
-        cardGraphics.push_back(CardGraphic(playerHand[i], x, y));
+        cardGraphics.push_back(CardGraphic(Card(playerHand[i]), x, y));
     }
 
     // Draw the enemy's hand (face-down) at the top
-    const std::vector<Card*>& enemyHand = game.getEnemyHand();
+    const Hand& enemyHand = game.getEnemyHand();
     const int eHandY = vMargin + cardBorder;
     const int ehandW = static_cast<int>(enemyHand.size()) * (cardW + 2 * cardSpacing);
     const int ehandX = (xDimension - ehandW) / 2;
 
     for (size_t i = 0; i < enemyHand.size(); ++i) {
-        if (enemyHand[i] == nullptr) continue;
         int x = ehandX + static_cast<int>(i) * (cardW + cardSpacing);
         int y = eHandY;
-        cardGraphics.push_back(CardGraphic(enemyHand[i], x, y));
+        cardGraphics.push_back(CardGraphic(Card(enemyHand[i]), x, y));
     }
 }
\ No newline at end of file
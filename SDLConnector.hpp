@@ -4,6 +4,7 @@
 #include <SDL_ttf.h>
 #include <SDL_image.h>
 #include <string>
+#include <map>
 
 #include "Render.hpp"
 #include "Front.hpp"
@@ -26,23 +27,39 @@ public:
     static const int borderSize = 5;
     bool selected = false;
 
-    CardGraphic(Card* card, int x, int y, Color color = CLEAR)
+    CardGraphic(Card card, int x, int y, Color color = CLEAR)
         : Button(x, y, cardW, cardH, color),
         card(card) {
     }
 
     void render(Canvas* canvas);
     void renderCardStats(Canvas* canvas);
-    void setCard(Card* card) { this->card = card; }
-    const Card* getCard() const { return this->card; }
-
-    static std::map<SpecialAbility, std::string> specialAbilityNames;
-    static std::map<PlayCondition, std::string> playConditionNames;
+    void setCard(Card card) { this->card = card; }
+    const Card& getCard() const { return this->card; }
+
+    // Display names, indexed by SpecialAbility and PlayCondition
+    static constexpr const char* specialAbilityNames[] = {
+        "None",
+        "Surprise",
+        "Inspire",
+        "Reinforce",
+        "Rally",
+        "Armor Pierce",
+        "Hate",
+        "Kamikaze",
+    };
+    static constexpr const char* playConditionNames[] = {
+        "Free",
+        "Aggressive",
+        "Defensive",
+    };
+    static_assert(sizeof(specialAbilityNames) / sizeof(specialAbilityNames[0]) == ABILITY_COUNT, "Every SpecialAbility needs a name");
+    static_assert(sizeof(playConditionNames) / sizeof(playConditionNames[0]) == CONDITION_COUNT, "Every PlayCondition needs a name");
     static std::map<CardID, SDL_Texture*> cardTextures;
     static void loadTextures(SDL_Renderer* renderer);
 
 private:
-    const Card* card;
+    Card card; // Copy of the displayed card. BLANK when the graphic shows nothing
 };
 
 class CardSlot : public Button {
@@ -0,0 +1,439 @@
+#include "Simulation.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Arguments.hpp"
+#include "Enemy.hpp"
+#include "Moves.hpp"
+#include "EventTable.hpp"
+
+
+void SimulationResult::merge(const SimulationResult& other) {
+    this->games += other.games;
+    this->playerWins += other.playerWins;
+    this->enemyWins += other.enemyWins;
+    this->draws += other.draws;
+    this->timeouts += other.timeouts;
+    this->totalRounds += other.totalRounds;
+    this->playerWinMargin += other.playerWinMargin;
+    this->enemyWinMargin += other.enemyWinMargin;
+    this->assaultsVerified += other.assaultsVerified;
+    this->assaultMismatches += other.assaultMismatches;
+    this->movesVerified += other.movesVerified;
+    this->moveMismatches += other.moveMismatches;
+    this->countersVerified += other.countersVerified;
+    this->counterMismatches += other.counterMismatches;
+    this->eventsWritten += other.eventsWritten;
+    this->eventBytes += other.eventBytes;
+    this->endgamePositions = std::max(this->endgamePositions, other.endgamePositions);
+    this->search.merge(other.search);
+}
+
+void ScriptedPlayer::turn() {
+    // Draw up to hand limit
+    game->drawCards(true);
+
+    if (game->first) {
+        attack();
+    }
+    else {
+        defend();
+    }
+}
+
+void ScriptedPlayer::attack() {
+    const Card* cards = game->getPlayerCards();
+
+    for (int pos = 0; pos < GameState::slotCount; pos++) {
+        if (!cards[pos].isBlank()) {
+            continue;
+        }
+        int card = firstLegalCard(game->getState(), game->first, true, pos);
+        if (card >= 0) {
+            game->playCard(true, card, pos);
+        }
+    }
+}
+
+void ScriptedPlayer::defend() {
+    const Card* cards = game->getPlayerCards();
+    const Card* enemyCards = game->getEnemyCards();
+
+    for (int pos = 0; pos < GameState::slotCount; pos++) {
+        if (enemyCards[pos].isBlank() || !cards[pos].isBlank()) {
+            // Nothing to block, or already blocked
+            continue;
+        }
+        int card = firstLegalCard(game->getState(), game->first, true, pos);
+        if (card >= 0) {
+            game->playCard(true, card, pos);
+        }
+    }
+}
+
+void Simulator::playGame(Director& game, EnemyAI& enemy, ScriptedPlayer& player, std::uint64_t seed, SimulationResult& result) const {
+    game.startGame(seed);
+
+    // Same round structure as the SDL frontend: whoever is first deploys, the other side answers, then the assault is resolved.
+    int rounds = 0;
+    bool isRunning = true;
+    while (isRunning && rounds < config.maxRounds) {
+        if (!game.first) { // Enemy attacks first
+            enemy.turn();
+        }
+        player.turn();
+        if (game.first) { // Enemy defends
+            enemy.turn();
+        }
+
+        if (config.verifyAssault) {
+            verifyMoves(game, result);
+
+            // Differential check: the reference implementation on a copy must end in exactly the same state
+            Director reference = game;
+            bool referenceRunning = reference.turnAttackReference();
+            isRunning = game.turnAttack();
+            result.assaultsVerified++;
+            if (referenceRunning != isRunning || !(reference.getState() == game.getState())) {
+                result.assaultMismatches++;
+            }
+        }
+        else {
+            isRunning = game.turnAttack();
+        }
+        game.first = !game.first; // Switch turns
+        rounds++;
+    }
+
+    result.games++;
+    result.totalRounds += rounds;
+
+    int playerHealth = game.getPlayerHealth();
+    int enemyHealth = game.getEnemyHealth();
+    if (isRunning) {
+        result.timeouts++;
+    }
+    else if (playerHealth > 0) {
+        result.playerWins++;
+        result.playerWinMargin += playerHealth;
+    }
+    else if (enemyHealth > 0) {
+        result.enemyWins++;
+        result.enemyWinMargin += enemyHealth;
+    }
+    else {
+        result.draws++;
+    }
+}
+
+void Simulator::verifyMoves(const Director& game, SimulationResult& result) {
+    const GameState& before = game.getState();
+    GameState state = before;
+    UndoStack undo;
+
+    // The incremental hash must always match the one computed from scratch
+    result.movesVerified++;
+    if (!(before.hash == before.computeHash())) {
+        result.moveMismatches++;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        LegalMoves legal = generateMoves(before, game.first, side != 0, false);
+        for (int handIndex = 0; handIndex < state.hand(side != 0).size(); handIndex++) {
+            for (int slot = 0; slot < GameState::slotCount; slot++) {
+                Move move = { static_cast<std::int8_t>(side), static_cast<std::int8_t>(handIndex), static_cast<std::int8_t>(slot) };
+                Director reference = game;
+                bool referencePlayed = reference.playCard(side != 0, handIndex, slot);
+                bool played = applyMove(state, game.first, move, undo);
+
+                bool generated = (legal.slots[handIndex] >> slot) & 1;
+                bool match = played == referencePlayed && generated == referencePlayed && state == reference.getState()
+                    && state.hash == state.computeHash();
+                if (played) {
+                    undoMove(state, undo);
+                }
+                result.movesVerified++;
+                if (!match || !(state == before) || !undo.empty()) {
+                    result.moveMismatches++;
+                    state = before;
+                    undo.clear();
+                }
+            }
+        }
+    }
+
+    Director reference = game;
+    bool referenceRunning = reference.turnAttack();
+    bool running = false;
+    bool applied = applyAssault(state, undo, running);
+    bool match = applied && running == referenceRunning && state == reference.getState() && state.hash == state.computeHash();
+    if (applied) {
+        undoAssault(state, undo);
+    }
+    result.movesVerified++;
+    if (!match || !(state == before)) {
+        result.moveMismatches++;
+    }
+
+    // The copies above played on without the counter, so it must still add up to the game
+    if (game.getCounter()) {
+        result.countersVerified++;
+        if (!game.getCounter()->matches(before)) {
+            result.counterMismatches++;
+        }
+    }
+}
+
+SimulationResult Simulator::run() {
+    int threadCount = config.threads;
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Games are handed out in small chunks so fast threads don't sit idle at the end of the run
+    const long long chunkSize = 64;
+    std::atomic<long long> nextGame = 0;
+    std::atomic<int> nextWorker = 0;
+    std::mutex resultMutex;
+    SimulationResult total;
+
+    // One endgame table for every worker, so each position is solved once per run
+    std::shared_ptr<EndgameTable> endgameTable;
+    if (!config.endgamePath.empty()) {
+        endgameTable = std::make_shared<EndgameTable>();
+        endgameTable->load(config.endgamePath);
+    }
+
+    auto worker = [&]() {
+        int workerIndex = nextWorker++;
+        // Each worker reuses one match for all of its games
+        Director game;
+        EnemyAI enemy(&game);
+        enemy.setProfile(config.profile);
+        if (config.blocking) {
+            enemy.useBlockingSolver();
+        }
+        if (config.attackPlanner) {
+            enemy.useAttackPlanner();
+        }
+        ScriptedPlayer player(&game);
+        if (config.searchBudgetMs > 0 && config.alphaBeta) {
+            AlphaBetaConfig search;
+            search.budgetMs = config.searchBudgetMs;
+            enemy.useAlphaBeta(search);
+        }
+        else if (config.searchBudgetMs > 0) {
+            MonteCarloConfig search;
+            search.budgetMs = config.searchBudgetMs;
+            search.threads = config.searchThreads;
+            enemy.useMonteCarlo(search);
+        }
+        if (endgameTable) {
+            enemy.useEndgameSolver(config.endgame, endgameTable);
+        }
+        SimulationResult local;
+
+        // Each worker has its own event file, so recording needs no locks
+        EventTableWriter events;
+        bool recording = !config.eventPrefix.empty() && events.open(config.eventPrefix + "." + std::to_string(workerIndex) + ".events");
+        if (recording) {
+            EventLog::setConsumer(&events);
+        }
+        while (true) {
+            long long start = nextGame.fetch_add(chunkSize);
+            if (start >= config.games) {
+                break;
+            }
+            long long end = std::min(start + chunkSize, config.games);
+            for (long long i = start; i < end; i++) {
+                if (recording) {
+                    EventLog::flush();
+                    events.beginGame(i);
+                }
+                playGame(game, enemy, player, gameSeed(config.seed, i), local);
+            }
+        }
+        if (recording) {
+            EventLog::setConsumer(nullptr);
+            events.close();
+            local.eventsWritten = events.getRows();
+            local.eventBytes = events.getBytes();
+        }
+
+        if (enemy.getPlanner()) {
+            local.search = enemy.getPlanner()->getTotals();
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        total.merge(local);
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (endgameTable) {
+        endgameTable->save(config.endgamePath);
+        total.endgamePositions = static_cast<long long>(endgameTable->size());
+    }
+    return total;
+}
+
+void Simulator::printReport(const SimulationResult& result) {
+    auto percent = [&](long long count) {
+        return result.games > 0 ? 100.0 * count / result.games : 0.0;
+    };
+    auto average = [](long long sum, long long count) {
+        return count > 0 ? static_cast<double>(sum) / count : 0.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Games played:       " << result.games << "\n";
+    std::cout << "Time:               " << result.seconds << " s\n";
+    std::cout << "Games per second:   " << (result.seconds > 0 ? result.games / result.seconds : 0.0) << "\n";
+    std::cout << "Player wins:        " << result.playerWins << " (" << percent(result.playerWins) << "%)\n";
+    std::cout << "Enemy wins:         " << result.enemyWins << " (" << percent(result.enemyWins) << "%)\n";
+    std::cout << "Draws:              " << result.draws << " (" << percent(result.draws) << "%)\n";
+    std::cout << "Timeouts:           " << result.timeouts << " (" << percent(result.timeouts) << "%)\n";
+    std::cout << "Average rounds:     " << average(result.totalRounds, result.games) << "\n";
+    std::cout << "Player win margin:  " << average(result.playerWinMargin, result.playerWins) << " HP\n";
+    std::cout << "Enemy win margin:   " << average(result.enemyWinMargin, result.enemyWins) << " HP\n";
+    if (result.assaultsVerified > 0) {
+        std::cout << "Assaults verified:  " << result.assaultsVerified << " (" << result.assaultMismatches << " mismatches)\n";
+    }
+    if (result.movesVerified > 0) {
+        std::cout << "Moves verified:     " << result.movesVerified << " (" << result.moveMismatches << " mismatches)\n";
+    }
+    if (result.countersVerified > 0) {
+        std::cout << "Counters verified:  " << result.countersVerified << " (" << result.counterMismatches << " mismatches)\n";
+    }
+    if (result.eventsWritten > 0) {
+        std::cout << "Events written:     " << result.eventsWritten << " (" << result.eventBytes / 1048576.0 << " MB, "
+            << static_cast<double>(result.eventBytes) / result.eventsWritten << " bytes each)\n";
+    }
+    const PlannerStats& search = result.search;
+    if (search.decisions > 0) {
+        std::cout << "Search decisions:   " << search.decisions << " (" << 1000.0 * search.seconds / search.decisions << " ms, "
+            << average(search.nodes, search.decisions) << " nodes each)\n";
+        std::cout << "Search nodes/s:     " << (search.seconds > 0 ? search.nodes / search.seconds : 0.0) << "\n";
+        std::cout << "Proven wins:        " << search.lethal << " (played without a search, see Lethal.hpp)\n";
+    }
+    if (result.endgamePositions > 0) {
+        std::cout << "Endgames solved:    " << search.endgame << " (" << average(search.tableHits, search.endgame) << " table hits each)\n";
+        std::cout << "Endgame table:      " << result.endgamePositions << " positions\n";
+    }
+    if (search.cutoffs > 0) {
+        std::cout << "Cutoffs:            " << search.cutoffs << " (" << 100.0 * search.firstMoveCutoffs / search.cutoffs << "% on the first move, "
+            << 100.0 * search.cutoffs / search.nodes << "% of nodes)\n";
+        std::cout << "Table hits:         " << search.tableHits << "\n";
+        std::cout << "Average depth:      " << average(search.depth, search.decisions) << "\n";
+    }
+    std::cout << "Memory per match:   " << sizeof(Director) << " bytes (" << sizeof(GameState) << " bytes of game state)\n";
+}
+
+int runSimulation(int argc, char* argv[]) {
+    SimulationConfig config;
+    config.profile = activeProfile;
+    bool hasSeed = false;
+    const int maxInt = std::numeric_limits<int>::max();
+    const char* usage = "Usage: --simulate [--games N] [--threads N] [--max-rounds N] [--seed N] [--verify-assault] [--search MS] [--planner mcts|alphabeta] [--search-threads N] [--profile NAME] [--events PREFIX] [--blocking] [--attack-planner] [--endgame PATH] [--endgame-health N] [--endgame-rounds N]\n";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--simulate") {
+            continue;
+        }
+        else if (arg == "--games" && hasValue) {
+            valid = parseNumber(argv[++i], 1, std::numeric_limits<long long>::max(), config.games);
+        }
+        else if (arg == "--threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.threads);
+        }
+        else if (arg == "--max-rounds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxInt, config.maxRounds);
+        }
+        else if (arg == "--verify-assault") {
+            config.verifyAssault = true;
+        }
+        else if (arg == "--search" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.searchBudgetMs);
+        }
+        else if (arg == "--planner" && hasValue) {
+            std::string planner = argv[++i];
+            if (planner != "mcts" && planner != "alphabeta") {
+                std::cerr << "Unknown planner: " << planner << " (mcts or alphabeta)\n";
+                return 1;
+            }
+            config.alphaBeta = planner == "alphabeta";
+        }
+        else if (arg == "--search-threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.searchThreads);
+        }
+        else if (arg == "--seed" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<std::uint64_t>::max(), config.seed);
+            hasSeed = true;
+        }
+        else if (arg == "--profile" && hasValue) {
+            const EnemyProfile* profile = ProfileDatabase::find(argv[++i]);
+            if (!profile) {
+                std::cerr << "Unknown enemy profile: " << argv[i] << "\n";
+                return 1;
+            }
+            config.profile = *profile;
+        }
+        else if (arg == "--blocking") {
+            config.blocking = true;
+        }
+        else if (arg == "--attack-planner") {
+            config.attackPlanner = true;
+        }
+        else if (arg == "--endgame" && hasValue) {
+            config.endgamePath = argv[++i];
+        }
+        else if (arg == "--endgame-health" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.endgame.totalHealth);
+        }
+        else if (arg == "--endgame-rounds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxInt, config.endgame.rounds);
+        }
+        else if (arg == "--events" && hasValue) {
+            config.eventPrefix = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown simulation argument: " << arg << "\n" << usage;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n" << usage;
+            return 1;
+        }
+    }
+    if (!hasSeed) {
+        config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    std::cout << "Run seed: " << config.seed << "\n";
+
+    // Unless --events is given, worker threads have no event consumer installed, so the rules engine doesn't record anything during the run
+    Simulator simulator(config);
+    SimulationResult result = simulator.run();
+
+    Simulator::printReport(result);
+    return 0;
+}
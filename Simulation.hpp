@@ -0,0 +1,119 @@
+/*
+Simulation.hpp defines the headless match simulator. It plays complete games between two scripted/AI policies using only the rules engine (Director),
+without ever touching SDL, and is used for balance work where millions of games are needed per run.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Game.hpp"
+#include "Enemy.hpp"
+#include "Planner.hpp"
+
+/**
+ * @brief SimulationConfig holds the knobs of a simulation run. Every field can be set from the command line (see runSimulation).
+ */
+typedef struct SimulationConfig {
+    long long games = 100000; // Total number of games to play
+    int threads = 0; // Worker threads. 0 = one per hardware thread
+    int maxRounds = 500; // Games still running after this many rounds are counted as timeouts
+    std::uint64_t seed = 0; // Run seed. Game i is played with gameSeed(seed, i), so every game can be replayed on its own
+    bool verifyAssault = false; // Also run Director::turnAttackReference on a copy of every assault and count mismatches with the kernel,
+                                // and check the make/unmake API (Moves.hpp) against Director on every position, and the enemy's card counter if it has one
+    int searchBudgetMs = 0; // > 0: the enemy plans its turns with a search, this many milliseconds per turn (see EnemyAI::usePlanner)
+    bool alphaBeta = false; // Search with AlphaBetaSearch instead of MonteCarloSearch
+    int searchThreads = 1; // Threads of each worker's Monte Carlo search. 0 = one per hardware thread
+    bool blocking = false; // The enemy defends with the blocking solver (see EnemyAI::useBlockingSolver)
+    bool attackPlanner = false; // The enemy attacks with the attack planner (see EnemyAI::useAttackPlanner)
+    std::string endgamePath; // Non-empty: the enemy solves endgames (see EnemyAI::useEndgameSolver) with the table saved at this path,
+                             // loaded before the run and saved after it
+    EndgameConfig endgame;
+    EnemyProfile profile; // Parameters of the enemy's script (see Profile.hpp). runSimulation starts from the active profile
+    std::string eventPrefix; // Non-empty: every worker writes all events of its games to PREFIX.N.events (see EventTable.hpp)
+} SimulationConfig;
+
+/**
+ * @brief SimulationResult accumulates the outcome of a batch of games. Workers fill their own copy and merge them at the end of the run.
+ */
+typedef struct SimulationResult {
+    long long games = 0;
+    long long playerWins = 0;
+    long long enemyWins = 0;
+    long long draws = 0; // Both sides reached 0 health in the same assault
+    long long timeouts = 0; // Game hit SimulationConfig::maxRounds
+
+    long long totalRounds = 0;
+    long long playerWinMargin = 0; // Sum of the player's remaining health over games the player won
+    long long enemyWinMargin = 0; // Sum of the enemy's remaining health over games the enemy won
+    long long assaultsVerified = 0;
+    long long assaultMismatches = 0; // Assaults where the kernel and the reference implementation disagreed
+    long long movesVerified = 0;
+    long long moveMismatches = 0; // Placements or assaults where applyMove/applyAssault or their undo disagreed with Director
+    long long countersVerified = 0;
+    long long counterMismatches = 0; // Rounds where the enemy's card counter no longer added up to the state (see CardCounter::matches)
+    long long eventsWritten = 0;
+    long long eventBytes = 0;
+    long long endgamePositions = 0; // Positions in the endgame table at the end of the run
+    PlannerStats search; // Work of the enemy's planner, if it used one
+
+    double seconds = 0.0; // Wall-clock time of the run
+
+    void merge(const SimulationResult& other);
+} SimulationResult;
+
+/**
+ * @brief ScriptedPlayer is a simple policy for the player side, mirroring what EnemyAI does for the enemy:
+ * on attack it fills every empty slot with the first card that can attack, on defense it blocks every attacked slot with the first card that is allowed to.
+ */
+class ScriptedPlayer {
+public:
+    ScriptedPlayer(Director* game) : game(game) {}
+
+    void turn();
+    void attack();
+    void defend();
+
+private:
+    Director* game;
+};
+
+/**
+ * @brief The Simulator plays SimulationConfig::games games on all worker threads and collects a SimulationResult.
+ */
+class Simulator {
+public:
+    Simulator(SimulationConfig config) : config(config) {}
+
+    SimulationResult run();
+
+    /**
+     * @brief playGame restarts game and plays it to completion (or until the round limit), then records its outcome.
+     * @param result The result the outcome is added to.
+     */
+    void playGame(Director& game, EnemyAI& enemy, ScriptedPlayer& player, std::uint64_t seed, SimulationResult& result) const;
+
+    /**
+     * @brief verifyMoves checks every placement of both sides, and the assault, through the move generator and the make/unmake API
+     * against Director on a copy of game. Then checks that game's card counter, if one is attached, still adds up to the state.
+     */
+    static void verifyMoves(const Director& game, SimulationResult& result);
+
+    // Seed of game index within a run. Independent of which thread ends up playing the game.
+    // The run seed is mixed before the index is added, so runs with nearby seeds don't share their games (run s + 1 would replay run s shifted by one)
+    static std::uint64_t gameSeed(std::uint64_t runSeed, long long index) { return Rng::mix(Rng::mix(runSeed) + static_cast<std::uint64_t>(index)); }
+
+    static void printReport(const SimulationResult& result);
+
+private:
+    SimulationConfig config;
+};
+
+/**
+ * @brief runSimulation is the entry point of the headless mode (Rohans-Last-Stand --simulate [--games N] [--threads N] [--max-rounds N] [--seed N] [--verify-assault]
+ * [--profile NAME] [--events PREFIX] [--blocking] [--attack-planner]
+ * [--endgame PATH] [--endgame-health N] [--endgame-rounds N]).
+ * @return The process exit code.
+ */
+int runSimulation(int argc, char* argv[]);
@@ -0,0 +1,490 @@
+#include "Sweep.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include "Arguments.hpp"
+#include "CardDatabase.hpp"
+#include "Policy.hpp"
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+#include "Tournament.hpp"
+
+
+namespace {
+    constexpr const char* kindNames[] = { "player", "enemy", "health", "attack", "defense" };
+
+    // Games played between two looks at the stopping rules: a few at first, since lopsided configurations stop within dozens of games,
+    // then doubling. The rules are still applied game by game, in seed order, so where a configuration stops doesn't depend on the threads
+    const int firstStepGames = 32;
+    const int stepGames = 256;
+    // The precision rule needs a few games first, or a run of wins would look like a certain result
+    const long long minimumGames = 64;
+
+    std::string trim(const std::string& text) {
+        std::size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        std::size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::vector<std::string> split(const std::string& line, char separator) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, separator)) {
+            fields.push_back(trim(field));
+        }
+        return fields;
+    }
+}
+
+bool SweepDimension::parse(const std::string& line, SweepDimension& dimension) {
+    std::vector<std::string> fields = split(line, '|');
+    if (fields.size() != 3) {
+        std::cerr << "Sweep: Expected KIND | CARD | VALUES, got \"" << line << "\"\n";
+        return false;
+    }
+
+    int kind = -1;
+    for (int i = 0; i < static_cast<int>(sizeof(kindNames) / sizeof(kindNames[0])); i++) {
+        if (fields[0] == kindNames[i]) {
+            kind = i;
+        }
+    }
+    if (kind < 0) {
+        std::cerr << "Sweep: Unknown kind " << fields[0] << " (player, enemy, health, attack or defense)\n";
+        return false;
+    }
+    dimension.kind = static_cast<Kind>(kind);
+    dimension.card = CardDatabase::findCard(fields[1]);
+    if (dimension.card == BLANK) {
+        std::cerr << "Sweep: Unknown card ID " << fields[1] << "\n";
+        return false;
+    }
+
+    // Same limits as the definitions file, except that a deck may leave a card out
+    int minimum = dimension.kind == HEALTH ? 1 : 0;
+    int maximum = dimension.kind == PLAYER_COPIES || dimension.kind == ENEMY_COPIES ? Deck::capacity : 9999;
+    dimension.values.clear();
+    for (const std::string& item : split(fields[2], ',')) {
+        std::size_t dots = item.find("..");
+        int low = 0, high = 0;
+        bool valid = dots == std::string::npos ? parseNumber(item, 0, 99999, low) && parseNumber(item, 0, 99999, high)
+            : parseNumber(trim(item.substr(0, dots)), 0, 99999, low) && parseNumber(trim(item.substr(dots + 2)), 0, 99999, high);
+        if (!valid || low > high || low < minimum || high > maximum) {
+            std::cerr << "Sweep: Bad value " << item << " for " << dimension.label() << " (" << minimum << " to " << maximum << ")\n";
+            return false;
+        }
+        for (int value = low; value <= high; value++) {
+            dimension.values.push_back(value);
+        }
+    }
+    if (dimension.values.empty()) {
+        std::cerr << "Sweep: " << dimension.label() << " has no values\n";
+        return false;
+    }
+    return true;
+}
+
+std::string SweepDimension::label() const {
+    if (this->kind == PLAYER_COPIES || this->kind == ENEMY_COPIES) {
+        return std::string(kindNames[this->kind]) + " " + CardDatabase::identifier(this->card);
+    }
+    return std::string(CardDatabase::identifier(this->card)) + " " + kindNames[this->kind];
+}
+
+double SweepPoint::score() const {
+    return this->games > 0 ? (this->playerWins + 0.5 * this->draws) / this->games : 0.5;
+}
+
+double SweepPoint::scoreError() const {
+    if (this->games < 2) {
+        return 0.5;
+    }
+    double mean = score();
+    double squares = this->playerWins + 0.25 * this->draws;
+    double variance = std::max(0.0, (squares - this->games * mean * mean) / (this->games - 1));
+    return 1.96 * std::sqrt(variance / this->games);
+}
+
+const char* SweepPoint::verdictName(Verdict verdict) {
+    switch (verdict) {
+    case PLAYER_FAVOURED: return "player";
+    case ENEMY_FAVOURED: return "enemy";
+    case BALANCED: return "balanced";
+    case INVALID: return "invalid";
+    default: return "undecided";
+    }
+}
+
+unsigned long long Sweep::gridSize(const std::vector<SweepDimension>& dimensions) {
+    const unsigned long long limit = 1ull << 62;
+    unsigned long long size = 1;
+    for (const SweepDimension& dimension : dimensions) {
+        size = size > limit / dimension.values.size() ? limit : size * dimension.values.size();
+    }
+    return size;
+}
+
+std::vector<unsigned long long> Sweep::choosePoints() const {
+    const unsigned long long size = gridSize(this->config.dimensions);
+    const unsigned long long samples = std::min<unsigned long long>(this->config.samples, maxPoints);
+
+    std::vector<unsigned long long> indices;
+    if (samples == 0 || samples >= size) {
+        for (unsigned long long i = 0; i < std::min(size, maxPoints); i++) {
+            indices.push_back(i);
+        }
+        return indices;
+    }
+
+    // Distinct random points, played in grid order
+    Rng rng(Rng::mix(this->config.seed ^ 0x5357454550ull));
+    std::uniform_int_distribution<unsigned long long> pick(0, size - 1);
+    std::set<unsigned long long> chosen;
+    while (chosen.size() < samples) {
+        chosen.insert(pick(rng));
+    }
+    return std::vector<unsigned long long>(chosen.begin(), chosen.end());
+}
+
+bool Sweep::activate(const SweepPoint& point, const CardSet& base) {
+    std::copy(base.cards, base.cards + CARD_COUNT, this->cards);
+    int copies[2][CARD_COUNT] = {};
+    bool listed[2][CARD_COUNT] = {};
+    this->decks[0].assign(base.playerDeck, base.playerDeck + base.playerDeckSize);
+    this->decks[1].assign(base.enemyDeck, base.enemyDeck + base.enemyDeckSize);
+    for (int side = 0; side < 2; side++) {
+        for (const DeckEntry& entry : this->decks[side]) {
+            copies[side][entry.id] += entry.count;
+            listed[side][entry.id] = true;
+        }
+    }
+
+    for (std::size_t i = 0; i < this->config.dimensions.size(); i++) {
+        const SweepDimension& dimension = this->config.dimensions[i];
+        int value = point.values[i];
+        CardType& type = this->cards[dimension.card];
+        switch (dimension.kind) {
+        case SweepDimension::PLAYER_COPIES: copies[0][dimension.card] = value; break;
+        case SweepDimension::ENEMY_COPIES: copies[1][dimension.card] = value; break;
+        case SweepDimension::HEALTH: type.maxHealth = value; break;
+        case SweepDimension::ATTACK: type.attack = value; break;
+        case SweepDimension::DEFENSE: type.defense = value; break;
+        }
+    }
+
+    // Deck lists keep their order. Cards the base decks didn't have go at the end, cards swept down to 0 copies are dropped
+    for (int side = 0; side < 2; side++) {
+        std::vector<DeckEntry> deck;
+        int total = 0;
+        for (const DeckEntry& entry : this->decks[side]) {
+            if (copies[side][entry.id] > 0) {
+                deck.push_back({ entry.id, copies[side][entry.id] });
+                total += copies[side][entry.id];
+                copies[side][entry.id] = 0; // Listed twice in the base deck: the swept count applies once
+            }
+        }
+        for (int id = 0; id < CARD_COUNT; id++) {
+            if (!listed[side][id] && copies[side][id] > 0) {
+                deck.push_back({ static_cast<CardID>(id), copies[side][id] });
+                total += copies[side][id];
+            }
+        }
+        if (total == 0 || total > Deck::capacity) {
+            return false;
+        }
+        this->decks[side] = std::move(deck);
+    }
+
+    CardSet set;
+    set.cards = this->cards;
+    set.playerDeck = this->decks[0].data();
+    set.playerDeckSize = static_cast<int>(this->decks[0].size());
+    set.enemyDeck = this->decks[1].data();
+    set.enemyDeckSize = static_cast<int>(this->decks[1].size());
+    CardDatabase::activate(set);
+    return true;
+}
+
+SweepResult Sweep::run() {
+    SweepResult result;
+    for (const std::string& name : { this->config.player, this->config.enemy }) {
+        if (!makePolicy(name)) {
+            std::cerr << "Unknown policy: " << name << " (scripted, greedy, blocking, tactical, profile:NAME, mcts:MS or alphabeta:MS)\n";
+            return result;
+        }
+    }
+    result.dimensions = this->config.dimensions;
+
+    // Wald's bounds on the log-likelihood ratio, and its step for each game score
+    const double low = this->config.target - this->config.margin;
+    const double high = this->config.target + this->config.margin;
+    const double acceptHigh = std::log((1.0 - this->config.errorRate) / this->config.errorRate);
+    const double acceptLow = -acceptHigh;
+    const double winStep = std::log(high / low);
+    const double lossStep = std::log((1.0 - high) / (1.0 - low));
+
+    ThreadPool pool(this->config.threads);
+    std::vector<std::unique_ptr<Policy>> players;
+    std::vector<std::unique_ptr<Policy>> enemies;
+    std::vector<Director> games(pool.size());
+    for (int i = 0; i < pool.size(); i++) {
+        players.push_back(makePolicy(this->config.player));
+        enemies.push_back(makePolicy(this->config.enemy));
+    }
+    int outcomes[stepGames];
+
+    const CardSet base = activeCardSet;
+    auto startTime = std::chrono::steady_clock::now();
+    for (unsigned long long index : choosePoints()) {
+        // Grid index to values, the last dimension changing fastest
+        SweepPoint point;
+        point.values.resize(this->config.dimensions.size());
+        for (std::size_t i = this->config.dimensions.size(); i-- > 0;) {
+            const std::vector<int>& values = this->config.dimensions[i].values;
+            point.values[i] = values[index % values.size()];
+            index /= values.size();
+        }
+        if (!activate(point, base)) {
+            point.verdict = SweepPoint::INVALID;
+            result.points.push_back(point);
+            continue;
+        }
+
+        long long played = 0;
+        int step = firstStepGames;
+        bool stopped = false;
+        while (!stopped && played < this->config.maxGames) {
+            const int count = static_cast<int>(std::min<long long>(step, this->config.maxGames - played));
+            step = std::min(2 * step, stepGames);
+            pool.parallel([&](int worker) {
+                for (int i = worker; i < count; i += pool.size()) {
+                    std::uint64_t seed = Simulator::gameSeed(this->config.seed, played + i);
+                    outcomes[i] = Tournament::playGame(games[worker], *players[worker], *enemies[worker], seed, this->config.maxRounds);
+                }
+            });
+            played += count;
+
+            for (int i = 0; i < count && !stopped; i++) {
+                point.games++;
+                point.playerWins += outcomes[i] > 0;
+                point.enemyWins += outcomes[i] < 0;
+                point.draws += outcomes[i] == 0;
+                double score = 0.5 * (outcomes[i] + 1);
+                point.logLikelihoodRatio += score * winStep + (1.0 - score) * lossStep;
+
+                if (point.logLikelihoodRatio >= acceptHigh) {
+                    point.verdict = SweepPoint::PLAYER_FAVOURED;
+                }
+                else if (point.logLikelihoodRatio <= acceptLow) {
+                    point.verdict = SweepPoint::ENEMY_FAVOURED;
+                }
+                else if (point.games >= minimumGames && point.scoreError() <= this->config.precision) {
+                    double offset = point.score() - this->config.target;
+                    point.verdict = std::abs(offset) < this->config.margin ? SweepPoint::BALANCED
+                        : offset > 0 ? SweepPoint::PLAYER_FAVOURED : SweepPoint::ENEMY_FAVOURED;
+                }
+                stopped = point.verdict != SweepPoint::UNDECIDED;
+            }
+        }
+        result.games += played;
+        result.points.push_back(point);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    CardDatabase::activate(base);
+    return result;
+}
+
+void Sweep::writeTable(std::ostream& out, const SweepResult& result) {
+    std::vector<int> widths;
+    out << std::left << "# " << std::setw(6) << "Config";
+    for (const SweepDimension& dimension : result.dimensions) {
+        widths.push_back(static_cast<int>(std::max<std::size_t>(dimension.label().size(), 6)));
+        out << " | " << std::setw(widths.back()) << dimension.label();
+    }
+    out << " | " << std::setw(8) << "Games" << " | " << std::setw(12) << "Player score" << " | " << std::setw(8) << "+/-" << " | Verdict\n";
+
+    out << std::fixed << std::setprecision(4);
+    for (std::size_t p = 0; p < result.points.size(); p++) {
+        const SweepPoint& point = result.points[p];
+        out << std::setw(8) << p + 1;
+        for (std::size_t i = 0; i < point.values.size(); i++) {
+            out << " | " << std::setw(widths[i]) << point.values[i];
+        }
+        out << " | " << std::setw(8) << point.games << " | " << std::setw(12) << point.score() << " | " << std::setw(8) << point.scoreError()
+            << " | " << SweepPoint::verdictName(point.verdict) << "\n";
+    }
+    out << std::right;
+}
+
+void Sweep::printReport(const SweepResult& result, const SweepConfig& config) {
+    writeTable(std::cout, result);
+
+    long long counts[5] = {};
+    long long played = 0;
+    const SweepPoint* closest = nullptr;
+    for (const SweepPoint& point : result.points) {
+        counts[point.verdict]++;
+        if (point.verdict != SweepPoint::INVALID) {
+            played++;
+            if (!closest || std::abs(point.score() - config.target) < std::abs(closest->score() - config.target)) {
+                closest = &point;
+            }
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\nConfigurations:     " << result.points.size() << " (" << counts[SweepPoint::BALANCED] << " balanced, "
+        << counts[SweepPoint::PLAYER_FAVOURED] << " player, " << counts[SweepPoint::ENEMY_FAVOURED] << " enemy, "
+        << counts[SweepPoint::UNDECIDED] << " undecided, " << counts[SweepPoint::INVALID] << " invalid)\n";
+    std::cout << "Games played:       " << result.games << "\n";
+    std::cout << "Time:               " << result.seconds << " s\n";
+    std::cout << "Games per second:   " << (result.seconds > 0 ? result.games / result.seconds : 0.0) << "\n";
+    if (played > 0) {
+        double fixed = static_cast<double>(played) * config.maxGames;
+        std::cout << "Saved by stopping:  " << 100.0 * (1.0 - result.games / fixed) << "% of " << static_cast<long long>(fixed) << " games\n";
+    }
+    if (closest) {
+        std::cout << "Closest to target:  config " << (closest - result.points.data()) + 1 << ", player score "
+            << std::setprecision(4) << closest->score() << " +/- " << closest->scoreError() << "\n";
+    }
+}
+
+int runSweep(int argc, char* argv[]) {
+    SweepConfig config;
+    bool hasSeed = false;
+    const int maxInt = std::numeric_limits<int>::max();
+    const long long maxLong = std::numeric_limits<long long>::max();
+    const char* usage = "Usage: --sweep [--space FILE] [--vary \"KIND | CARD | VALUES\" ...] [--samples N] [--player NAME] [--enemy NAME] [--target P] [--margin P] "
+        "[--precision P] [--max-games N] [--threads N] [--max-rounds N] [--seed N] [--out FILE]\n";
+
+    auto addDimension = [&](const std::string& line) {
+        SweepDimension dimension;
+        if (!SweepDimension::parse(line, dimension)) {
+            return false;
+        }
+        config.dimensions.push_back(dimension);
+        return true;
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--sweep") {
+            continue;
+        }
+        else if (arg == "--space" && hasValue) {
+            // One dimension per line, # starts a comment
+            std::ifstream in(argv[++i]);
+            if (!in) {
+                std::cerr << "Sweep: Can't read " << argv[i] << "\n";
+                return 1;
+            }
+            std::string line;
+            while (std::getline(in, line)) {
+                line = trim(line.substr(0, line.find('#')));
+                if (!line.empty() && !addDimension(line)) {
+                    return 1;
+                }
+            }
+        }
+        else if (arg == "--vary" && hasValue) {
+            if (!addDimension(argv[++i])) {
+                return 1;
+            }
+        }
+        else if (arg == "--samples" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxLong, config.samples);
+        }
+        else if (arg == "--player" && hasValue) {
+            config.player = argv[++i];
+        }
+        else if (arg == "--enemy" && hasValue) {
+            config.enemy = argv[++i];
+        }
+        else if (arg == "--target" && hasValue) {
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.target);
+        }
+        else if (arg == "--margin" && hasValue) {
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.margin);
+        }
+        else if (arg == "--precision" && hasValue) {
+            // An interval is never 0 wide: the precision must be above 0 to stop anything
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.precision) && config.precision > 0.0;
+        }
+        else if (arg == "--max-games" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxLong, config.maxGames);
+        }
+        else if (arg == "--threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.threads);
+        }
+        else if (arg == "--max-rounds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxInt, config.maxRounds);
+        }
+        else if (arg == "--seed" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<std::uint64_t>::max(), config.seed);
+            hasSeed = true;
+        }
+        else if (arg == "--out" && hasValue) {
+            config.output = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown sweep argument: " << arg << "\n" << usage;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n" << usage;
+            return 1;
+        }
+    }
+    if (config.dimensions.empty()) {
+        std::cerr << "A sweep needs at least one dimension (--space or --vary)\n";
+        return 1;
+    }
+    const unsigned long long size = Sweep::gridSize(config.dimensions);
+    const unsigned long long points = config.samples > 0 ? std::min<unsigned long long>(config.samples, size) : size;
+    if (points > Sweep::maxPoints) {
+        std::cerr << "The sweep would play " << points << " points, more than the " << Sweep::maxPoints
+            << " a sweep can. Narrow the grid, or play some of its points with --samples N\n";
+        return 1;
+    }
+    if (config.margin <= 0.0 || config.target - config.margin <= 0.0 || config.target + config.margin >= 1.0) {
+        std::cerr << "The target score plus or minus the margin must be strictly between 0 and 1\n";
+        return 1;
+    }
+    if (!hasSeed) {
+        config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    std::cout << "Run seed: " << config.seed << "\n";
+
+    Sweep sweep(config);
+    SweepResult result = sweep.run();
+    if (result.dimensions.empty()) {
+        return 1;
+    }
+    Sweep::printReport(result, config);
+
+    if (!config.output.empty()) {
+        std::ofstream out(config.output, std::ios::trunc);
+        if (!out) {
+            std::cerr << "Sweep: Can't write " << config.output << "\n";
+            return 1;
+        }
+        Sweep::writeTable(out, result);
+    }
+    return 0;
+}
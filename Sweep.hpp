@@ -0,0 +1,114 @@
+/*
+Sweep.hpp defines the deck balance sweep: it simulates every configuration of a grid of deck counts and card stats, on all threads,
+and stops each configuration as soon as a sequential probability ratio test (SPRT) knows which side it favours, or its win rate is known
+to the requested precision. Lopsided configurations are settled after a few dozen games, so the budget goes to the close ones.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+/**
+ * @brief SweepDimension is one axis of the grid: a card count in a deck, or a stat of a card, and the values it takes.
+ */
+typedef struct SweepDimension {
+    enum Kind { PLAYER_COPIES, ENEMY_COPIES, HEALTH, ATTACK, DEFENSE };
+
+    Kind kind = ENEMY_COPIES;
+    CardID card = BLANK;
+    std::vector<int> values;
+
+    /**
+     * @brief parse reads a dimension written like a line of the definitions: "KIND | CARD | VALUES".
+     * KIND is player, enemy (copies in that deck), health, attack or defense. VALUES is a comma separated list of numbers and ranges (4..8).
+     * @return Whether line is a valid dimension. Errors are printed.
+     */
+    static bool parse(const std::string& line, SweepDimension& dimension);
+
+    // Column title, like "enemy URUK" or "URUK attack"
+    std::string label() const;
+} SweepDimension;
+
+typedef struct SweepConfig {
+    std::vector<SweepDimension> dimensions;
+    long long samples = 0; // 0 = every point of the grid, otherwise this many distinct random points
+    std::string player = "greedy"; // Policies of both sides, see makePolicy
+    std::string enemy = "scripted";
+    double target = 0.5; // Balanced player score (wins plus half the draws)
+    double margin = 0.05; // The SPRT tells target - margin from target + margin
+    double precision = 0.02; // Also stop once the 95% confidence interval is this narrow
+    double errorRate = 0.05; // Of both SPRT decisions
+    long long maxGames = 20000; // Per configuration. Configurations still open then are undecided
+    int threads = 0; // 0 = one per hardware thread
+    int maxRounds = 500;
+    std::uint64_t seed = 0; // Seed k is gameSeed(seed, k) in every configuration, so they are compared on the same shuffles
+    std::string output; // Results table file, none if empty
+} SweepConfig;
+
+/**
+ * @brief SweepPoint is one configuration of the grid and its outcome.
+ */
+typedef struct SweepPoint {
+    enum Verdict { UNDECIDED, PLAYER_FAVOURED, ENEMY_FAVOURED, BALANCED, INVALID };
+
+    std::vector<int> values; // One per dimension
+    long long games = 0;
+    long long playerWins = 0;
+    long long enemyWins = 0;
+    long long draws = 0; // Including timeouts
+    double logLikelihoodRatio = 0.0; // Of score target + margin against target - margin
+    Verdict verdict = UNDECIDED;
+
+    double score() const;
+    double scoreError() const; // Half-width of the 95% confidence interval
+    static const char* verdictName(Verdict verdict);
+} SweepPoint;
+
+typedef struct SweepResult {
+    std::vector<SweepDimension> dimensions;
+    std::vector<SweepPoint> points;
+    long long games = 0;
+    double seconds = 0.0;
+} SweepResult;
+
+class Sweep {
+public:
+    // Most points a sweep plays. Every point is kept in the results, so larger grids must be sampled (SweepConfig::samples)
+    static constexpr unsigned long long maxPoints = 1ull << 20;
+
+    Sweep(SweepConfig config) : config(config) {}
+
+    // Points of the full grid, saturating at 2^62 instead of overflowing
+    static unsigned long long gridSize(const std::vector<SweepDimension>& dimensions);
+
+    // Plays the sweep with the active card set as the base, and restores it afterwards. Returns no points if a policy is unknown
+    SweepResult run();
+
+    static void printReport(const SweepResult& result, const SweepConfig& config);
+    // The results as a table in the style of the card definitions: one configuration per line, fields separated by |
+    static void writeTable(std::ostream& out, const SweepResult& result);
+
+private:
+    // The grid points to play, as indices into the full grid. At most maxPoints
+    std::vector<unsigned long long> choosePoints() const;
+    // Makes point the active card set. Returns false if a deck ends up empty or too big
+    bool activate(const SweepPoint& point, const CardSet& base);
+
+    SweepConfig config;
+
+    // Storage of the active configuration's card set
+    CardType cards[CARD_COUNT];
+    std::vector<DeckEntry> decks[2]; // 0 = player, 1 = enemy
+};
+
+/**
+ * @brief runSweep is the entry point of --sweep mode.
+ * Usage: --sweep [--space FILE] [--vary "KIND | CARD | VALUES" ...] [--samples N] [--player NAME] [--enemy NAME] [--target P] [--margin P]
+ * [--precision P] [--max-games N] [--threads N] [--max-rounds N] [--seed N] [--out FILE]
+ */
+int runSweep(int argc, char* argv[]);
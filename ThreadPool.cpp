@@ -0,0 +1,68 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int i = 1; i < threads; i++) {
+        this->workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel(const std::function<void(int)>& job) {
+    if (this->workers.empty()) {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->job = &job;
+        this->running = static_cast<int>(this->workers.size());
+        this->generation++;
+    }
+    this->wake.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done.wait(lock, [this]() { return this->running == 0; });
+    this->job = nullptr;
+}
+
+void ThreadPool::work(int index) {
+    std::uint64_t seen = 0;
+    while (true) {
+        const std::function<void(int)>* current;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+            if (this->stopping) {
+                return;
+            }
+            seen = this->generation;
+            current = this->job;
+        }
+
+        (*current)(index);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->running == 0) {
+            this->done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ThreadPool.hpp defines a small pool of persistent worker threads for the AI. Searches run many short parallel jobs per game (one per decision),
+so threads are started once and reused instead of being created for every decision.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief ThreadPool runs one job on all of its threads at once and waits for every copy to finish (fork/join).
+ * The calling thread takes part as worker 0, so a pool of size 1 has no threads of its own and simply runs the job inline.
+ */
+class ThreadPool {
+public:
+    // threads = 0 means one per hardware thread
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(this->workers.size()) + 1; }
+
+    // Calls job(i) once for every worker index i in [0, size()), in parallel, and returns when all calls have returned
+    void parallel(const std::function<void(int)>& job);
+
+private:
+    void work(int index);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake; // Signalled when a new job is posted or the pool stops
+    std::condition_variable done; // Signalled when the last worker finishes the current job
+    const std::function<void(int)>* job = nullptr;
+    std::uint64_t generation = 0; // Incremented for every job, so workers never run the same job twice
+    int running = 0;
+    bool stopping = false;
+};
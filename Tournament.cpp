@@ -0,0 +1,334 @@
+#include "Tournament.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "Arguments.hpp"
+#include "Simulation.hpp"
+
+
+double MatchupResult::scoreError() const {
+    if (this->pairs < 2) {
+        return 0.5;
+    }
+    double mean = this->score();
+    double variance = std::max(0.0, this->pairScoreSquares / this->pairs - mean * mean);
+    return 1.96 * std::sqrt(variance / (this->pairs - 1));
+}
+
+void MatchupResult::merge(const MatchupResult& other) {
+    this->games += other.games;
+    this->winsA += other.winsA;
+    this->winsB += other.winsB;
+    this->draws += other.draws;
+    this->pairs += other.pairs;
+    this->pairScore += other.pairScore;
+    this->pairScoreSquares += other.pairScoreSquares;
+}
+
+int Tournament::playGame(Director& game, Policy& player, Policy& enemy, std::uint64_t seed, int maxRounds) {
+    game.startGame(seed);
+
+    // Same round structure as Simulator::playGame: the attacker deploys, the defender answers, then the assault is resolved
+    bool isRunning = true;
+    for (int rounds = 0; isRunning && rounds < maxRounds; rounds++) {
+        if (game.first) {
+            player.turn(game, true);
+            enemy.turn(game, false);
+        }
+        else {
+            enemy.turn(game, false);
+            player.turn(game, true);
+        }
+        isRunning = game.turnAttack();
+        game.first = !game.first;
+    }
+
+    if (isRunning || (game.getPlayerHealth() <= 0 && game.getEnemyHealth() <= 0)) {
+        return 0;
+    }
+    return game.getPlayerHealth() > 0 ? 1 : -1;
+}
+
+TournamentResult Tournament::run() {
+    TournamentResult result;
+    const int policyCount = static_cast<int>(config.policies.size());
+    for (const std::string& name : config.policies) {
+        if (!makePolicy(name)) {
+            std::cerr << "Unknown policy: " << name << " (scripted, greedy, blocking, tactical, profile:NAME, mcts:MS or alphabeta:MS)\n";
+            return TournamentResult();
+        }
+    }
+    result.names = config.policies;
+    for (int a = 0; a < policyCount; a++) {
+        for (int b = a + 1; b < policyCount; b++) {
+            MatchupResult matchup;
+            matchup.a = a;
+            matchup.b = b;
+            result.matchups.push_back(matchup);
+        }
+    }
+
+    int threadCount = config.threads;
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // A work item is one seed of one pairing. Items go seed by seed, so every pairing progresses at the same pace
+    const long long pairingCount = static_cast<long long>(result.matchups.size());
+    const long long itemCount = pairingCount * config.seedsPerPairing;
+    const long long chunkSize = 16;
+    std::atomic<long long> nextItem = 0;
+    std::mutex resultMutex;
+
+    auto worker = [&]() {
+        // Policies keep state (planners, their tables), so every worker has its own
+        std::vector<std::unique_ptr<Policy>> policies;
+        for (const std::string& name : config.policies) {
+            policies.push_back(makePolicy(name));
+        }
+        std::vector<MatchupResult> local(result.matchups); // Still empty, only a and b are set
+        Director game;
+
+        while (true) {
+            long long start = nextItem.fetch_add(chunkSize);
+            if (start >= itemCount) {
+                break;
+            }
+            long long end = std::min(start + chunkSize, itemCount);
+            for (long long item = start; item < end; item++) {
+                MatchupResult& matchup = local[item % pairingCount];
+                std::uint64_t seed = Simulator::gameSeed(config.seed, item / pairingCount);
+
+                // The same seed from both sides. Outcomes are from a's point of view
+                int asPlayer = playGame(game, *policies[matchup.a], *policies[matchup.b], seed, config.maxRounds);
+                int asEnemy = -playGame(game, *policies[matchup.b], *policies[matchup.a], seed, config.maxRounds);
+                for (int outcome : { asPlayer, asEnemy }) {
+                    matchup.games++;
+                    matchup.winsA += outcome > 0;
+                    matchup.winsB += outcome < 0;
+                    matchup.draws += outcome == 0;
+                }
+                double pairScore = (asPlayer + asEnemy + 2) / 4.0;
+                matchup.pairs++;
+                matchup.pairScore += pairScore;
+                matchup.pairScoreSquares += pairScore * pairScore;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex);
+        for (std::size_t i = 0; i < local.size(); i++) {
+            result.matchups[i].merge(local[i]);
+            result.games += local[i].games;
+        }
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    computeElo(result);
+    return result;
+}
+
+void Tournament::computeElo(TournamentResult& result) {
+    const int n = static_cast<int>(result.names.size());
+    result.elo.assign(n, 0.0);
+    result.eloError.assign(n, 0.0);
+    if (n < 2) {
+        return;
+    }
+
+    // Games and score of i against j. Every pairing gets one extra virtual draw, which keeps ratings finite when a policy never loses
+    std::vector<double> games(n * n, 0.0);
+    std::vector<double> score(n * n, 0.0);
+    for (const MatchupResult& matchup : result.matchups) {
+        double scoreA = matchup.winsA + 0.5 * matchup.draws + 0.5;
+        games[matchup.a * n + matchup.b] = games[matchup.b * n + matchup.a] = matchup.games + 1.0;
+        score[matchup.a * n + matchup.b] = scoreA;
+        score[matchup.b * n + matchup.a] = matchup.games + 1.0 - scoreA;
+    }
+
+    // Newton's method on the log-likelihood, with policy 0 fixed at 0. theta is the rating in natural units (Elo * ln(10) / 400)
+    const int m = n - 1;
+    std::vector<double> theta(n, 0.0);
+    std::vector<double> information(m * m); // Minus the Hessian, without policy 0
+    std::vector<double> inverse(m * m);
+    for (int iteration = 0; iteration < 100; iteration++) {
+        std::vector<double> gradient(m, 0.0);
+        std::fill(information.begin(), information.end(), 0.0);
+        for (int i = 1; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (i == j || games[i * n + j] == 0.0) {
+                    continue;
+                }
+                double p = 1.0 / (1.0 + std::exp(theta[j] - theta[i]));
+                double weight = games[i * n + j] * p * (1.0 - p);
+                gradient[i - 1] += score[i * n + j] - games[i * n + j] * p;
+                information[(i - 1) * m + (i - 1)] += weight;
+                if (j > 0) {
+                    information[(i - 1) * m + (j - 1)] -= weight;
+                }
+            }
+        }
+
+        // Invert the information matrix (Gauss-Jordan with partial pivoting). It is also the covariance of the ratings at the optimum
+        std::vector<double> work(information);
+        std::fill(inverse.begin(), inverse.end(), 0.0);
+        for (int i = 0; i < m; i++) {
+            inverse[i * m + i] = 1.0;
+        }
+        for (int column = 0; column < m; column++) {
+            int pivot = column;
+            for (int row = column + 1; row < m; row++) {
+                if (std::abs(work[row * m + column]) > std::abs(work[pivot * m + column])) {
+                    pivot = row;
+                }
+            }
+            if (work[pivot * m + column] == 0.0) {
+                return; // Policies that never met anyone. Nothing sensible to report
+            }
+            for (int k = 0; k < m; k++) {
+                std::swap(work[column * m + k], work[pivot * m + k]);
+                std::swap(inverse[column * m + k], inverse[pivot * m + k]);
+            }
+            double divisor = work[column * m + column];
+            for (int k = 0; k < m; k++) {
+                work[column * m + k] /= divisor;
+                inverse[column * m + k] /= divisor;
+            }
+            for (int row = 0; row < m; row++) {
+                double factor = work[row * m + column];
+                if (row == column || factor == 0.0) {
+                    continue;
+                }
+                for (int k = 0; k < m; k++) {
+                    work[row * m + k] -= factor * work[column * m + k];
+                    inverse[row * m + k] -= factor * inverse[column * m + k];
+                }
+            }
+        }
+
+        double largestStep = 0.0;
+        for (int i = 0; i < m; i++) {
+            double step = 0.0;
+            for (int k = 0; k < m; k++) {
+                step += inverse[i * m + k] * gradient[k];
+            }
+            theta[i + 1] += step;
+            largestStep = std::max(largestStep, std::abs(step));
+        }
+        if (largestStep < 1e-9) {
+            break;
+        }
+    }
+
+    const double toElo = 400.0 / std::log(10.0);
+    for (int i = 1; i < n; i++) {
+        result.elo[i] = theta[i] * toElo;
+        result.eloError[i] = 1.96 * std::sqrt(inverse[(i - 1) * m + (i - 1)]) * toElo;
+    }
+}
+
+void Tournament::printReport(const TournamentResult& result) {
+    auto elo = [](double score) {
+        score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games played:       " << result.games << "\n";
+    std::cout << "Time:               " << result.seconds << " s\n";
+    std::cout << "Games per second:   " << (result.seconds > 0 ? result.games / result.seconds : 0.0) << "\n";
+
+    std::cout << "\nRatings (Elo, 95% confidence, " << result.names[0] << " = 0):\n";
+    std::vector<int> order(result.names.size());
+    for (int i = 0; i < static_cast<int>(order.size()); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return result.elo[a] > result.elo[b]; });
+    for (int i : order) {
+        std::cout << "  " << std::left << std::setw(16) << result.names[i] << std::right << std::showpos << std::setw(8) << result.elo[i]
+            << std::noshowpos << " +/- " << result.eloError[i] << "\n";
+    }
+
+    std::cout << "\nMatchups (score of the first policy, both sides of every seed):\n";
+    for (const MatchupResult& matchup : result.matchups) {
+        double score = matchup.score();
+        double error = matchup.scoreError();
+        std::cout << "  " << result.names[matchup.a] << " vs " << result.names[matchup.b] << ": "
+            << matchup.winsA << " wins, " << matchup.winsB << " losses, " << matchup.draws << " draws, score "
+            << std::setprecision(3) << score << " +/- " << error << std::setprecision(1)
+            << " (Elo " << std::showpos << elo(score) << std::noshowpos << ", " << elo(score - error) << " to " << elo(score + error) << ")\n";
+    }
+}
+
+int runTournament(int argc, char* argv[]) {
+    TournamentConfig config;
+    bool hasSeed = false;
+    const int maxInt = std::numeric_limits<int>::max();
+    const char* usage = "Usage: --tournament --policy NAME [--policy NAME ...] [--seeds N] [--threads N] [--max-rounds N] [--seed N]\n";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--tournament") {
+            continue;
+        }
+        else if (arg == "--policy" && hasValue) {
+            config.policies.push_back(argv[++i]);
+        }
+        else if (arg == "--seeds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, std::numeric_limits<long long>::max(), config.seedsPerPairing);
+        }
+        else if (arg == "--threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, maxInt, config.threads);
+        }
+        else if (arg == "--max-rounds" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxInt, config.maxRounds);
+        }
+        else if (arg == "--seed" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<std::uint64_t>::max(), config.seed);
+            hasSeed = true;
+        }
+        else {
+            std::cerr << "Unknown tournament argument: " << arg << "\n" << usage;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n" << usage;
+            return 1;
+        }
+    }
+    if (config.policies.size() < 2) {
+        std::cerr << "A tournament needs at least two policies (scripted, greedy, blocking, tactical, profile:NAME, mcts:MS or alphabeta:MS)\n";
+        return 1;
+    }
+    if (!hasSeed) {
+        config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    std::cout << "Run seed: " << config.seed << "\n";
+
+    Tournament tournament(config);
+    TournamentResult result = tournament.run();
+    if (result.names.empty()) {
+        return 1;
+    }
+    Tournament::printReport(result);
+    return 0;
+}
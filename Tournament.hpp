@@ -0,0 +1,79 @@
+/*
+Tournament.hpp defines the self-play tournament runner used to gate AI changes. A set of policies (see Policy.hpp) plays a round-robin on every core;
+every pairing plays each seed twice with the sides swapped, so the strong player deck doesn't decide who wins the pairing.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "Policy.hpp"
+
+typedef struct TournamentConfig {
+    std::vector<std::string> policies; // Policy names, see makePolicy
+    long long seedsPerPairing = 1000; // Each seed is played twice per pairing, once from each side
+    int threads = 0; // Worker threads. 0 = one per hardware thread
+    int maxRounds = 500; // Games still running after this many rounds count as draws
+    std::uint64_t seed = 0; // Run seed. Seed k is gameSeed(seed, k) in every pairing, so all pairings play the same deals
+} TournamentConfig;
+
+/**
+ * @brief MatchupResult is the outcome of one pairing, from policy a's point of view.
+ */
+typedef struct MatchupResult {
+    int a = 0;
+    int b = 0;
+    long long games = 0;
+    long long winsA = 0;
+    long long winsB = 0;
+    long long draws = 0; // Including timeouts
+    // Score of a over each pair of games played with the same seed (0, 0.25, ..., 1). Pairs are the independent samples
+    long long pairs = 0;
+    double pairScore = 0.0;
+    double pairScoreSquares = 0.0;
+
+    double score() const { return this->pairs > 0 ? this->pairScore / this->pairs : 0.5; }
+    // Half-width of the 95% confidence interval of score()
+    double scoreError() const;
+    void merge(const MatchupResult& other);
+} MatchupResult;
+
+typedef struct TournamentResult {
+    std::vector<std::string> names;
+    std::vector<MatchupResult> matchups;
+    std::vector<double> elo; // First policy anchored at 0
+    std::vector<double> eloError; // Half-width of the 95% confidence interval, relative to the anchor
+    long long games = 0;
+    double seconds = 0.0;
+} TournamentResult;
+
+class Tournament {
+public:
+    Tournament(TournamentConfig config) : config(config) {}
+
+    // Returns an empty result (no names) if a policy name is unknown
+    TournamentResult run();
+
+    /**
+     * @brief playGame plays one game from seed to the end (or the round limit) with the given policies.
+     * @return 1 if the player side won, -1 if the enemy side won, 0 for a draw or timeout.
+     */
+    static int playGame(Director& game, Policy& player, Policy& enemy, std::uint64_t seed, int maxRounds);
+
+    static void printReport(const TournamentResult& result);
+
+private:
+    // Bradley-Terry maximum likelihood ratings of all policies, with their standard errors
+    static void computeElo(TournamentResult& result);
+
+    TournamentConfig config;
+};
+
+/**
+ * @brief runTournament is the entry point of --tournament mode.
+ * Usage: --tournament --policy NAME [--policy NAME ...] [--seeds N] [--threads N] [--max-rounds N] [--seed N]
+ */
+int runTournament(int argc, char* argv[]);
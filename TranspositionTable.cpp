@@ -0,0 +1,57 @@
+#include "TranspositionTable.hpp"
+
+#include <bit>
+
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    this->buckets = std::make_unique<Bucket[]>(count);
+    this->mask = count - 1;
+}
+
+bool TranspositionTable::read(const Slot& slot, std::uint64_t key, TTEntry& entry) {
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || data == 0) {
+        return false;
+    }
+    entry = std::bit_cast<TTEntry>(data);
+    return entry.bound != TTEntry::NONE;
+}
+
+void TranspositionTable::write(Slot& slot, std::uint64_t key, const TTEntry& entry) {
+    std::uint64_t data = std::bit_cast<std::uint64_t>(entry);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = this->buckets[key & this->mask];
+    return read(bucket.deepest, key, entry) || read(bucket.latest, key, entry);
+}
+
+void TranspositionTable::store(std::uint64_t key, const TTEntry& entry) {
+    Bucket& bucket = this->buckets[key & this->mask];
+
+    // The deep slot is only replaced by a search at least as deep, or by a newer result for the same position
+    std::uint64_t data = bucket.deepest.data.load(std::memory_order_relaxed);
+    TTEntry current = std::bit_cast<TTEntry>(data);
+    if (data == 0 || entry.depth >= current.depth || read(bucket.deepest, key, current)) {
+        write(bucket.deepest, key, entry);
+    }
+    else {
+        write(bucket.latest, key, entry);
+    }
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= this->mask; i++) {
+        for (Slot* slot : { &this->buckets[i].deepest, &this->buckets[i].latest }) {
+            slot->check.store(0, std::memory_order_relaxed);
+            slot->data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*
+TranspositionTable.hpp defines the shared transposition table of the search code. Positions are keyed by their Zobrist hash (see Zobrist.hpp),
+so a position reached through different orders of play is only searched once, and every search thread sees what the others found.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief TTEntry is what the table stores about one position: its value, how deep it was searched, what kind of bound the value is,
+ * and the best move found there. Packs into 64 bits.
+ */
+typedef struct TTEntry {
+    enum Bound : std::uint8_t {
+        NONE,
+        EXACT,
+        LOWER, // The true value is at least value (the search failed high)
+        UPPER, // The true value is at most value (the search failed low)
+    };
+
+    float value = 0.0f;
+    std::int8_t depth = 0;
+    Bound bound = NONE;
+    std::int8_t handIndex = -1; // Best move, or -1
+    std::int8_t slot = -1;
+} TTEntry;
+
+static_assert(sizeof(TTEntry) == sizeof(std::uint64_t), "A TTEntry must pack into one 64-bit word");
+
+/**
+ * @brief TranspositionTable is a fixed-size hash table shared by any number of threads without locks.
+ * Each slot holds two 64-bit words written independently: the entry, and the key XORed with the entry. A probe only accepts a slot whose words
+ * XOR back to its key, so an entry torn by two threads writing at once reads as a miss instead of as another position's data.
+ * Buckets have two slots: one keeps the deepest search seen, the other always takes the latest store.
+ */
+class TranspositionTable {
+public:
+    // Allocates the largest power-of-two number of buckets that fits in megabytes (at least one)
+    explicit TranspositionTable(std::size_t megabytes);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Looks key up. Returns false if the position isn't in the table
+    bool probe(std::uint64_t key, TTEntry& entry) const;
+    void store(std::uint64_t key, const TTEntry& entry);
+
+    // Empties the table. Must not run while other threads use it
+    void clear();
+
+    std::size_t getBucketCount() const { return this->mask + 1; }
+
+private:
+    typedef struct Slot {
+        std::atomic<std::uint64_t> check{ 0 }; // key ^ data
+        std::atomic<std::uint64_t> data{ 0 };
+    } Slot;
+
+    typedef struct Bucket {
+        Slot deepest;
+        Slot latest;
+    } Bucket;
+
+    static bool read(const Slot& slot, std::uint64_t key, TTEntry& entry);
+    static void write(Slot& slot, std::uint64_t key, const TTEntry& entry);
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t mask = 0;
+};
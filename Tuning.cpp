@@ -0,0 +1,248 @@
+#include "Tuning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "Arguments.hpp"
+#include "CardDatabase.hpp"
+#include "Simulation.hpp"
+
+
+namespace {
+    // Spall's recommended gain sequences: a / (k + 1 + A)^0.602 for the steps, c / (k + 1)^0.101 for the perturbations
+    const double stepDecay = 0.602;
+    const double perturbationDecay = 0.101;
+}
+
+std::vector<TunedParameter> TunedParameter::forCardSet() {
+    std::vector<TunedParameter> parameters;
+    parameters.push_back({ "attack skip", &EnemyProfile::attackSkip, BLANK, 0, 1000 });
+    parameters.push_back({ "defense skip", &EnemyProfile::defenseSkip, BLANK, 0, 1000 });
+
+    std::uint16_t abilities = 0;
+    int maxHealth = 1;
+    for (int id = 0; id < CARD_COUNT; id++) {
+        maxHealth = std::max(maxHealth, getCardType(static_cast<CardID>(id)).maxHealth);
+    }
+    for (int i = 0; i < activeCardSet.enemyDeckSize; i++) {
+        CardID id = activeCardSet.enemyDeck[i].id;
+        bool listed = false;
+        for (const TunedParameter& parameter : parameters) {
+            listed = listed || (!parameter.field && parameter.card == id);
+        }
+        if (!listed) {
+            parameters.push_back({ std::string("prefer ") + CardDatabase::identifier(id), nullptr, id, 0, 100 });
+        }
+        abilities |= getCardType(id).flags;
+    }
+
+    if (abilities & FLAG_KAMIKAZE) {
+        parameters.push_back({ "kamikaze min health", &EnemyProfile::kamikazeMinHealth, BLANK, 0, maxHealth });
+    }
+    if (abilities & FLAG_REINFORCE) {
+        parameters.push_back({ "reinforce max hand", &EnemyProfile::reinforceMaxHand, BLANK, 0, Hand::capacity });
+    }
+    return parameters;
+}
+
+EnemyProfile Tuner::profileAt(const EnemyProfile& base, const std::vector<double>& x) const {
+    EnemyProfile profile = base;
+    for (std::size_t i = 0; i < this->parameters.size(); i++) {
+        const TunedParameter& parameter = this->parameters[i];
+        parameter.in(profile) = parameter.low + static_cast<int>(std::lround(x[i] * (parameter.high - parameter.low)));
+    }
+    return profile;
+}
+
+double Tuner::evaluate(const EnemyProfile& profile, long long games, std::uint64_t seed) const {
+    SimulationConfig simulation;
+    simulation.games = games;
+    simulation.threads = this->config.threads;
+    simulation.seed = seed;
+    simulation.profile = profile;
+    SimulationResult result = Simulator(simulation).run();
+    return result.games > 0 ? (result.enemyWins + 0.5 * (result.draws + result.timeouts)) / result.games : 0.0;
+}
+
+EnemyProfile Tuner::run(const EnemyProfile& start) {
+    this->parameters = TunedParameter::forCardSet();
+    const int n = static_cast<int>(this->parameters.size());
+
+    // Normalized coordinates: every parameter's range maps to [0, 1], so one step size fits all of them
+    std::vector<double> x(n);
+    for (int i = 0; i < n; i++) {
+        const TunedParameter& parameter = this->parameters[i];
+        int value = parameter.in(start);
+        x[i] = std::clamp(static_cast<double>(value - parameter.low) / (parameter.high - parameter.low), 0.0, 1.0);
+    }
+
+    // Squared error in log-odds, so an easy target of 1% is tuned as finely as a hard one of 20%
+    const double floor = 0.5 / std::max(1LL, this->config.games);
+    auto logOdds = [&](double score) {
+        score = std::clamp(score, floor, 1.0 - floor);
+        return std::log(score / (1.0 - score));
+    };
+    auto loss = [&](double score) {
+        double error = logOdds(score) - logOdds(this->config.target);
+        return error * error;
+    };
+
+    Rng rng(Rng::mix(this->config.seed ^ 0x53505341ull));
+    const double stability = 0.1 * this->config.iterations; // Spall's A
+    double gain = 0.0; // Spall's a, calibrated on the first gradient so the first step has the requested size
+    std::vector<double> delta(n);
+    std::vector<double> plus(n);
+    std::vector<double> minus(n);
+    std::vector<double> average(n, 0.0); // Of the iterates of the second half, which is less noisy than the last one
+    int averaged = 0;
+
+    std::cout << std::fixed << std::setprecision(4);
+    for (int k = 0; k < this->config.iterations; k++) {
+        double c = this->config.perturbation / std::pow(k + 1.0, perturbationDecay);
+        for (int i = 0; i < n; i++) {
+            delta[i] = rng.below(2) ? 1.0 : -1.0;
+            plus[i] = std::clamp(x[i] + c * delta[i], 0.0, 1.0);
+            minus[i] = std::clamp(x[i] - c * delta[i], 0.0, 1.0);
+        }
+
+        // Both runs play the same seeds (common random numbers), so their difference is mostly the parameters'
+        std::uint64_t seed = Simulator::gameSeed(this->config.seed, k);
+        double scorePlus = evaluate(profileAt(start, plus), this->config.games, seed);
+        double scoreMinus = evaluate(profileAt(start, minus), this->config.games, seed);
+        double lossPlus = loss(scorePlus);
+        double lossMinus = loss(scoreMinus);
+        double slope = (lossPlus - lossMinus) / (2.0 * c);
+
+        if (gain == 0.0 && slope != 0.0) {
+            gain = this->config.step * std::pow(1.0 + stability, stepDecay) / std::abs(slope);
+        }
+        double a = gain / std::pow(k + 1.0 + stability, stepDecay);
+        for (int i = 0; i < n; i++) {
+            x[i] = std::clamp(x[i] - a * slope / delta[i], 0.0, 1.0);
+        }
+        if (2 * k >= this->config.iterations) {
+            for (int i = 0; i < n; i++) {
+                average[i] += x[i];
+            }
+            averaged++;
+        }
+
+        std::cout << "Iteration " << std::setw(3) << k + 1 << ": enemy score " << scorePlus << " / " << scoreMinus
+            << ", loss " << std::setprecision(6) << 0.5 * (lossPlus + lossMinus) << std::setprecision(4) << "\n";
+    }
+    for (int i = 0; i < n; i++) {
+        average[i] /= std::max(1, averaged);
+    }
+    return profileAt(start, averaged > 0 ? average : x);
+}
+
+int runTuning(int argc, char* argv[]) {
+    TuningConfig config;
+    bool hasSeed = false;
+    bool hasTarget = false;
+    const long long maxLong = std::numeric_limits<long long>::max();
+    const char* usage = "Usage: --tune --target P --out FILE [--name NAME] [--from NAME] [--iterations N] [--games N] [--final-games N] "
+        "[--step F] [--perturbation F] [--threads N] [--seed N]\n";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--tune") {
+            continue;
+        }
+        else if (arg == "--target" && hasValue) {
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.target);
+            hasTarget = true;
+        }
+        else if (arg == "--name" && hasValue) {
+            config.name = argv[++i];
+        }
+        else if (arg == "--out" && hasValue) {
+            config.output = argv[++i];
+        }
+        else if (arg == "--from" && hasValue) {
+            config.from = argv[++i];
+        }
+        else if (arg == "--iterations" && hasValue) {
+            valid = parseNumber(argv[++i], 1, std::numeric_limits<int>::max(), config.iterations);
+        }
+        else if (arg == "--games" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxLong, config.games);
+        }
+        else if (arg == "--final-games" && hasValue) {
+            valid = parseNumber(argv[++i], 1, maxLong, config.finalGames);
+        }
+        else if (arg == "--step" && hasValue) {
+            // Both are fractions of each parameter's range, in (0, 1]
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.step) && config.step > 0.0;
+        }
+        else if (arg == "--perturbation" && hasValue) {
+            valid = parseNumber(argv[++i], 0.0, 1.0, config.perturbation) && config.perturbation > 0.0;
+        }
+        else if (arg == "--threads" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<int>::max(), config.threads);
+        }
+        else if (arg == "--seed" && hasValue) {
+            valid = parseNumber(argv[++i], 0, std::numeric_limits<std::uint64_t>::max(), config.seed);
+            hasSeed = true;
+        }
+        else {
+            std::cerr << "Unknown tuning argument: " << arg << "\n" << usage;
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n" << usage;
+            return 1;
+        }
+    }
+    if (!hasTarget) {
+        std::cerr << "Tuning needs a target enemy score between 0 and 1 (--target)\n";
+        return 1;
+    }
+    if (config.output.empty()) {
+        std::cerr << "Tuning needs a profiles file to save to (--out). To update the shipped profiles, name EnemyProfiles.txt explicitly\n";
+        return 1;
+    }
+    if (!hasSeed) {
+        config.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+    std::cout << "Run seed: " << config.seed << "\n";
+
+    // The profiles already in the output file are written back along with the tuned one
+    std::error_code error;
+    if (std::filesystem::exists(config.output, error) && !ProfileDatabase::load(config.output)) {
+        return 1;
+    }
+    EnemyProfile start = activeProfile;
+    if (!config.from.empty()) {
+        const EnemyProfile* profile = ProfileDatabase::find(config.from);
+        if (!profile) {
+            std::cerr << "Unknown enemy profile: " << config.from << "\n";
+            return 1;
+        }
+        start = *profile;
+    }
+
+    Tuner tuner(config);
+    EnemyProfile tuned = tuner.run(start);
+
+    // Checked on seeds the tuner never saw
+    std::uint64_t checkSeed = Rng::mix(config.seed ^ 0x434845434Bull);
+    double before = tuner.evaluate(start, config.finalGames, checkSeed);
+    double after = tuner.evaluate(tuned, config.finalGames, checkSeed);
+    double error95 = 1.96 * std::sqrt(std::max(0.0, after * (1.0 - after)) / std::max(1LL, config.finalGames));
+    std::cout << "\nEnemy score before: " << before << "\n";
+    std::cout << "Enemy score after:  " << after << " +/- " << error95 << " (target " << config.target << ", " << config.finalGames << " games)\n";
+
+    if (!ProfileDatabase::save(config.output, config.name, tuned)) {
+        return 1;
+    }
+    std::cout << "Saved profile " << config.name << " to " << config.output << "\n";
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+Tuning.hpp defines the tuner of the enemy's difficulty profiles. It treats an EnemyProfile as a parameter vector and runs SPSA
+(simultaneous perturbation stochastic approximation) on it: every iteration plays two simulation runs, with the parameters nudged
+in a random direction and in the opposite one, and steps towards the target enemy win rate (measured in log-odds). The result is saved as a named profile (see Profile.hpp).
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Profile.hpp"
+
+typedef struct TuningConfig {
+    std::string name = "tuned"; // Name the profile is saved under
+    std::string output; // Profiles file it is saved to, along with the profiles loaded from it. Required, so a run never rewrites the shipped profiles by accident
+    std::string from; // Profile to start from. Empty = the active profile
+    double target = 0.1; // Enemy score to reach: wins plus half the draws and timeouts, over all games
+    int iterations = 60;
+    long long games = 4000; // Games of each simulation run. Both runs of an iteration play the same seeds
+    long long finalGames = 100000; // Games of the check of the tuned profile
+    double step = 0.05; // Size of the first step, as a fraction of each parameter's range
+    double perturbation = 0.1; // Size of the nudges, as a fraction of each parameter's range
+    int threads = 0; // 0 = one per hardware thread
+    std::uint64_t seed = 0;
+} TuningConfig;
+
+/**
+ * @brief TunedParameter is one coordinate of the parameter vector: a field of EnemyProfile and the range it is tuned in.
+ */
+typedef struct TunedParameter {
+    std::string name;
+    int EnemyProfile::* field = nullptr; // Null for a card preference
+    CardID card = BLANK; // The preference's card
+    int low = 0;
+    int high = 0;
+
+    int& in(EnemyProfile& profile) const { return this->field ? profile.*field : profile.preference[this->card]; }
+    int in(const EnemyProfile& profile) const { return this->field ? profile.*field : profile.preference[this->card]; }
+
+    /**
+     * @brief forCardSet lists the parameters that matter with the active card set: both skip rates, a preference per card of the enemy deck,
+     * and the hold back thresholds of the abilities the enemy deck has.
+     */
+    static std::vector<TunedParameter> forCardSet();
+} TunedParameter;
+
+class Tuner {
+public:
+    Tuner(TuningConfig config) : config(config) {}
+
+    // Tunes start towards the target. Progress is printed as it goes
+    EnemyProfile run(const EnemyProfile& start);
+
+    // Enemy score of profile over games games of a simulation run
+    double evaluate(const EnemyProfile& profile, long long games, std::uint64_t seed) const;
+
+private:
+    // Profile at normalized coordinates x, each in [0, 1]
+    EnemyProfile profileAt(const EnemyProfile& base, const std::vector<double>& x) const;
+
+    TuningConfig config;
+    std::vector<TunedParameter> parameters;
+};
+
+/**
+ * @brief runTuning is the entry point of --tune mode.
+ * Usage: --tune --target P --out FILE [--name NAME] [--from NAME] [--iterations N] [--games N] [--final-games N] [--step F] [--perturbation F]
+ * [--threads N] [--seed N]
+ */
+int runTuning(int argc, char* argv[]);
@@ -0,0 +1,65 @@
+/*
+Zobrist.hpp defines the 64-bit position hash of a game. GameState keeps it up to date on every play, draw, discard and assault,
+so search code can recognise a position it has seen before in O(1), whatever line of play led to it.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "Random.hpp"
+
+/**
+ * @brief StateHash is the incrementally updated hash of a GameState, in two parts:
+ * board is the XOR of one key per occupied slot (card and current stats) and one key per health value, like a classic Zobrist hash;
+ * piles is the sum of one key per card in a hand or deck. Hands and decks are multisets (20 Recruits are 20 identical keys),
+ * which XOR would cancel out in pairs, so they are added up instead.
+ */
+typedef struct StateHash {
+    std::uint64_t board = 0;
+    std::uint64_t piles = 0;
+
+    // The final 64-bit hash. first (Director::first) is not part of GameState, so it is mixed in here
+    std::uint64_t value(bool first) const;
+
+    bool operator==(const StateHash& other) const = default;
+} StateHash;
+
+namespace Zobrist {
+    // Every key is derived from this seed with splitmix64, so keys need no tables and are the same in every build
+    inline constexpr std::uint64_t seed = 0x524F48414E5A4F42ull;
+
+    constexpr std::uint64_t key(std::uint64_t tag, std::uint64_t value) {
+        return Rng::mix(Rng::mix(seed + tag * 0x9E3779B97F4A7C15ull) ^ value);
+    }
+
+    // Card with its current stats in a board slot. An empty slot has no key
+    constexpr std::uint64_t slotKey(bool isPlayer, int slot, int id, int attack, int defense, int health) {
+        if (id < 0) {
+            return 0;
+        }
+        std::uint64_t stats = static_cast<std::uint64_t>(static_cast<std::uint8_t>(id))
+            | static_cast<std::uint64_t>(static_cast<std::uint16_t>(attack)) << 8
+            | static_cast<std::uint64_t>(static_cast<std::uint16_t>(defense)) << 24
+            | static_cast<std::uint64_t>(static_cast<std::uint16_t>(health)) << 40;
+        return key(1 + (isPlayer ? 8 : 0) + slot, stats);
+    }
+
+    constexpr std::uint64_t healthKey(bool isPlayer, int health) {
+        return key(isPlayer ? 20 : 21, static_cast<std::uint16_t>(health));
+    }
+
+    // One copy of card id in a side's hand or deck
+    constexpr std::uint64_t handKey(bool isPlayer, int id) {
+        return key(isPlayer ? 22 : 23, static_cast<std::uint64_t>(id));
+    }
+    constexpr std::uint64_t deckKey(bool isPlayer, int id) {
+        return key(isPlayer ? 24 : 25, static_cast<std::uint64_t>(id));
+    }
+
+    inline constexpr std::uint64_t firstKey = key(26, 1);
+}
+
+inline std::uint64_t StateHash::value(bool first) const {
+    return board ^ Rng::mix(piles) ^ (first ? Zobrist::firstKey : 0);
+}